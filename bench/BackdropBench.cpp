@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkString.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
+
+// Each loop is a UI frame: a static background, a blurred backdrop behind a panel, and some
+// content in the panel that moves every frame. With kCacheBackdrop_SaveLayerFlag every frame
+// after the first should copy its backdrop rather than blur it again.
+class BackdropBench : public Benchmark {
+public:
+    BackdropBench(bool cache) : fCache(cache) {
+        fName.printf("backdrop_blur_frames%s", cache ? "_cached" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        // The cache only applies to raster canvases.
+        return backend == kRaster_Backend;
+    }
+
+    SkIPoint onGetSize() override { return {512, 512}; }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0, 0}, {512, 512}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorYELLOW, SK_ColorGREEN, SK_ColorBLUE};
+        fBackground.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr,
+                                                           SK_ARRAY_COUNT(colors),
+                                                           SkTileMode::kMirror));
+        fBackdrop = SkImageFilters::Blur(20, 20, nullptr);
+        fContent.setColor(0xC0FFFFFF);
+        fContent.setAntiAlias(true);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect panel = SkRect::MakeXYWH(64, 96, 384, 320);
+        for (int frame = 0; frame < loops; ++frame) {
+            canvas->drawPaint(fBackground);
+
+            canvas->save();
+            canvas->clipRect(panel);
+            canvas->saveLayer(SkCanvas::SaveLayerRec(
+                    &panel, nullptr, fBackdrop.get(),
+                    fCache ? SkCanvas::kCacheBackdrop_SaveLayerFlag : 0));
+            const float x = panel.left() + (frame % 64) * 4;
+            canvas->drawRoundRect(SkRect::MakeXYWH(x, 160, 120, 80), 16, 16, fContent);
+            canvas->restore();
+            canvas->restore();
+        }
+    }
+
+private:
+    const bool           fCache;
+    SkString             fName;
+    SkPaint              fBackground;
+    SkPaint              fContent;
+    sk_sp<SkImageFilter> fBackdrop;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BackdropBench(false); )
+DEF_BENCH( return new BackdropBench(true); )
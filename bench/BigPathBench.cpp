@@ -7,7 +7,12 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkScan.h"
 #include "tools/ToolUtils.h"
 
 enum Align {
@@ -24,13 +29,18 @@ class BigPathBench : public Benchmark {
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    bool        fAccumulate;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, bool accumulate = false)
+        : fAlign(align), fRound(round), fAccumulate(accumulate) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        if (accumulate) {
+            fName.append("_accumulate");
+        }
     }
 
 protected:
@@ -66,9 +76,11 @@ protected:
                 break;
         }
 
+        const bool accumulate = gSkUseCoverageAccumulationAA.exchange(fAccumulate);
         for (int i = 0; i < loops; i++) {
             canvas->drawPath(fPath, paint);
         }
+        gSkUseCoverageAccumulationAA = accumulate;
     }
 
 private:
@@ -82,3 +94,61 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     false, true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, true); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    false, true); )
+
+// One huge filled path, like a detailed country outline, scan converted on 1..N threads.
+class HugePathFillBench : public Benchmark {
+    SkPath                      fPath;
+    SkString                    fName;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    HugePathFillBench(int threads) : fThreads(threads) {
+        fName.printf("hugepath_fill_%d_threads", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(1024, 1024);
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPathBuilder builder;
+        const int kPoints = 1 << 20;
+        for (int i = 0; i < kPoints; i++) {
+            float t = i * (2 * SK_ScalarPI / kPoints),
+                  r = 380 + 60 * sinf(37 * t) + 20 * sinf(301 * t) + 8 * rand.nextSScalar1();
+            builder.lineTo(512 + r * cosf(t), 512 + r * sinf(t));
+        }
+        fPath = builder.close().detach();
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        SkExecutor* executor = SkGraphics::SetParallelPathFillExecutor(fExecutor.get(), fThreads);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+        SkGraphics::SetParallelPathFillExecutor(executor, 1);
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new HugePathFillBench(1); )
+DEF_BENCH( return new HugePathFillBench(2); )
+DEF_BENCH( return new HugePathFillBench(4); )
+DEF_BENCH( return new HugePathFillBench(8); )
@@ -12,6 +12,8 @@
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -101,3 +103,55 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Blur an A8 mask directly, comparing SkOpts::mask_blur_rows to the one-row-at-a-time scan.
+// A short, wide mask is the size of a text shadow; a square one is a large rrect.
+class MaskBlurBench : public Benchmark {
+    SkISize  fSize;
+    SkScalar fSigma;
+    bool     fUseOpts;
+    SkString fName;
+    SkMask   fSrc;
+
+public:
+    MaskBlurBench(SkISize size, SkScalar sigma, bool useOpts)
+        : fSize(size), fSigma(sigma), fUseOpts(useOpts) {
+        fName.printf("mask_blur_%dx%d_%g_%s", size.width(), size.height(), sigma,
+                     useOpts ? "rows" : "scan");
+        fSrc.fImage = nullptr;
+    }
+    ~MaskBlurBench() override { SkMask::FreeImage(fSrc.fImage); }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.fBounds   = SkIRect::MakeSize(fSize);
+        fSrc.fFormat   = SkMask::kA8_Format;
+        fSrc.fRowBytes = fSize.width();
+        fSrc.fImage    = SkMask::AllocImage(fSrc.computeImageSize());
+        SkRandom rand;
+        for (size_t i = 0; i < fSrc.computeImageSize(); i++) {
+            fSrc.fImage[i] = rand.nextBool() ? 0xff : rand.nextU() & 0xff;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkMaskBlurFilter filter(fSigma, fSigma);
+        for (int i = 0; i < loops; i++) {
+            SkMask dst;
+            filter.blurForTesting(fSrc, &dst, fUseOpts);
+            SkMask::FreeImage(dst.fImage);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new MaskBlurBench({256, 32}, 3, false);)
+DEF_BENCH(return new MaskBlurBench({256, 32}, 3, true);)
+DEF_BENCH(return new MaskBlurBench({512, 512}, 20, false);)
+DEF_BENCH(return new MaskBlurBench({512, 512}, 20, true);)
@@ -13,6 +13,7 @@
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/utils/SkRandom.h"
+#include "src/effects/imagefilters/SkImageFiltersPriv.h"
 
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
@@ -22,6 +23,7 @@
 #define BLUR_SIGMA_SMALL    1.0f
 #define BLUR_SIGMA_LARGE    10.0f
 #define BLUR_SIGMA_HUGE     80.0f
+#define BLUR_SIGMA_GIANT    200.0f
 
 
 // When 'cropped' is set we apply a cropRect to the blurImageFilter. The crop rect is an inset of
@@ -161,3 +163,56 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_GIANT, BLUR_SIGMA_GIANT, false, false, false);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_GIANT, 0, false, false, false);)
+
+// Blurs a 256x256 checkerboard on the CPU, either at full resolution or, for large sigmas, at the
+// reduced resolution SkImageFilters::Blur() uses.
+class BlurPixelsBench : public Benchmark {
+public:
+    BlurPixelsBench(SkScalar sigmaX, SkScalar sigmaY, bool downsample)
+        : fSigma{sigmaX, sigmaY}
+        , fDownsample(downsample) {
+        fName.printf("blur_pixels_%.2f_%.2f%s", SkScalarToFloat(sigmaX), SkScalarToFloat(sigmaY),
+                     downsample ? "" : "_fullres");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        make_checkerboard(FILTER_WIDTH_LARGE, FILTER_HEIGHT_LARGE)->asLegacyBitmap(&fSrc);
+        const int borderX = SkScalarCeilToInt(3 * fSigma.fX),
+                  borderY = SkScalarCeilToInt(3 * fSigma.fY);
+        fSrcBounds = SkIRect::MakeXYWH(borderX, borderY, fSrc.width(), fSrc.height());
+        fDstBounds = SkIRect::MakeWH(fSrc.width()  + 2 * borderX,
+                                     fSrc.height() + 2 * borderY);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkBitmap dst;
+            SkImageFiltersPriv::BlurForTesting(fSigma, fSrc, fSrcBounds, fDstBounds, fDownsample,
+                                               &dst);
+        }
+    }
+
+private:
+    SkString fName;
+    SkVector fSigma;
+    bool     fDownsample;
+    SkBitmap fSrc;
+    SkIRect  fSrcBounds, fDstBounds;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true);)
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false);)
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_GIANT, BLUR_SIGMA_GIANT, true);)
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_GIANT, BLUR_SIGMA_GIANT, false);)
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_GIANT, 0, true);)
+DEF_BENCH(return new BlurPixelsBench(BLUR_SIGMA_GIANT, 0, false);)
@@ -7,7 +7,9 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
@@ -228,3 +230,42 @@ DEF_BENCH(return new BlurRectGaussianBench(SkIntToScalar(18));)
 DEF_BENCH(return new BlurRectGaussianBench(SkIntToScalar(19));)
 DEF_BENCH(return new BlurRectGaussianBench(SkIntToScalar(20));)
 #endif
+
+// Draws blurred cards (rects or rrects) of many sizes at many integer positions, as a UI
+// would.  Each size and position needs its own blurred mask unless they share a nine-patch.
+class BlurCardsBench : public Benchmark {
+    bool     fRRect;
+    SkString fName;
+
+public:
+    BlurCardsBench(bool rrect) : fRRect(rrect) {
+        fName.printf("blurrect_cards_many_sizes%s", rrect ? "_rrect" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle,
+                                                   SkBlurMask::ConvertRadiusToSigma(kMedBig)));
+
+        SkRandom rand;
+        for (int i = 0; i < loops; i++) {
+            SkRect r = SkRect::MakeXYWH(rand.nextRangeU(0, 400), rand.nextRangeU(0, 400),
+                                        rand.nextRangeU(100, 600), rand.nextRangeU(60, 400));
+            if (fRRect) {
+                canvas->drawRRect(SkRRect::MakeRectXY(r, 12, 12), paint);
+            } else {
+                canvas->drawRect(r, paint);
+            }
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurCardsBench(false);)
+DEF_BENCH(return new BlurCardsBench(true);)
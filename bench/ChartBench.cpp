@@ -7,11 +7,13 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/private/SkTDArray.h"
 #include "include/utils/SkRandom.h"
 
+
 /**
  * This is a conversion of samplecode/SampleChart.cpp into a bench. It sure would be nice to be able
  * to write one subclass that can be a GM, bench, and/or Sample.
@@ -88,20 +90,26 @@ static void gen_paths(const SkTDArray<SkScalar>& topData,
 // filling
 class ChartBench : public Benchmark {
 public:
-    ChartBench(bool aa) {
+    // A still chart (paths drawn unchanged every frame) can use cached path coverage masks.
+    ChartBench(bool aa, bool still = false, bool cacheMasks = false) {
         fShift = 0;
         fAA = aa;
+        fStill = still;
+        fCacheMasks = cacheMasks;
         fSize.fWidth = -1;
         fSize.fHeight = -1;
+        fName.printf("chart_%s", aa ? "aa" : "bw");
+        if (still) {
+            fName.append("_still");
+        }
+        if (cacheMasks) {
+            fName.append("_cached_masks");
+        }
     }
 
 protected:
     const char* onGetName() override {
-        if (fAA) {
-            return "chart_aa";
-        } else {
-            return "chart_bw";
-        }
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -131,6 +139,7 @@ protected:
             colors[i] = colorRand.nextU() | 0xff000000;
         }
 
+        const bool cacheMasks = SkGraphics::SetPathCoverageMaskCacheEnabled(fCacheMasks);
         for (int frame = 0; frame < loops; ++frame) {
             SkPath plotPath;
             SkPath fillPath;
@@ -148,27 +157,37 @@ protected:
 
             SkTDArray<SkScalar>* prevData = nullptr;
             for (int i = 0; i < kNumGraphs; ++i) {
-                gen_paths(fData[i],
-                          prevData,
-                          height,
-                          0,
-                          SkIntToScalar(kPixelsPerTick),
-                          fShift,
-                          &plotPath,
-                          &fillPath);
+                if (fStill) {
+                    if (sizeChanged && 0 == frame) {
+                        gen_paths(fData[i], prevData, height, 0, SkIntToScalar(kPixelsPerTick),
+                                  0, &fStillPlotPaths[i], &fStillFillPaths[i]);
+                    }
+                } else {
+                    gen_paths(fData[i],
+                              prevData,
+                              height,
+                              0,
+                              SkIntToScalar(kPixelsPerTick),
+                              fShift,
+                              &plotPath,
+                              &fillPath);
+                }
 
                 // Make the fills partially transparent
                 fillPaint.setColor((colors[i] & 0x00ffffff) | 0x80000000);
-                canvas->drawPath(fillPath, fillPaint);
+                canvas->drawPath(fStill ? fStillFillPaths[i] : fillPath, fillPaint);
 
                 plotPaint.setColor(colors[i]);
-                canvas->drawPath(plotPath, plotPaint);
+                canvas->drawPath(fStill ? fStillPlotPaths[i] : plotPath, plotPaint);
 
                 prevData = fData + i;
             }
 
-            fShift += kShiftPerFrame;
+            if (!fStill) {
+                fShift += kShiftPerFrame;
+            }
         }
+        SkGraphics::SetPathCoverageMaskCacheEnabled(cacheMasks);
     }
 
 private:
@@ -180,7 +199,12 @@ private:
     int                 fShift;
     SkISize             fSize;
     SkTDArray<SkScalar> fData[kNumGraphs];
+    SkPath              fStillPlotPaths[kNumGraphs];
+    SkPath              fStillFillPaths[kNumGraphs];
     bool                fAA;
+    bool                fStill;
+    bool                fCacheMasks;
+    SkString            fName;
 
     using INHERITED = Benchmark;
 };
@@ -189,3 +213,5 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+DEF_BENCH( return new ChartBench(true, true); )
+DEF_BENCH( return new ChartBench(true, true, true); )
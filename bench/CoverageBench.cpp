@@ -11,10 +11,14 @@
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkDraw.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
+#include "tools/ToolUtils.h"
 
 class DrawPathBench : public Benchmark {
     SkPaint     fPaint;
@@ -74,3 +78,63 @@ private:
 
 DEF_BENCH( return new DrawPathBench(false) )
 DEF_BENCH( return new DrawPathBench(true) )
+
+// Strokes a path with lots of short anti-aliased runs per scanline, drawn by
+// SkRasterPipelineBlitter either one run at a time, or with runs coalesced into coverage spans.
+class AntiHSpansBench : public Benchmark {
+    SkString    fName;
+    SkPath      fPath;
+    SkPaint     fPaint;
+    SkBitmap    fBitmap;
+    SkRasterClip fRC;
+    bool        fCoalesce;
+public:
+    AntiHSpansBench(bool coalesce, bool opaque) : fCoalesce(coalesce) {
+        fName.printf("antih_spans_%s_%s",
+                     opaque ? "opaque" : "translucent", coalesce ? "coalesced" : "runs");
+        fPaint.setAntiAlias(true);
+        fPaint.setStyle(SkPaint::kStroke_Style);
+        fPaint.setStrokeWidth(2);
+        fPaint.setColor(opaque ? 0xff208040 : 0x80208040);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        // Stroke once up front so we time only scan conversion and blitting.
+        SkPath path = ToolUtils::make_big_path();
+        path.offset(-path.getBounds().left(), -path.getBounds().top());
+        fPaint.getFillPath(path, &fPath);
+        fPaint.setStyle(SkPaint::kFill_Style);
+
+        fBitmap.allocPixels(SkImageInfo::MakeN32Premul(path.getBounds().roundOut().size()));
+        fBitmap.eraseColor(SK_ColorWHITE);
+        fRC.setRect(fBitmap.bounds());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkSTArenaAlloc<2048> alloc;
+        SkSimpleMatrixProvider matrixProvider(SkMatrix::I());
+        SkBlitter* blitter = SkCreateRasterPipelineBlitterForTesting(fBitmap.pixmap(), fPaint,
+                                                                     matrixProvider, &alloc,
+                                                                     fCoalesce);
+        for (int i = 0; i < loops; ++i) {
+            SkScan::AntiFillPath(fPath, fRC, blitter);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new AntiHSpansBench(false, false) )
+DEF_BENCH( return new AntiHSpansBench( true, false) )
+DEF_BENCH( return new AntiHSpansBench(false,  true) )
+DEF_BENCH( return new AntiHSpansBench( true,  true) )
@@ -6,7 +6,9 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkPictureRecorder.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
@@ -54,6 +56,37 @@ private:
     using INHERITED = DecodeBench;
 };
 
+// Decodes images to a color space other than their own, so every row is color transformed.
+class ColorXformDecodeBench final : public DecodeBench {
+public:
+    ColorXformDecodeBench(const char* name, const char* source, sk_sp<SkColorSpace> dst)
+        : INHERITED(name, source)
+        , fDst(std::move(dst))
+    {}
+
+    void onDelayedSetup() override {
+        this->INHERITED::onDelayedSetup();
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+        SkASSERT(codec);
+        SkASSERT(!SkColorSpace::Equals(codec->getInfo().colorSpace(), fDst.get()));
+        fBitmap.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                            .makeAlphaType(kPremul_SkAlphaType)
+                                            .makeColorSpace(fDst));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(SkCodec::kSuccess == codec->getPixels(fBitmap.pixmap()));
+        }
+    }
+
+private:
+    sk_sp<SkColorSpace> fDst;
+    SkBitmap            fBitmap;
+
+    using INHERITED = DecodeBench;
+};
 
 class SkottieDecodeBench final : public DecodeBench {
 public:
@@ -111,3 +144,8 @@ DEF_BENCH(return new SkottiePictureDecodeBench("skottiepic_small",
 DEF_BENCH(return new BitmapDecodeBench("png_large" , "images/mandrill_1600.png"));// 1600x1600
 DEF_BENCH(return new BitmapDecodeBench("png_medium", "images/mandrill_512.png")); //  512x 512
 DEF_BENCH(return new BitmapDecodeBench("png_small" , "images/mandrill_32.png"));  //   32x  32
+
+// 8-bit gray PNGs are transformed through a table of every gray level, built once per decode.
+DEF_BENCH(return new ColorXformDecodeBench("xform_gray_png", "images/grayscale.png",
+                                           SkColorSpace::MakeRGB(SkNamedTransferFn::k2Dot2,
+                                                                 SkNamedGamut::kDisplayP3)));
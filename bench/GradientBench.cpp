@@ -20,6 +20,7 @@ struct GradData {
     const SkColor*  fColors;
     const SkScalar* fPos;
     const char*     fName;
+    uint32_t        fFlags;
 };
 
 static const SkColor gColors[] = {
@@ -41,17 +42,19 @@ static const SkScalar gPos[] = {0.25f, 0.75f};
 // We have several special-cases depending on the number (and spacing) of colors, so
 // try to exercise those here.
 static const GradData gGradData[] = {
-    { 2, gColors, nullptr, "" },
-    { 50, gColors, nullptr, "_hicolor" }, // many color gradient
-    { 3, gColors, nullptr, "_3color" },
-    { 2, gShallowColors, nullptr, "_shallow" },
-    { 2, gColors, gPos, "_pos" },
+    { 2, gColors, nullptr, "", 0 },
+    { 50, gColors, nullptr, "_hicolor", 0 }, // many color gradient
+    { 3, gColors, nullptr, "_3color", 0 },
+    { 2, gShallowColors, nullptr, "_shallow", 0 },
+    { 2, gColors, gPos, "_pos", 0 },
+    { 50, gColors, nullptr, "_hicolor_lut", SkGradientShader::kUseColorLookupTable_Flag },
 };
 
 /// Ignores scale
 static sk_sp<SkShader> MakeLinear(const SkPoint pts[2], const GradData& data,
                                   SkTileMode tm, float scale) {
-    return SkGradientShader::MakeLinear(pts, data.fColors, data.fPos, data.fCount, tm);
+    return SkGradientShader::MakeLinear(pts, data.fColors, data.fPos, data.fCount, tm,
+                                        data.fFlags, nullptr);
 }
 
 static sk_sp<SkShader> MakeRadial(const SkPoint pts[2], const GradData& data,
@@ -60,7 +63,7 @@ static sk_sp<SkShader> MakeRadial(const SkPoint pts[2], const GradData& data,
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
     return SkGradientShader::MakeRadial(center, center.fX * scale, data.fColors,
-                                        data.fPos, data.fCount, tm);
+                                        data.fPos, data.fCount, tm, data.fFlags, nullptr);
 }
 
 /// Ignores scale
@@ -69,7 +72,8 @@ static sk_sp<SkShader> MakeSweep(const SkPoint pts[2], const GradData& data,
     SkPoint center;
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
-    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount);
+    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount,
+                                       data.fFlags, nullptr);
 }
 
 /// Ignores scale
@@ -82,7 +86,8 @@ static sk_sp<SkShader> MakeConical(const SkPoint pts[2], const GradData& data,
                 SkScalarInterp(pts[0].fY, pts[1].fY, SkIntToScalar(1)/4));
     return SkGradientShader::MakeTwoPointConical(center1, (pts[1].fX - pts[0].fX) / 7,
                                                  center0, (pts[1].fX - pts[0].fX) / 2,
-                                                 data.fColors, data.fPos, data.fCount, tm);
+                                                 data.fColors, data.fPos, data.fCount, tm,
+                                                 data.fFlags, nullptr);
 }
 
 /// Ignores scale
@@ -95,7 +100,8 @@ static sk_sp<SkShader> MakeConicalZeroRad(const SkPoint pts[2], const GradData&
                 SkScalarInterp(pts[0].fY, pts[1].fY, SkIntToScalar(1)/4));
     return SkGradientShader::MakeTwoPointConical(center1, 0.0,
                                                  center0, (pts[1].fX - pts[0].fX) / 2,
-                                                 data.fColors, data.fPos, data.fCount, tm);
+                                                 data.fColors, data.fPos, data.fCount, tm,
+                                                 data.fFlags, nullptr);
 }
 
 /// Ignores scale
@@ -109,7 +115,7 @@ static sk_sp<SkShader> MakeConicalOutside(const SkPoint pts[2], const GradData&
     return SkGradientShader::MakeTwoPointConical(center0, radius0,
                                                  center1, radius1,
                                                  data.fColors, data.fPos,
-                                                 data.fCount, tm);
+                                                 data.fCount, tm, data.fFlags, nullptr);
 }
 
 /// Ignores scale
@@ -123,7 +129,7 @@ static sk_sp<SkShader> MakeConicalOutsideZeroRad(const SkPoint pts[2], const Gra
     return SkGradientShader::MakeTwoPointConical(center0, 0.0,
                                                  center1, radius1,
                                                  data.fColors, data.fPos,
-                                                 data.fCount, tm);
+                                                 data.fCount, tm, data.fFlags, nullptr);
 }
 
 typedef sk_sp<SkShader> (*GradMaker)(const SkPoint pts[2], const GradData& data,
@@ -296,6 +302,12 @@ DEF_BENCH( return new GradientBench(kConicalOutZero_GradType); )
 DEF_BENCH( return new GradientBench(kConicalOutZero_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kConicalOutZero_GradType, gGradData[2]); )
 
+// Color lookup table
+DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[5]); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[5]); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[5]); )
+DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[5]); )
+
 // Dithering
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[3], true); )
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[3], false); )
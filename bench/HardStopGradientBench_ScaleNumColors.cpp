@@ -18,12 +18,14 @@
 
 class HardStopGradientBench_ScaleNumColors : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumColors(SkTileMode tilemode, int count) {
-        fName.printf("hardstop_scale_num_colors_%s_%03d_colors",
-                     ToolUtils::tilemode_name(tilemode), count);
+    HardStopGradientBench_ScaleNumColors(SkTileMode tilemode, int count, uint32_t flags = 0) {
+        fName.printf("hardstop_scale_num_colors_%s_%03d_colors%s",
+                     ToolUtils::tilemode_name(tilemode), count,
+                     flags & SkGradientShader::kUseColorLookupTable_Flag ? "_lut" : "");
 
         fTileMode   = tilemode;
         fColorCount = count;
+        fFlags      = flags;
     }
 
     const char* onGetName() override {
@@ -76,7 +78,7 @@ public:
                                                       positions,
                                                       fColorCount,
                                                       fTileMode,
-                                                      0,
+                                                      fFlags,
                                                       nullptr));
     }
 
@@ -95,6 +97,7 @@ private:
     SkTileMode  fTileMode;
     SkString    fName;
     int         fColorCount;
+    uint32_t    fFlags;
     SkPaint     fPaint;
 
     using INHERITED = Benchmark;
@@ -126,3 +129,11 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,  25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror,  50);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kMirror, 100);)
+
+// Color lookup table
+static constexpr uint32_t kLUT = SkGradientShader::kUseColorLookupTable_Flag;
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,   3, kLUT);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  10, kLUT);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  25, kLUT);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp,  50, kLUT);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumColors(SkTileMode::kClamp, 100, kLUT);)
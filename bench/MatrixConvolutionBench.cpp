@@ -14,14 +14,41 @@
 
 #include "tools/ToolUtils.h"
 
+enum class KernelType {
+    kSmall,
+    kBig,
+    kSeparable,  // 9x9 like kBig, but the outer product of two vectors.
+};
+
+static const char* kernel_name(KernelType type) {
+    switch (type) {
+        case KernelType::kSmall:     return "";
+        case KernelType::kBig:       return "bigKernel_";
+        case KernelType::kSeparable: return "separableKernel_";
+    }
+    SkUNREACHABLE;
+}
+
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(KernelType kernelType, SkTileMode tileMode, bool convolveAlpha)
         : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+                               kernel_name(kernelType),
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+        if (kernelType == KernelType::kSeparable) {
+            SkISize kernelSize = SkISize::Make(9, 9);
+            const SkScalar gauss[9] = {1, 8, 28, 56, 70, 56, 28, 8, 1};
+            SkScalar kernel[81];
+            for (int i = 0; i < 81; i++) {
+                kernel[i] = gauss[i / 9] * gauss[i % 9];
+            }
+            SkScalar gain = 1.0f / 65536, bias = 0;
+            SkIPoint kernelOffset = SkIPoint::Make(4, 4);
+            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
+                                                        kernelOffset, tileMode, convolveAlpha,
+                                                        nullptr);
+        } else if (kernelType == KernelType::kBig) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -74,14 +101,18 @@ private:
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, false); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSeparable, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSeparable, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSeparable, SkTileMode::kDecal, false); )
@@ -16,6 +16,8 @@
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+#define LARGE   SkIntToScalar(40)
+#define LARGEST SkIntToScalar(256)  // SkMorphologyImageFilter's limit.
 
 enum MorphologyType {
     kErode_MT,
@@ -90,6 +92,12 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(LARGE, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT); )
+
+DEF_BENCH( return new MorphologyBench(LARGEST, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGEST, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
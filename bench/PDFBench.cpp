@@ -11,9 +11,13 @@
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkImageGenerator.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkYUVAPixmaps.h"
+#include "include/docs/SkPDFDocument.h"
 #include "include/effects/SkGradientShader.h"
+#include "include/encode/SkJpegEncoder.h"
 #include "include/private/SkTo.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkAutoPixmapStorage.h"
@@ -121,16 +125,18 @@ private:
 
 class PDFJpegImageBench : public Benchmark {
 public:
-    PDFJpegImageBench() {}
+    PDFJpegImageBench(const char* name = "PDFJpegImage",
+                      const char* path = "images/mandrill_512_q075.jpg")
+        : fName(name), fPath(path) {}
     ~PDFJpegImageBench() override {}
 
 protected:
-    const char* onGetName() override { return "PDFJpegImage"; }
+    const char* onGetName() override { return fName; }
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
     void onDelayedSetup() override {
-        sk_sp<SkImage> img(GetResourceAsImage("images/mandrill_512_q075.jpg"));
+        sk_sp<SkImage> img(GetResourceAsImage(fPath));
         if (!img) { return; }
         sk_sp<SkData> encoded = img->refEncodedData();
         SkASSERT(encoded);
@@ -151,9 +157,131 @@ protected:
     }
 
 private:
+    const char* fName;
+    const char* fPath;
     sk_sp<SkImage> fImage;
 };
 
+/** Compares the two ways to lossily re-encode a JPEG that can not be embedded as
+    is: decoding to RGB and encoding that, or encoding the decoded YUV planes. */
+class PDFJpegReencodeBench : public Benchmark {
+public:
+    PDFJpegReencodeBench(bool yuv) : fYUV(yuv) {}
+
+protected:
+    const char* onGetName() override {
+        return fYUV ? "PDFJpegReencode_yuv" : "PDFJpegReencode_rgb";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        fEncoded = GetResourceAsData("images/mandrill_512_q075.jpg");
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fEncoded) {
+            return;
+        }
+        SkJpegEncoder::Options options;
+        options.fQuality = 85;
+        while (loops-- > 0) {
+            SkNullWStream nullStream;
+            auto generator = SkImageGenerator::MakeFromEncoded(fEncoded);
+            if (fYUV) {
+                SkYUVAPixmapInfo::SupportedDataTypes supportedDataTypes;
+                supportedDataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+                SkYUVAPixmapInfo yuvaPixmapInfo;
+                if (!generator->queryYUVAInfo(supportedDataTypes, &yuvaPixmapInfo)) {
+                    return;
+                }
+                SkYUVAPixmaps planes = SkYUVAPixmaps::Allocate(yuvaPixmapInfo);
+                if (generator->getYUVAPlanes(planes)) {
+                    (void)SkJpegEncoder::Encode(&nullStream, planes, nullptr, options);
+                }
+            } else {
+                SkBitmap bm;
+                bm.allocPixels(generator->getInfo().makeColorType(kBGRA_8888_SkColorType));
+                if (generator->getPixels(bm.pixmap())) {
+                    (void)SkJpegEncoder::Encode(&nullStream, bm.pixmap(), options);
+                }
+            }
+        }
+    }
+
+private:
+    bool fYUV;
+    sk_sp<SkData> fEncoded;
+};
+
+// Draws many distinct SkImages decoded from the same source, as a batch job
+// stamping a logo on every page of every document would.  With fUseCache, the
+// encoded XObject is also shared across documents via an SkPDF::ImageCache.
+class PDFImageDedupBench : public Benchmark {
+public:
+    PDFImageDedupBench(bool useCache) : fUseCache(useCache) {}
+
+protected:
+    struct MemoryImageCache : public SkPDF::ImageCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            for (const auto& entry : fEntries) {
+                if (entry.first->equals(&key)) {
+                    return entry.second;
+                }
+            }
+            return nullptr;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            fEntries.emplace_back(SkData::MakeWithCopy(key.data(), key.size()),
+                                  SkData::MakeWithCopy(data.data(), data.size()));
+        }
+        std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    };
+
+    const char* onGetName() override {
+        return fUseCache ? "PDFImageDedup_cache" : "PDFImageDedup";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        sk_sp<SkImage> img(GetResourceAsImage("images/color_wheel.png"));
+        if (!img) {
+            return;
+        }
+        SkAutoPixmapStorage pixmap;
+        pixmap.alloc(SkImageInfo::MakeN32Premul(img->dimensions()));
+        if (!img->readPixels(nullptr, pixmap, 0, 0)) {
+            return;
+        }
+        for (sk_sp<SkImage>& copy : fImages) {
+            copy = SkImage::MakeRasterCopy(pixmap);
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fImages[0]) {
+            return;
+        }
+        MemoryImageCache cache;
+        SkPDF::Metadata metadata;
+        if (fUseCache) {
+            metadata.fImageCache = &cache;
+        }
+        while (loops-- > 0) {
+            SkNullWStream nullStream;
+            auto doc = SkPDF::MakeDocument(&nullStream, metadata);
+            for (const sk_sp<SkImage>& image : fImages) {
+                doc->beginPage(256, 256)->drawImage(image, 0, 0);
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+
+private:
+    bool fUseCache;
+    sk_sp<SkImage> fImages[8];
+};
+
 /** Test calling DEFLATE on a 78k PDF command stream. Used for measuring
     alternate zlib settings, usage, and library versions. */
 class PDFCompressionBench : public Benchmark {
@@ -305,6 +433,12 @@ struct PDFClipPathBenchmark : public Benchmark {
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
+DEF_BENCH(return new PDFJpegImageBench("PDFJpegImage_cmyk", "images/CMYK.jpg");)
+DEF_BENCH(return new PDFJpegImageBench("PDFJpegImage_exif", "images/exif-orientation-2-ur.jpg");)
+DEF_BENCH(return new PDFJpegReencodeBench(false);)
+DEF_BENCH(return new PDFJpegReencodeBench(true);)
+DEF_BENCH(return new PDFImageDedupBench(false);)
+DEF_BENCH(return new PDFImageDedupBench(true);)
 DEF_BENCH(return new PDFCompressionBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
@@ -11,6 +11,7 @@
 #include "include/core/SkPath.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkScalerCache.h"
+#include "src/core/SkScan.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
 #include "tools/ToolUtils.h"
@@ -30,7 +31,8 @@ static_assert(52 == kNumGlyphs, "expected 52 glyphs");
  */
 class PathTextBench : public Benchmark {
 public:
-    PathTextBench(bool clipped, bool uncached) : fClipped(clipped), fUncached(uncached) {}
+    PathTextBench(bool clipped, bool uncached, bool accumulate = false)
+        : fClipped(clipped), fUncached(uncached), fAccumulate(accumulate) {}
 
 private:
     const char* onGetName() override {
@@ -41,6 +43,9 @@ private:
         if (fUncached) {
             fName.append("_uncached");
         }
+        if (fAccumulate) {
+            fName.append("_accumulate");
+        }
         return fName.c_str();
     }
     SkIPoint onGetSize() override { return SkIPoint::Make(kScreenWidth, kScreenHeight); }
@@ -88,15 +93,18 @@ private:
         if (fClipped) {
             canvas->clipPath(fClipPath, SkClipOp::kIntersect, true);
         }
+        const bool accumulate = gSkUseCoverageAccumulationAA.exchange(fAccumulate);
         for (int i = 0; i < kNumDraws; ++i) {
             const SkPath& glyph = fGlyphs[i % kNumGlyphs];
             canvas->setMatrix(fXforms[i]);
             canvas->drawPath(glyph, fPaints[i]);
         }
+        gSkUseCoverageAccumulationAA = accumulate;
     }
 
     const bool fClipped;
     const bool fUncached;
+    const bool fAccumulate;
     SkString fName;
     SkPath fGlyphs[kNumGlyphs];
     SkPaint fPaints[kNumDraws];
@@ -109,3 +117,5 @@ private:
 DEF_BENCH(return new PathTextBench(false, false);)
 DEF_BENCH(return new PathTextBench(false, true);)
 DEF_BENCH(return new PathTextBench(true, true);)
+DEF_BENCH(return new PathTextBench(false, true, true);)
+DEF_BENCH(return new PathTextBench(true, true, true);)
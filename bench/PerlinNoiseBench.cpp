@@ -6,24 +6,45 @@
  */
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 
 class PerlinNoiseBench : public Benchmark {
-    SkISize fSize;
+    SkISize  fSize;
+    bool     fTurbulence;
+    bool     fStitchTiles;
+    bool     fCacheTiles;
+    SkString fName;
 
 public:
-    PerlinNoiseBench()  {
+    PerlinNoiseBench(bool turbulence = false, bool stitchTiles = false, bool cacheTiles = false)
+            : fTurbulence(turbulence)
+            , fStitchTiles(stitchTiles)
+            , fCacheTiles(cacheTiles) {
         fSize = SkISize::Make(80, 80);
+        fName.set("perlinnoise");
+        if (fTurbulence) {
+            fName.append("_turbulence");
+        }
+        if (fStitchTiles) {
+            fName.append("_stitch");
+        }
+        if (fCacheTiles) {
+            fName.append("_cached");
+        }
     }
 
 protected:
     const char* onGetName() override {
-        return "perlinnoise";
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, false);
+        const bool cacheTiles = SkGraphics::SetPerlinNoiseTileCacheEnabled(fCacheTiles);
+        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, fStitchTiles);
+        SkGraphics::SetPerlinNoiseTileCacheEnabled(cacheTiles);
     }
 
 private:
@@ -42,9 +63,12 @@ private:
               float baseFrequencyX, float baseFrequencyY, int numOctaves, float seed,
               bool stitchTiles) {
         SkPaint paint;
-        paint.setShader(SkPerlinNoiseShader::MakeFractalNoise(baseFrequencyX, baseFrequencyY,
-                                                              numOctaves, seed,
-                                                              stitchTiles ? &fSize : nullptr));
+        const SkISize* tileSize = stitchTiles ? &fSize : nullptr;
+        paint.setShader(fTurbulence
+                ? SkPerlinNoiseShader::MakeTurbulence(baseFrequencyX, baseFrequencyY,
+                                                      numOctaves, seed, tileSize)
+                : SkPerlinNoiseShader::MakeFractalNoise(baseFrequencyX, baseFrequencyY,
+                                                        numOctaves, seed, tileSize));
         for (int i = 0; i < loops; i++) {
             this->drawClippedRect(canvas, x, y, paint);
         }
@@ -56,3 +80,9 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PerlinNoiseBench(); )
+DEF_BENCH( return new PerlinNoiseBench(true); )
+DEF_BENCH( return new PerlinNoiseBench(false, true); )
+DEF_BENCH( return new PerlinNoiseBench(true, true); )
+// Stitched tiles drawn again with the same matrix are shaded once and then copied.
+DEF_BENCH( return new PerlinNoiseBench(false, true, true); )
+DEF_BENCH( return new PerlinNoiseBench(true, true, true); )
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/utils/SkRandom.h"
+
+// Loads a picture with many distinct paths and paints, either copying it into an SkRecord with
+// SkPicture::MakeFromData(), or playing it back in place with MakeFromDataWithoutCopy().
+// The last kHeld pictures loaded stay alive as long as the bench does, so nanobench's RSS
+// column shows how much memory each way holds on to.
+class PictureLoadBench : public Benchmark {
+public:
+    PictureLoadBench(bool inPlace) : fInPlace(inPlace) {
+        fName.printf("picture_load_%s", inPlace ? "in_place" : "copy");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(1024, 1024));
+        for (int i = 0; i < 4000; i++) {
+            SkPath path;
+            path.moveTo(rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024));
+            for (int j = 0; j < 8; j++) {
+                path.quadTo(rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024),
+                            rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024));
+            }
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(rand.nextU() | 0xff000000);
+            canvas->drawPath(path, paint);
+        }
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = fInPlace ? SkPicture::MakeFromDataWithoutCopy(fData)
+                                                : SkPicture::MakeFromData(fData.get());
+            fHeld[fNext++ % kHeld] = std::move(picture);
+        }
+    }
+
+private:
+    static constexpr int kHeld = 32;
+
+    bool             fInPlace;
+    SkString         fName;
+    sk_sp<SkData>    fData;
+    sk_sp<SkPicture> fHeld[kHeld];
+    int              fNext = 0;
+};
+
+DEF_BENCH( return new PictureLoadBench(false); )
+DEF_BENCH( return new PictureLoadBench(true); )
+
+// Loads a large picture of small paths, each with its own paint, and draws one 256x256 tile of it,
+// as a tiled viewer would when it first shows part of a big page.  Indexed pictures are recorded
+// with a BBH and serialized with an op index, so they can skip reading the ops outside the tile.
+class PicturePartialDrawBench : public Benchmark {
+public:
+    PicturePartialDrawBench(bool inPlace, bool indexed) : fInPlace(inPlace), fIndexed(indexed) {
+        fName.printf("picture_partial_draw_%s%s",
+                     inPlace ? "in_place" : "copy", indexed ? "_indexed" : "");
+    }
+
+protected:
+    static constexpr int kSize = 4096,
+                         kCell = 32,
+                         kTile = 256;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kSize, kSize),
+                                                   fIndexed ? &factory : nullptr);
+        for (int y = 0; y < kSize; y += kCell)
+        for (int x = 0; x < kSize; x += kCell) {
+            SkPath path;
+            path.moveTo(x + rand.nextRangeF(0, kCell), y + rand.nextRangeF(0, kCell));
+            for (int j = 0; j < 3; j++) {
+                path.quadTo(x + rand.nextRangeF(0, kCell), y + rand.nextRangeF(0, kCell),
+                            x + rand.nextRangeF(0, kCell), y + rand.nextRangeF(0, kCell));
+            }
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(rand.nextU() | 0xff000000);
+            canvas->drawPath(path, paint);
+        }
+        SkSerialProcs procs;
+        procs.fWritePictureOpIndex = fIndexed;
+        fData = recorder.finishRecordingAsPicture()->serialize(&procs);
+        fSurface = SkSurface::MakeRasterN32Premul(kTile, kTile);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = fInPlace ? SkPicture::MakeFromDataWithoutCopy(fData)
+                                                : SkPicture::MakeFromData(fData.get());
+            // Walk the tile down the diagonal, so no two draws in a row show the same ops.
+            const int offset = (i * kTile) % kSize;
+            canvas->save();
+            canvas->translate(-offset, -offset);
+            canvas->drawPicture(picture);
+            canvas->restore();
+        }
+    }
+
+private:
+    bool             fInPlace,
+                     fIndexed;
+    SkString         fName;
+    sk_sp<SkData>    fData;
+    sk_sp<SkSurface> fSurface;
+};
+
+DEF_BENCH( return new PicturePartialDrawBench(false, false); )
+DEF_BENCH( return new PicturePartialDrawBench(false, true); )
+DEF_BENCH( return new PicturePartialDrawBench(true, false); )
+DEF_BENCH( return new PicturePartialDrawBench(true, true); )
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/private/SkHalf.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkCpu.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkRasterPipeline.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#if defined(SK_CPU_X86)
+
+namespace SkOpts {
+    // Defined in src/opts/SkOpts_hsw.cpp.
+    void Init_hsw();
+}  // namespace SkOpts
+
+// Every process-wide SkOpts pointer SkOpts::Init_hsw() overwrites.
+#define HSW_OPTS(M)                                                                           \
+    M(blit_row_color32) M(blit_row_s32a_opaque) M(S32_alpha_D32_filter_DX) M(cubic_solver)     \
+    M(mask_blur_rows)                                                                         \
+    M(RGBA_to_BGRA) M(RGBA_to_rgbA) M(RGBA_to_bgrA) M(gray_to_RGB1) M(grayA_to_RGBA)          \
+    M(grayA_to_rgbA) M(inverted_CMYK_to_RGB1) M(inverted_CMYK_to_BGR1)                        \
+    M(stages_highp) M(just_return_highp) M(start_pipeline_highp)                              \
+    M(stages_lowp)  M(just_return_lowp)  M(start_pipeline_lowp)                               \
+    M(fused_highp)  M(fused_lowp)        M(interpret_skvm)
+
+// Borrows the HSW SkOpts for as long as this is in scope, then puts back whatever was there.
+class AutoHSWOpts {
+public:
+    AutoHSWOpts() {
+    #define M(name) memcpy(&fSaved.name, &SkOpts::name, sizeof(SkOpts::name));
+        HSW_OPTS(M)
+    #undef M
+        SkOpts::Init_hsw();
+    }
+    ~AutoHSWOpts() {
+    #define M(name) memcpy(&SkOpts::name, &fSaved.name, sizeof(SkOpts::name));
+        HSW_OPTS(M)
+    #undef M
+    }
+
+private:
+    struct {
+    #define M(name) decltype(SkOpts::name) name;
+        HSW_OPTS(M)
+    #undef M
+    } fSaved;
+};
+
+// Runs a few SkRasterPipelines typical of gradients, image shaders and blend modes, with the
+// stages built for AVX2 (HSW) or for AVX-512 (SKX), to compare the two on the same machine.
+class RasterPipelineBench : public Benchmark {
+public:
+    enum class Kind { kGradient, kGradient12Stops, kImage, kBlend };
+
+    RasterPipelineBench(Kind kind, bool highp, bool skx)
+        : fKind(kind), fHighp(highp), fSKX(skx) {
+        const char* kNames[] = { "gradient", "gradient12", "image", "blend" };
+        fName.printf("SkRasterPipeline_%s_%s_%s",
+                     kNames[(int)kind], highp ? "highp" : "lowp", skx ? "skx" : "hsw");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend
+            && SkCpu::Supports(fSKX ? SkCpu::SKX : SkCpu::HSW);
+    }
+
+    void onDelayedSetup() override {
+        fSrc8888.resize(kWidth*kHeight);
+        fDst8888.resize(kWidth*kHeight);
+        fSrcF16 .resize(kWidth*kHeight);
+        fDstF16 .resize(kWidth*kHeight);
+        for (int i = 0; i < kWidth*kHeight; i++) {
+            fSrc8888[i] = fDst8888[i] = 0x80402010 + i;
+            fSrcF16 [i] = fDstF16 [i] = (uint64_t)SK_Half1 << 48
+                                      | (uint64_t)SkFloatToHalf((i % 255) / 255.0f);
+        }
+        fSrc8888Ctx = { fSrc8888.data(), kWidth };
+        fDst8888Ctx = { fDst8888.data(), kWidth };
+        fSrcF16Ctx  = { fSrcF16 .data(), kWidth };
+        fDstF16Ctx  = { fDstF16 .data(), kWidth };
+
+        SkRasterPipeline p(&fAlloc);
+        switch (fKind) {
+            case Kind::kGradient:
+            case Kind::kGradient12Stops: {
+                const int stops = fKind == Kind::kGradient ? 4 : 12;
+                fGradient.stopCount = stops;
+                for (int c = 0; c < 4; c++) {
+                    fGradient.fs[c] = fAlloc.makeArray<float>(std::max(stops, 8));
+                    fGradient.bs[c] = fAlloc.makeArray<float>(std::max(stops, 8));
+                    for (int s = 0; s < stops; s++) {
+                        fGradient.fs[c][s] = (c+1) / 8.0f;
+                        fGradient.bs[c][s] = s / (float)stops;
+                    }
+                }
+                fGradient.ts = nullptr;  // Evenly spaced, so we don't need any stop positions.
+                fGradient.interpolatedInPremul = false;
+
+                fMatrix[0] = 1.0f / kWidth;  // x in [0,kWidth) -> t in [0,1)
+                fMatrix[1] = 1.0f;
+                fMatrix[2] = fMatrix[3] = 0;
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, fMatrix);
+                p.append(SkRasterPipeline::clamp_x_1);
+                p.append(SkRasterPipeline::evenly_spaced_gradient, &fGradient);
+            } break;
+
+            case Kind::kImage: {
+                // A slight rotation and scale, so we sample all over the image.
+                const float m[] = { 0.9f, 0.1f, -0.1f, 0.9f, 3.5f, 1.5f };
+                memcpy(fMatrix, m, sizeof(m));
+                fGather = { fSrc8888.data(), kWidth, (float)kWidth, (float)kHeight };
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_2x3, fMatrix);
+                // gather_8888 runs in lowp and highp, bilerp_clamp_8888 only in highp.
+                p.append(fHighp ? SkRasterPipeline::bilerp_clamp_8888
+                                : SkRasterPipeline::gather_8888, &fGather);
+            } break;
+
+            case Kind::kBlend: {
+                p.append(fHighp ? SkRasterPipeline::load_f16 : SkRasterPipeline::load_8888,
+                         fHighp ? &fSrcF16Ctx : &fSrc8888Ctx);
+                p.append(fHighp ? SkRasterPipeline::load_f16_dst
+                                : SkRasterPipeline::load_8888_dst,
+                         fHighp ? &fDstF16Ctx : &fDst8888Ctx);
+                p.append(SkRasterPipeline::multiply);
+            } break;
+        }
+        // store_f16 only runs in highp.
+        p.append(fHighp ? SkRasterPipeline::store_f16 : SkRasterPipeline::store_8888,
+                 fHighp ? &fDstF16Ctx : &fDst8888Ctx);
+
+        // compile() bakes in the stage functions SkOpts points at right now, so we can switch
+        // over to the HSW stages just long enough to build that variant.
+        if (!fSKX && SkCpu::Supports(SkCpu::SKX)) {
+            AutoHSWOpts hsw;
+            fPipeline = p.compile();
+        } else {
+            fPipeline = p.compile();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; loop++) {
+            fPipeline(0,0, kWidth,kHeight);
+        }
+    }
+
+private:
+    // An odd width exercises the tail too.
+    static constexpr int kWidth  = 509,
+                         kHeight = 64;
+
+    const Kind fKind;
+    const bool fHighp,
+               fSKX;
+    SkString   fName;
+
+    SkSTArenaAlloc<1024> fAlloc;
+    std::vector<uint32_t> fSrc8888, fDst8888;
+    std::vector<uint64_t> fSrcF16,  fDstF16;
+    SkRasterPipeline_MemoryCtx fSrc8888Ctx, fDst8888Ctx,
+                               fSrcF16Ctx,  fDstF16Ctx;
+    SkRasterPipeline_GatherCtx   fGather;
+    SkRasterPipeline_GradientCtx fGradient;
+    float                        fMatrix[6];
+
+    std::function<void(size_t, size_t, size_t, size_t)> fPipeline;
+};
+
+using Kind = RasterPipelineBench::Kind;
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient, false, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient, false,  true); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient,  true, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient,  true,  true); )
+
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient12Stops, false, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient12Stops, false,  true); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient12Stops,  true, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kGradient12Stops,  true,  true); )
+
+DEF_BENCH( return new RasterPipelineBench(Kind::kImage, false, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kImage, false,  true); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kImage,  true, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kImage,  true,  true); )
+
+DEF_BENCH( return new RasterPipelineBench(Kind::kBlend, false, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kBlend, false,  true); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kBlend,  true, false); )
+DEF_BENCH( return new RasterPipelineBench(Kind::kBlend,  true,  true); )
+
+#endif//defined(SK_CPU_X86)
+
+// Runs a few of the stage sequences SkRasterPipeline has fused pipelines for, with or without them.
+class FusedPipelineBench : public Benchmark {
+public:
+    enum class Kind { kSrcoverColor, kSrcoverColorAA, kLinearGradient, kBilerpImage };
+
+    FusedPipelineBench(Kind kind, bool fused) : fKind(kind), fFused(fused) {
+        const char* kNames[] = { "srcover_color", "srcover_color_aa", "linear_gradient",
+                                 "bilerp_image" };
+        fName.printf("SkRasterPipeline_fused_%s_%s",
+                     kNames[(int)kind], fused ? "fused" : "stages");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const SkImageInfo info = SkImageInfo::Make(kWidth, kHeight,
+                                                   kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+        fDst     .resize(kWidth*kHeight);
+        fCoverage.resize(kWidth*kHeight);
+        fImage   .resize(kWidth*kHeight);
+        for (int i = 0; i < kWidth*kHeight; i++) {
+            fDst[i]      = 0xff336699;
+            fCoverage[i] = (uint8_t)(i * 37);
+            fImage[i]    = 0xff000000 | (i * 2654435761u & 0x00ffffff);
+        }
+        fDstCtx      = { fDst.data(),      kWidth };
+        fCoverageCtx = { fCoverage.data(), kWidth };
+
+        SkRasterPipeline p(&fAlloc);
+        switch (fKind) {
+            case Kind::kSrcoverColor:
+            case Kind::kSrcoverColorAA:
+                p.append_constant_color(&fAlloc, SkColor4f{0.125f, 0.25f, 0.0625f, 0.5f});
+                p.append_gamut_clamp_if_normalized(info);
+                if (fKind == Kind::kSrcoverColor) {
+                    p.append(SkRasterPipeline::srcover_rgba_8888, &fDstCtx);
+                    break;
+                }
+                p.append(SkRasterPipeline::scale_u8, &fCoverageCtx);
+                p.append_load_dst(kRGBA_8888_SkColorType, &fDstCtx);
+                p.append(SkRasterPipeline::srcover);
+                break;
+
+            case Kind::kLinearGradient:
+                fGradient = { {1, 0, -1, 0}, {0, 0, 1, 1}, false };  // blue to red
+                fMatrix[0] = 1.0f / kWidth;  // x in [0,kWidth) -> t in [0,1)
+                fMatrix[1] = 1.0f;
+                fMatrix[2] = fMatrix[3] = 0;
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, fMatrix);
+                p.append(SkRasterPipeline::clamp_x_1);
+                p.append(SkRasterPipeline::evenly_spaced_2_stop_gradient, &fGradient);
+                p.append_gamut_clamp_if_normalized(info);
+                break;
+
+            case Kind::kBilerpImage:
+                // Upscale the top-left third of the image to cover the destination.
+                fGather = { fImage.data(), kWidth, (float)kWidth, (float)kHeight };
+                fMatrix[0] = fMatrix[1] = 1/3.0f;
+                fMatrix[2] = fMatrix[3] = 0;
+                p.append(SkRasterPipeline::seed_shader);
+                p.append(SkRasterPipeline::matrix_scale_translate, fMatrix);
+                p.append(SkRasterPipeline::bilerp_clamp_8888, &fGather);
+                p.append_gamut_clamp_if_normalized(info);
+                break;
+        }
+        if (fKind != Kind::kSrcoverColor) {
+            p.append_store(kRGBA_8888_SkColorType, &fDstCtx);
+        }
+        p.setAllowFusedForTesting(fFused);
+        fPipeline = p.compile();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; loop++) {
+            fPipeline(0,0, kWidth,kHeight);
+        }
+    }
+
+private:
+    static constexpr int kWidth  = 509,
+                         kHeight = 256;
+
+    const Kind fKind;
+    const bool fFused;
+    SkString   fName;
+
+    SkSTArenaAlloc<256> fAlloc;
+    std::vector<uint32_t> fDst, fImage;
+    std::vector<uint8_t>  fCoverage;
+    SkRasterPipeline_MemoryCtx fDstCtx, fCoverageCtx;
+    SkRasterPipeline_GatherCtx fGather;
+    SkRasterPipeline_EvenlySpaced2StopGradientCtx fGradient;
+    float                      fMatrix[4];
+
+    std::function<void(size_t, size_t, size_t, size_t)> fPipeline;
+};
+
+using FusedKind = FusedPipelineBench::Kind;
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kSrcoverColor,   false); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kSrcoverColor,    true); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kSrcoverColorAA, false); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kSrcoverColorAA,  true); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kLinearGradient, false); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kLinearGradient,  true); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kBilerpImage,    false); )
+DEF_BENCH( return new FusedPipelineBench(FusedKind::kBilerpImage,     true); )
@@ -49,9 +49,12 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
-DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data)
+DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data,
+                                                 bool inPlace, SkExecutor* executor)
     : fName(name)
     , fEncodedPicture(std::move(data))
+    , fInPlace(inPlace)
+    , fExecutor(executor)
 {}
 
 const char* DeserializePictureBench::onGetName() {
@@ -68,6 +71,10 @@ SkIPoint DeserializePictureBench::onGetSize() {
 
 void DeserializePictureBench::onDraw(int loops, SkCanvas*) {
     for (int i = 0; i < loops; ++i) {
-        SkPicture::MakeFromData(fEncodedPicture.get());
+        if (fInPlace) {
+            SkPicture::MakeFromDataWithoutCopy(fEncodedPicture);
+        } else {
+            SkPicture::MakeFromData(fEncodedPicture.get(), nullptr, fExecutor);
+        }
     }
 }
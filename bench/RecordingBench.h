@@ -42,7 +42,10 @@ private:
 
 class DeserializePictureBench : public Benchmark {
 public:
-    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
+    // With inPlace, loads with SkPicture::MakeFromDataWithoutCopy() rather than MakeFromData().
+    // Otherwise, if executor is not null, MakeFromData() decodes in parallel on it.
+    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture, bool inPlace = false,
+                            SkExecutor* executor = nullptr);
 
 protected:
     const char* onGetName() override;
@@ -53,6 +56,8 @@ protected:
 private:
     SkString      fName;
     sk_sp<SkData> fEncodedPicture;
+    bool          fInPlace;
+    SkExecutor*   fExecutor;
 
     using INHERITED = Benchmark;
 };
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <utility>
+#include <vector>
+
+extern bool gUseSkVMBlitter;
+extern bool gSkVMJITAllowAVX512;
+
+// Draws the same mix of paints on several threads at once, each into its own raster surface,
+// starting from an empty SkVM program cache every loop.  With a shared cache each distinct
+// program should only be compiled once, no matter how many threads use it.
+class VMProgramCacheBench : public Benchmark {
+public:
+    VMProgramCacheBench(int threads, int paints) : fThreads(threads), fPaintCount(paints) {
+        fName.printf("VMProgramCache_threads%d_paints%d", threads, paints);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0, 0}, {32, 32}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+        const sk_sp<SkShader> shaders[] = {
+            nullptr,
+            SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp),
+            SkGradientShader::MakeLinear(pts, colors, nullptr, 3, SkTileMode::kMirror),
+            SkGradientShader::MakeRadial({16, 16}, 16, colors, nullptr, 3, SkTileMode::kRepeat),
+        };
+        constexpr int kModeCount = (int)SkBlendMode::kLastMode + 1;
+
+        fPaints.resize(fPaintCount);
+        for (int i = 0; i < fPaintCount; i++) {
+            fPaints[i].setAntiAlias(true);
+            fPaints[i].setColor(0x80336699 + i);
+            fPaints[i].setBlendMode((SkBlendMode)(i % kModeCount));
+            fPaints[i].setShader(shaders[(i / kModeCount) % SK_ARRAY_COUNT(shaders)]);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const bool prevUseSkVMBlitter = gUseSkVMBlitter;
+        gUseSkVMBlitter = true;
+
+        for (int loop = 0; loop < loops; loop++) {
+            SkGraphics::PurgeVMProgramCache();
+            SkTaskGroup().batch(fThreads, [&](int) {
+                auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+                SkCanvas* canvas = surface->getCanvas();
+                // Repeat the mix so every program is reused a few times per thread.
+                for (int repeat = 0; repeat < 4; repeat++) {
+                    for (const SkPaint& paint : fPaints) {
+                        canvas->drawRect({0.5f, 0.5f, 31.5f, 31.5f}, paint);
+                    }
+                }
+            });
+        }
+
+        gUseSkVMBlitter = prevUseSkVMBlitter;
+    }
+
+private:
+    const int            fThreads;
+    const int            fPaintCount;
+    SkString             fName;
+    std::vector<SkPaint> fPaints;
+};
+
+DEF_BENCH( return new VMProgramCacheBench( 1,  32); )
+DEF_BENCH( return new VMProgramCacheBench(16,  32); )
+DEF_BENCH( return new VMProgramCacheBench(16, 116); )
+
+// Simulates process start: every loop begins with an empty in-memory program cache and draws a
+// mix of paints.  With a warm persistent cache the programs are loaded rather than compiled.
+class VMProgramStartupBench : public Benchmark {
+public:
+    explicit VMProgramStartupBench(bool persistent) : fUsePersistent(persistent) {
+        fName.printf("VMProgramStartup_%s", persistent ? "warm" : "cold");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0, 0}, {32, 32}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+        sk_sp<SkShader> gradient = SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                                SkTileMode::kClamp);
+        constexpr int kModeCount = (int)SkBlendMode::kLastMode + 1;
+        for (int i = 0; i < 2*kModeCount; i++) {
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(0x80336699);
+            paint.setBlendMode((SkBlendMode)(i % kModeCount));
+            if (i >= kModeCount) {
+                paint.setShader(gradient);
+            }
+            fPaints.push_back(paint);
+        }
+        fSurface = SkSurface::MakeRasterN32Premul(64, 64);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const bool prevUseSkVMBlitter = gUseSkVMBlitter;
+        gUseSkVMBlitter = true;
+        auto prevPersistent = SkGraphics::SetVMProgramPersistentCache(
+                fUsePersistent ? &fPersistent : nullptr);
+
+        for (int loop = 0; loop < loops; loop++) {
+            SkGraphics::PurgeVMProgramCache();
+            for (const SkPaint& paint : fPaints) {
+                fSurface->getCanvas()->drawRect({0.5f, 0.5f, 31.5f, 31.5f}, paint);
+            }
+        }
+
+        SkGraphics::SetVMProgramPersistentCache(prevPersistent);
+        gUseSkVMBlitter = prevUseSkVMBlitter;
+    }
+
+private:
+    // Stands in for a cache on disk.  The first loop populates it.
+    struct MemoryCache final : public SkGraphics::VMProgramPersistentCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            SkAutoMutexExclusive lock(fMutex);
+            for (const auto& [k, data] : fEntries) {
+                if (k->equals(&key)) {
+                    return data;
+                }
+            }
+            return nullptr;
+        }
+        void store(const SkData& key, const SkData& data, const SkString&) override {
+            SkAutoMutexExclusive lock(fMutex);
+            fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                                SkData::MakeWithCopy(data.data(), data.size())});
+        }
+
+        SkMutex fMutex;
+        std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    };
+
+    const bool           fUsePersistent;
+    SkString             fName;
+    std::vector<SkPaint> fPaints;
+    sk_sp<SkSurface>     fSurface;
+    MemoryCache          fPersistent;
+};
+
+DEF_BENCH( return new VMProgramStartupBench(false); )
+DEF_BENCH( return new VMProgramStartupBench( true); )
+
+// Blits large gradient-filled rects with the SkVM blitter, letting the JIT use AVX-512 or not.
+// On CPUs without AVX-512 the two variants should measure the same.
+class VMBlitterLanesBench : public Benchmark {
+public:
+    VMBlitterLanesBench(bool avx512, SkBlendMode mode) : fAVX512(avx512), fMode(mode) {
+        fName.printf("VMBlitter_%s_%s", avx512 ? "avx512" : "avx2", SkBlendMode_Name(mode));
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0, 0}, {512, 512}};
+        const SkColor colors[] = {0x80ff0000, SK_ColorGREEN, 0xc00000ff};
+        fPaint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                      SkTileMode::kMirror));
+        fPaint.setBlendMode(fMode);
+        fSurface = SkSurface::MakeRasterN32Premul(512, 512);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const bool prevUseSkVMBlitter = gUseSkVMBlitter,
+                   prevAllowAVX512    = gSkVMJITAllowAVX512;
+        gUseSkVMBlitter     = true;
+        gSkVMJITAllowAVX512 = fAVX512;
+        SkGraphics::PurgeVMProgramCache();  // Don't reuse a program JIT'd for the other width.
+
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int loop = 0; loop < loops; loop++) {
+            // An odd width exercises the one-pixel-at-a-time tail too.
+            canvas->drawRect({0, 0, 509, 512}, fPaint);
+        }
+
+        SkGraphics::PurgeVMProgramCache();
+        gUseSkVMBlitter     = prevUseSkVMBlitter;
+        gSkVMJITAllowAVX512 = prevAllowAVX512;
+    }
+
+private:
+    const bool        fAVX512;
+    const SkBlendMode fMode;
+    SkString          fName;
+    SkPaint           fPaint;
+    sk_sp<SkSurface>  fSurface;
+};
+
+DEF_BENCH( return new VMBlitterLanesBench(false, SkBlendMode::kSrcOver); )
+DEF_BENCH( return new VMBlitterLanesBench( true, SkBlendMode::kSrcOver); )
+DEF_BENCH( return new VMBlitterLanesBench(false, SkBlendMode::kMultiply); )
+DEF_BENCH( return new VMBlitterLanesBench( true, SkBlendMode::kMultiply); )
@@ -176,6 +176,11 @@ static DEFINE_bool2(verbose, v, false, "enable verbose output from the test driv
 
 static DEFINE_string(skps, "skps", "Directory to read skps from.");
 static DEFINE_string(mskps, "mskps", "Directory to read mskps from.");
+static DEFINE_bool(deserialInPlace, false,
+                   "Also time loading .skps with SkPicture::MakeFromDataWithoutCopy().");
+static DEFINE_bool(deserialParallel, false,
+                   "Also time loading .skps with SkPicture::MakeFromData() decoding them on the "
+                   "thread pool from --threads.");
 static DEFINE_string(svgs, "", "Directory to read SVGs from, or a single SVG file.");
 static DEFINE_string(texttraces, "", "Directory to read TextBlobTrace files from.");
 
@@ -824,6 +829,37 @@ public:
             return new DeserializePictureBench(name.c_str(), std::move(data));
         }
 
+        // Optionally, again loading them in place.
+        while (FLAGS_deserialInPlace && fCurrentDeserialInPlace < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentDeserialInPlace++];
+            sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+            if (!data) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "deserial_in_place";
+            fSKPBytes = static_cast<double>(data->size());
+            fSKPOps   = 0;
+            return new DeserializePictureBench(name.c_str(), std::move(data), /*inPlace=*/true);
+        }
+
+        // Optionally, again decoding them in parallel.
+        while (FLAGS_deserialParallel && fCurrentDeserialParallel < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentDeserialParallel++];
+            sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+            if (!data) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "deserial_parallel";
+            fSKPBytes = static_cast<double>(data->size());
+            fSKPOps   = 0;
+            return new DeserializePictureBench(name.c_str(), std::move(data), /*inPlace=*/false,
+                                               &SkExecutor::GetDefault());
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -1146,6 +1182,8 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
     int fCurrentDeserialPicture = 0;
+    int fCurrentDeserialInPlace = 0;
+    int fCurrentDeserialParallel = 0;
     int fCurrentMSKP = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
@@ -880,6 +880,15 @@ private:
     XformFormat                        fDstXformFormat; // Based on fDstInfo.
     skcms_ICCProfile                   fDstProfile;
     skcms_AlphaFormat                  fDstXformAlphaFormat;
+    // What initializeColorXform() works out once for every applyColorXform() of a decode.
+    // Other sources run each row through skcms_Transform().
+    struct XformPlan {
+        // For 8-bit gray sources, every gray level already converted to fDstXformFormat, so rows
+        // are looked up as palettes are rather than each run through skcms.  Empty otherwise.
+        SkAutoTMalloc<uint8_t>         fGrayTable;
+        size_t                         fDstBytesPerPixel = 0;
+    };
+    XformPlan                          fXformPlan;
 
     // Only meaningful during scanline decodes.
     int                                fCurrScanline;
@@ -891,6 +900,7 @@ private:
     bool                               fAndroidCodecHandlesFrameIndex;
 
     bool initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha, bool srcIsOpaque);
+    bool initializeXformPlan();
 
     /**
      *  Return whether these dimensions are supported as a scale.
@@ -637,6 +637,11 @@ public:
                                           1 << 3, //!< experimental: do not use
         // instead of matching previous layer's colortype, use F16
         kF16ColorType                   = 1 << 4,
+        // With fBackdrop, keep the filtered backdrop and reuse it on a later saveLayer if the
+        // pixels it was filtered from, the filter, and the layer's bounds and transform are all
+        // unchanged. This trades memory (a copy of the prior layer and the new one) for skipping
+        // the filter. Only raster canvases take part; others ignore this flag.
+        kCacheBackdrop_SaveLayerFlag    = 1 << 5,
     };
 
     typedef uint32_t SaveLayerFlags;
@@ -2486,6 +2491,10 @@ private:
 
     std::unique_ptr<SkGlyphRunBuilder> fScratchGlyphRunBuilder;
 
+    // Filtered backdrops kept for saveLayers with kCacheBackdrop_SaveLayerFlag.
+    struct BackdropCache;
+    std::unique_ptr<BackdropCache> fBackdropCache;
+
     using INHERITED = SkRefCnt;
 };
 
@@ -11,7 +11,9 @@
 #include "include/core/SkRefCnt.h"
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
+class SkString;
 class SkTraceMemoryDump;
 
 class SK_API SkGraphics {
@@ -103,6 +105,99 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Return the number of compiled raster blitter programs currently cached. Programs are
+     *  shared by every thread that draws into raster surfaces.
+     */
+    static int GetVMProgramCacheCountUsed();
+
+    /**
+     *  These functions get/set the limit to the number of compiled raster blitter programs that
+     *  are cached. Setting a lower limit immediately evicts the least recently used programs.
+     *  SetVMProgramCacheCountLimit() returns the previous limit.
+     */
+    static int GetVMProgramCacheCountLimit();
+    static int SetVMProgramCacheCountLimit(int count);
+
+    /**
+     *  For debugging purposes, this will attempt to purge the blitter program cache. It does
+     *  not change the limit.
+     */
+    static void PurgeVMProgramCache();
+
+    /**
+     *  Abstract cache that persists compiled raster blitter programs across process launches, so
+     *  warm starts can skip compiling them, like GrContextOptions::PersistentCache does for GPU
+     *  shaders. load() and store() may be called from any thread, including concurrently.
+     */
+    class SK_API VMProgramPersistentCache {
+    public:
+        virtual ~VMProgramPersistentCache() = default;
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        /**
+         *  Stores data in the cache, indexed by key. description provides a human-readable
+         *  version of the key.
+         */
+        virtual void store(const SkData& key, const SkData& data, const SkString& description) = 0;
+
+    protected:
+        VMProgramPersistentCache() = default;
+        VMProgramPersistentCache(const VMProgramPersistentCache&) = delete;
+        VMProgramPersistentCache& operator=(const VMProgramPersistentCache&) = delete;
+    };
+
+    /**
+     *  Sets the persistent cache consulted when a blitter program isn't in the in-memory cache,
+     *  returning the previous one. The cache is not owned, and must outlive its use; pass nullptr
+     *  to stop using it. Data stored in the cache contains executable code and must be trusted.
+     */
+    static VMProgramPersistentCache* SetVMProgramPersistentCache(VMProgramPersistentCache*);
+
+    /**
+     *  Turns caching of raster path coverage masks on or off, returning the previous setting.
+     *  When on, a path that is not volatile and is redrawn with the same matrix (up to a whole
+     *  pixel translation) and stroke is blitted from an A8 mask kept in the resource cache,
+     *  rather than scan converted again. Caching is off by default.
+     */
+    static bool SetPathCoverageMaskCacheEnabled(bool enabled);
+
+    /**
+     *  Turns caching of stitched Perlin noise tiles on or off, returning the previous setting.
+     *  When on, a stitched SkPerlinNoiseShader drawn in raster twice in a row with the same matrix
+     *  and paint alpha shades its whole tile (up to 512x512) into the resource cache, and later
+     *  draws copy from it. Caching is off by default.
+     */
+    static bool SetPerlinNoiseTileCacheEnabled(bool enabled);
+
+    /**
+     *  Lets anti-aliased raster fills of huge paths (16K points or more) that Skia scan converts
+     *  by accumulating coverage do so in bands of rows on the executor, up to maxThreads bands at
+     *  a time, returning the previous executor. This never changes how a path is scan converted,
+     *  so the pixels are exactly those of a serial fill. Paths filled with analytic or
+     *  supersampled anti-aliasing, as all paths are by default, stay on the drawing thread.
+     *  The executor is not owned, and must outlive its use; pass nullptr (the default) to fill
+     *  every path on the drawing thread.
+     */
+    static SkExecutor* SetParallelPathFillExecutor(SkExecutor*, int maxThreads);
+
+    /**
+     *  Turns counting of how raster draws are blitted on or off, returning the previous setting:
+     *  which kind of blitter each draw picks, how many pixels each kind blits, and which stages
+     *  each SkRasterPipeline is built from, and whether it runs in lowp or falls back to highp.
+     *  Counting is off by default, and slows raster drawing a little while on.
+     *
+     *  The counts are reported by DumpMemoryStatistics() under "skia/blitter_stats" and
+     *  "skia/raster_pipeline_stats", and as SkEventTracer counters by TraceBlitterStatistics().
+     */
+    static bool SetBlitterStatisticsEnabled(bool enabled);
+    static void ResetBlitterStatistics();
+    static void TraceBlitterStatistics();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -18,6 +18,7 @@
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
 class SkMatrix;
 struct SkSerialProcs;
@@ -72,6 +73,20 @@ public:
     static sk_sp<SkPicture> MakeFromData(const SkData* data,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, like MakeFromData(), but if executor
+        is not nullptr, decodes the picture's paints, paths and images on it in parallel, and
+        waits for them before returning. procs must then be safe to call on several threads at
+        once. Pictures serialized before paints, paths and images were indexed are decoded
+        serially.
+
+        @param data      container for serial data
+        @param procs     custom serial data decoders; may be nullptr
+        @param executor  runs the decoding tasks; may be nullptr
+        @return          SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromData(const SkData* data, const SkDeserialProcs* procs,
+                                         SkExecutor* executor);
+
     /**
 
         @param data   pointer to serial data
@@ -82,6 +97,21 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, like MakeFromData(), but plays it
+        back from data in place instead of copying its drawing commands. The returned SkPicture
+        keeps a reference to data, which must not change; it may be a file mapped into memory
+        with SkData::MakeFromFileName().
+
+        Paints, paths and images are decoded the first time they are drawn, so procs, and
+        anything their contexts point to, must outlive the returned SkPicture.
+
+        @param data   container for serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture drawing from data
+    */
+    static sk_sp<SkPicture> MakeFromDataWithoutCopy(sk_sp<SkData> data,
+                                                    const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -239,13 +269,16 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
         bool textBlobsOnly=false) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           sk_sp<SkData> source = nullptr,
+                                           SkExecutor* executor = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -271,7 +304,7 @@ private:
                                         class SkReadBuffer* buffer);
 
     struct SkPictInfo createHeader() const;
-    class SkPictureData* backport() const;
+    class SkPictureData* backport(bool withOpIndex = false) const;
 
     uint32_t fUniqueID;
     mutable std::atomic<bool> fAddedToCache{false};
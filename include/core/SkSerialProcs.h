@@ -56,6 +56,14 @@ struct SK_API SkSerialProcs {
 
     SkSerialTypefaceProc fTypefaceProc = nullptr;
     void*                fTypefaceCtx = nullptr;
+
+    /**
+     *  If true, pictures recorded with an SkBBHFactory also store the bounds and offset of each
+     *  of their ops, about 20 bytes per op. When such a picture is loaded with
+     *  SkPicture::MakeFromDataWithoutCopy() and drawn clipped, only the ops the clip touches are
+     *  read. Off by default.
+     */
+    bool fWritePictureOpIndex = false;
 };
 
 struct SK_API SkDeserialProcs {
@@ -17,6 +17,7 @@
 #define SKPDF_STRING(X) SKPDF_STRING_IMPL(X)
 #define SKPDF_STRING_IMPL(X) #X
 
+class SkData;
 class SkExecutor;
 class SkPDFArray;
 class SkPDFTagTree;
@@ -125,6 +126,26 @@ struct StructureElementNode {
     DocumentStructureType fType = DocumentStructureType::kNonStruct;
 };
 
+/** A cache of encoded image XObjects that may outlive a single document, so that
+    a batch job emitting many PDFs with the same images (logos, letterheads, ...)
+    only compresses each image once.  Keys are derived from a hash of the image's
+    encoded data or pixels, and the encoding quality.
+
+    If Metadata::fExecutor is set, load() and store() may be called concurrently
+    from several threads.
+
+    Experimental.
+*/
+class SK_API ImageCache {
+public:
+    virtual ~ImageCache() = default;
+
+    /** Returns the data previously stored for key, or nullptr. */
+    virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+    virtual void store(const SkData& key, const SkData& data) = 0;
+};
+
 /** Optional metadata to be passed into the PDF factory function.
 */
 struct Metadata {
@@ -205,6 +226,15 @@ struct Metadata {
     */
     SkExecutor* fExecutor = nullptr;
 
+    /** An optional cache of encoded images shared between documents.  Images
+        with identical contents are always emitted once per document; this also
+        skips re-encoding them across documents.  The caller should retain
+        ownership.
+
+        Experimental.
+    */
+    ImageCache* fImageCache = nullptr;
+
     /** Preferred Subsetter. Only respected if both are compiled in.
 
         The Sfntly subsetter is deprecated.
@@ -54,6 +54,15 @@ public:
          *  example: https://fiddle.skia.org/c/@GradientShader_MakeLinear
          */
         kInterpolateColorsInPremul_Flag = 1 << 0,
+
+        /** When drawing into a raster surface, interpolate between the entries of a table of
+         *  1024 8-bit colors, built once per destination color space and kept with the shader,
+         *  instead of searching the stops for every pixel.  This is much faster for gradients
+         *  with many stops, but rounds the colors to 8 bits, clamps them to [0,1], and softens
+         *  hard stops and sharp corners by up to 1/1024 of the gradient's length.  The GPU
+         *  backend ignores this flag.
+         */
+        kUseColorLookupTable_Flag       = 1 << 1,
     };
 
     /** Returns a shader that generates a linear gradient between the two specified points.
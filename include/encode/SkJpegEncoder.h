@@ -10,8 +10,10 @@
 
 #include "include/encode/SkEncoder.h"
 
+class SkColorSpace;
 class SkJpegEncoderMgr;
 class SkWStream;
+class SkYUVAPixmaps;
 
 class SK_API SkJpegEncoder : public SkEncoder {
 public:
@@ -71,6 +73,20 @@ public:
      */
     static bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options);
 
+    /**
+     *  Encode the |src| YUV planes to the |dst| stream without converting them to RGB first.
+     *  |src| must have 8-bit Y, U, and V in separate planes (SkYUVAInfo::PlaneConfig::kY_U_V)
+     *  and use kJPEG_Full_SkYUVColorSpace.  The encoded image uses the subsampling of |src|,
+     *  ignoring |options|.fDownsample, and is written with the planes' memory layout, i.e.
+     *  |src|'s origin is not applied.
+     *
+     *  |srcColorSpace| is optional and, if set, is embedded as an ICC profile.
+     *
+     *  Returns true on success.  Returns false on an invalid or unsupported |src|.
+     */
+    static bool Encode(SkWStream* dst, const SkYUVAPixmaps& src,
+                       const SkColorSpace* srcColorSpace, const Options& options);
+
     /**
      *  Create a jpeg encoder that will encode the |src| pixels to the |dst| stream.
      *  |options| may be used to control the encoding behavior.
@@ -732,11 +732,64 @@ bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Al
         } else {
             fDstXformAlphaFormat = skcms_AlphaFormat_Unpremul;
         }
+        if (!this->initializeXformPlan()) {
+            return false;
+        }
     }
     return true;
 }
 
+static size_t xform_bytes_per_pixel(skcms_PixelFormat format) {
+    switch (format) {
+        case skcms_PixelFormat_G_8:         return 1;
+        case skcms_PixelFormat_BGR_565:     return 2;
+        case skcms_PixelFormat_RGBA_8888:
+        case skcms_PixelFormat_BGRA_8888:   return 4;
+        case skcms_PixelFormat_RGBA_hhhh:   return 8;
+        default:                            return 0;
+    }
+}
+
+bool SkCodec::initializeXformPlan() {
+    fXformPlan.fGrayTable.reset(0);
+    fXformPlan.fDstBytesPerPixel = xform_bytes_per_pixel(fDstXformFormat);
+    SkASSERT(fXformPlan.fDstBytesPerPixel);
+    if (fSrcXformFormat != skcms_PixelFormat_G_8) {
+        return true;
+    }
+
+    // It is okay for srcProfile to be null. This will use sRGB.
+    const auto* srcProfile = fEncodedInfo.profile();
+    uint8_t levels[256];
+    for (int i = 0; i < 256; i++) {
+        levels[i] = i;
+    }
+    fXformPlan.fGrayTable.reset(256 * fXformPlan.fDstBytesPerPixel);
+    return skcms_Transform(levels, fSrcXformFormat, skcms_AlphaFormat_Unpremul, srcProfile,
+                           fXformPlan.fGrayTable.get(), fDstXformFormat,
+                           fDstXformAlphaFormat, &fDstProfile, 256);
+}
+
+template <typename T>
+static void lookup_gray_row(void* dst, const void* src, const uint8_t* table, int count) {
+    const uint8_t* levels = static_cast<const uint8_t*>(src);
+    uint8_t* pixels = static_cast<uint8_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        memcpy(pixels + i * sizeof(T), table + levels[i] * sizeof(T), sizeof(T));
+    }
+}
+
 void SkCodec::applyColorXform(void* dst, const void* src, int count) const {
+    if (const uint8_t* table = fXformPlan.fGrayTable.get()) {
+        switch (fXformPlan.fDstBytesPerPixel) {
+            case 1: lookup_gray_row<uint8_t >(dst, src, table, count); return;
+            case 2: lookup_gray_row<uint16_t>(dst, src, table, count); return;
+            case 4: lookup_gray_row<uint32_t>(dst, src, table, count); return;
+            case 8: lookup_gray_row<uint64_t>(dst, src, table, count); return;
+        }
+        SkASSERT(false);
+    }
+
     // It is okay for srcProfile to be null. This will use sRGB.
     const auto* srcProfile = fEncodedInfo.profile();
     SkAssertResult(skcms_Transform(src, fSrcXformFormat, skcms_AlphaFormat_Unpremul, srcProfile,
@@ -53,6 +53,16 @@ void SkBigPicture::partialPlayback(SkCanvas* canvas,
                         initialCTM);
 }
 
+void SkBigPicture::playbackEachOp(SkCanvas* canvas,
+                                  const std::function<void(int)>& afterOp) const {
+    SkASSERT(canvas);
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    for (int i = 0; i < fRecord->count(); i++) {
+        fRecord->visit(i, draw);
+        afterOp(i);
+    }
+}
+
 struct NestedApproxOpCounter {
     int fCount = 0;
 
@@ -15,6 +15,8 @@
 #include "include/private/SkOnce.h"
 #include "include/private/SkTemplates.h"
 
+#include <functional>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
@@ -54,6 +56,11 @@ public:
                          int start,
                          int stop,
                          const SkM44& initialCTM) const;
+// Used by SkPicture::backport() to note where each op lands as it serializes the picture.
+// Draws every op, without the save/restore around them that playback() adds, calling afterOp(i)
+// once op i has been drawn.
+    void playbackEachOp(SkCanvas*, const std::function<void(int)>& afterOp) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -313,7 +313,12 @@ SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPa
         info = info.makeColorType(kN32_SkColorType);
     }
 
-    return SkBitmapDevice::Create(info, surfaceProps, cinfo.fTrackCoverage, cinfo.fAllocator);
+    SkBitmapDevice* device = SkBitmapDevice::Create(info, surfaceProps, cinfo.fTrackCoverage,
+                                                    cinfo.fAllocator);
+    if (device) {
+        device->fImageFilterCache = fImageFilterCache;
+    }
+    return device;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -627,7 +632,8 @@ sk_sp<SkSurface> SkBitmapDevice::makeSurface(const SkImageInfo& info, const SkSu
 }
 
 SkImageFilterCache* SkBitmapDevice::getImageFilterCache() {
-    SkImageFilterCache* cache = SkImageFilterCache::Get();
+    SkImageFilterCache* cache = fImageFilterCache ? fImageFilterCache.get()
+                                                  : SkImageFilterCache::Get();
     cache->ref();
     return cache;
 }
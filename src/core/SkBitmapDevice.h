@@ -18,6 +18,7 @@
 #include "include/core/SkSurfaceProps.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkGlyphRunPainter.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
 
@@ -68,6 +69,12 @@ public:
         return fCoverage ? &fCoverage->pixmap() : nullptr;
     }
 
+    // Image filters drawn by this device, and by the layer devices created from it, cache their
+    // results in 'cache' instead of the global SkImageFilterCache.
+    void setImageFilterCacheForTesting(sk_sp<SkImageFilterCache> cache) {
+        fImageFilterCache = std::move(cache);
+    }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -159,6 +166,7 @@ private:
     SkRasterClipStack  fRCStack;
     std::unique_ptr<SkBitmap> fCoverage;    // if non-null, will have the same dimensions as fBitmap
     SkGlyphRunListPainter fGlyphPainter;
+    sk_sp<SkImageFilterCache> fImageFilterCache;    // if null, the global cache is used
 
 
     using INHERITED = SkBaseDevice;
@@ -14,6 +14,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkAntiRun.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitterStats.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixProvider.h"
@@ -699,8 +700,13 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
                              sk_sp<SkShader> clipShader) {
     SkASSERT(alloc);
 
+    using Kind = SkBlitterStats::Kind;
+    auto chose = [&](Kind kind, SkBlitter* blitter) {
+        return SkBlitterStats::Chose(kind, blitter, alloc);
+    };
+
     if (kUnknown_SkColorType == device.colorType()) {
-        return alloc->make<SkNullBlitter>();
+        return chose(Kind::kNull, alloc->make<SkNullBlitter>());
     }
 
     // We may tweak the original paint as we go.
@@ -714,7 +720,7 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
                     paint.writable()->setBlendMode(SkBlendMode::kSrcOver);
                     break;
                 case kSkipDrawing_SkXfermodeInterpretation:
-                    return alloc->make<SkNullBlitter>();
+                    return chose(Kind::kNull, alloc->make<SkNullBlitter>());
                 default:
                     break;
             }
@@ -739,9 +745,9 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
         if (device.colorType() == kAlpha_8_SkColorType) {
             SkASSERT(!paint->getShader());
             SkASSERT(paint->isSrcOver());
-            return alloc->make<SkA8_Coverage_Blitter>(device, *paint);
+            return chose(Kind::kA8Coverage, alloc->make<SkA8_Coverage_Blitter>(device, *paint));
         }
-        return alloc->make<SkNullBlitter>();
+        return chose(Kind::kNull, alloc->make<SkNullBlitter>());
     }
 
     if (paint->isDither() && !SkPaintPriv::ShouldDither(*paint, device.colorType())) {
@@ -751,7 +757,7 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
     if (gUseSkVMBlitter) {
         if (auto blitter = SkVMBlitter::Make(device, *paint, matrixProvider,
                                              alloc, clipShader)) {
-            return blitter;
+            return chose(Kind::kVM, blitter);
         }
     }
 
@@ -760,13 +766,13 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
     auto create_SkRP_or_SkVMBlitter = [&]() -> SkBlitter* {
         if (auto blitter = SkCreateRasterPipelineBlitter(device, *paint, matrixProvider,
                                                          alloc, clipShader)) {
-            return blitter;
+            return chose(Kind::kRasterPipeline, blitter);
         }
         if (auto blitter = SkVMBlitter::Make(device, *paint, matrixProvider,
                                              alloc, clipShader)) {
-            return blitter;
+            return chose(Kind::kVM, blitter);
         }
-        return alloc->make<SkNullBlitter>();
+        return chose(Kind::kNull, alloc->make<SkNullBlitter>());
     };
 
     SkMatrix ctm = matrixProvider.localToDevice();
@@ -798,25 +804,29 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
     switch (device.colorType()) {
         case kN32_SkColorType:
             if (shaderContext) {
-                return alloc->make<SkARGB32_Shader_Blitter>(device, *paint, shaderContext);
+                return chose(Kind::kARGB32Shader,
+                             alloc->make<SkARGB32_Shader_Blitter>(device, *paint, shaderContext));
             } else if (paint->getColor() == SK_ColorBLACK) {
-                return alloc->make<SkARGB32_Black_Blitter>(device, *paint);
+                return chose(Kind::kARGB32Black,
+                             alloc->make<SkARGB32_Black_Blitter>(device, *paint));
             } else if (paint->getAlpha() == 0xFF) {
-                return alloc->make<SkARGB32_Opaque_Blitter>(device, *paint);
+                return chose(Kind::kARGB32Opaque,
+                             alloc->make<SkARGB32_Opaque_Blitter>(device, *paint));
             } else {
-                return alloc->make<SkARGB32_Blitter>(device, *paint);
+                return chose(Kind::kARGB32, alloc->make<SkARGB32_Blitter>(device, *paint));
             }
 
         case kRGB_565_SkColorType:
             if (shaderContext && SkRGB565_Shader_Blitter::Supports(device, *paint)) {
-                return alloc->make<SkRGB565_Shader_Blitter>(device, *paint, shaderContext);
+                return chose(Kind::kRGB565Shader,
+                             alloc->make<SkRGB565_Shader_Blitter>(device, *paint, shaderContext));
             } else {
                 return create_SkRP_or_SkVMBlitter();
             }
 
         default:
             SkASSERT(false);
-            return alloc->make<SkNullBlitter>();
+            return chose(Kind::kNull, alloc->make<SkNullBlitter>());
     }
 }
 
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkString.h"
+#include "include/core/SkTraceMemoryDump.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTHash.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkBlitterStats.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTraceEvent.h"
+
+namespace SkBlitterStats {
+
+std::atomic<bool> gEnabled{false};
+
+namespace {
+
+    static constexpr int kStageCount = 0
+    #define M(stage) + 1
+        SK_RASTER_PIPELINE_STAGES(M)
+    #undef M
+    ;
+
+    struct KindCounters {
+        std::atomic<uint64_t> choices{0},
+                              pixels{0};
+    };
+    KindCounters gKinds[kKindCount];
+
+    std::atomic<uint64_t> gLowpPipelines{0},
+                          gHighpPipelines{0},
+                          gFallbacks[kStageCount];
+
+    // Distinct stage lists, keyed by their hash.  We stop tracking new lists past a limit,
+    // so a pathological client can't grow this without bound; those are just counted.
+    struct PipelineEntry {
+        SkString stages;
+        bool     lowp;
+        uint64_t count;
+    };
+    static constexpr int kMaxPipelineEntries = 1024;
+
+    struct Pipelines {
+        SkMutex                              mutex;
+        SkTHashMap<uint32_t, PipelineEntry>  entries SK_GUARDED_BY(mutex);
+        uint64_t                             untracked SK_GUARDED_BY(mutex) = 0;
+    };
+    Pipelines* pipelines() {
+        static Pipelines* pipelines = new Pipelines;
+        return pipelines;
+    }
+
+    const char* stage_name(SkRasterPipeline::StockStage stage) {
+        switch (stage) {
+        #define M(x) case SkRasterPipeline::x: return #x;
+            SK_RASTER_PIPELINE_STAGES(M)
+        #undef M
+        }
+        return "";
+    }
+
+    // Forwards everything to the chosen blitter, counting how many pixels each call covers.
+    class CountingBlitter final : public SkBlitter {
+    public:
+        CountingBlitter(SkBlitter* blitter, KindCounters* counters)
+            : fBlitter(blitter), fCounters(counters) {}
+
+        ~CountingBlitter() override {
+            fCounters->pixels.fetch_add(fPixels, std::memory_order_relaxed);
+        }
+
+        void blitH(int x, int y, int width) override {
+            fPixels += width;
+            fBlitter->blitH(x, y, width);
+        }
+        void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+            for (const int16_t* run = runs; *run > 0; run += *run) {
+                fPixels += *run;
+            }
+            fBlitter->blitAntiH(x, y, antialias, runs);
+        }
+        void blitV(int x, int y, int height, SkAlpha alpha) override {
+            fPixels += height;
+            fBlitter->blitV(x, y, height, alpha);
+        }
+        void blitRect(int x, int y, int width, int height) override {
+            fPixels += (uint64_t)width * height;
+            fBlitter->blitRect(x, y, width, height);
+        }
+        void blitAntiRect(int x, int y, int width, int height,
+                          SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+            fPixels += (uint64_t)(width + 2) * height;
+            fBlitter->blitAntiRect(x, y, width, height, leftAlpha, rightAlpha);
+        }
+        void blitMask(const SkMask& mask, const SkIRect& clip) override {
+            fPixels += (uint64_t)clip.width() * clip.height();
+            fBlitter->blitMask(mask, clip);
+        }
+        void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+            fPixels += 2;
+            fBlitter->blitAntiH2(x, y, a0, a1);
+        }
+        void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+            fPixels += 2;
+            fBlitter->blitAntiV2(x, y, a0, a1);
+        }
+
+        const SkPixmap* justAnOpaqueColor(uint32_t* value) override {
+            return fBlitter->justAnOpaqueColor(value);
+        }
+        bool isNullBlitter() const override { return fBlitter->isNullBlitter(); }
+        int requestRowsPreserved() const override { return fBlitter->requestRowsPreserved(); }
+        void* allocBlitMemory(size_t sz) override { return fBlitter->allocBlitMemory(sz); }
+
+    private:
+        SkBlitter*    fBlitter;
+        KindCounters* fCounters;
+        uint64_t      fPixels = 0;  // Published to fCounters when we're done.
+    };
+
+}  // namespace
+
+const char* KindName(Kind kind) {
+    switch (kind) {
+        case Kind::kNull:                 return "null";
+        case Kind::kA8Coverage:           return "a8_coverage";
+        case Kind::kARGB32:               return "argb32";
+        case Kind::kARGB32Black:          return "argb32_black";
+        case Kind::kARGB32Opaque:         return "argb32_opaque";
+        case Kind::kARGB32Shader:         return "argb32_shader";
+        case Kind::kRGB565Shader:         return "rgb565_shader";
+        case Kind::kRasterPipeline:       return "raster_pipeline";
+        case Kind::kVM:                   return "vm";
+        case Kind::kSpriteMemcpy:         return "sprite_memcpy";
+        case Kind::kSpriteLegacy:         return "sprite_legacy";
+        case Kind::kSpriteRasterPipeline: return "sprite_raster_pipeline";
+        case Kind::kSpriteVM:             return "sprite_vm";
+    }
+    SkUNREACHABLE;
+}
+
+bool SetEnabled(bool enabled) {
+    return gEnabled.exchange(enabled);
+}
+
+void Reset() {
+    for (KindCounters& counters : gKinds) {
+        counters.choices = 0;
+        counters.pixels  = 0;
+    }
+    gLowpPipelines  = 0;
+    gHighpPipelines = 0;
+    for (auto& fallbacks : gFallbacks) {
+        fallbacks = 0;
+    }
+    Pipelines* p = pipelines();
+    SkAutoMutexExclusive lock(p->mutex);
+    p->entries.reset();
+    p->untracked = 0;
+}
+
+SkBlitter* Chose(Kind kind, SkBlitter* blitter, SkArenaAlloc* alloc) {
+    if (!Enabled() || !blitter) {
+        return blitter;
+    }
+    KindCounters* counters = &gKinds[(int)kind];
+    counters->choices.fetch_add(1, std::memory_order_relaxed);
+    if (blitter->isNullBlitter()) {
+        return blitter;  // Nothing to count, so no need to slow down skipping the draw.
+    }
+    return alloc->make<CountingBlitter>(blitter, counters);
+}
+
+void BuiltPipeline(SkSpan<const SkRasterPipeline::StockStage> stages, bool lowp, int fallback) {
+    if (!Enabled()) {
+        return;
+    }
+    (lowp ? gLowpPipelines : gHighpPipelines).fetch_add(1, std::memory_order_relaxed);
+    if (!lowp && fallback >= 0) {
+        SkASSERT(fallback < (int)stages.size());
+        gFallbacks[stages[fallback]].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t hash = SkOpts::hash(stages.data(), stages.size_bytes(), lowp);
+    Pipelines* p = pipelines();
+    SkAutoMutexExclusive lock(p->mutex);
+    if (PipelineEntry* entry = p->entries.find(hash)) {
+        entry->count++;
+    } else if (p->entries.count() < kMaxPipelineEntries) {
+        SkString names;
+        for (SkRasterPipeline::StockStage stage : stages) {
+            if (!names.isEmpty()) {
+                names.append(" ");
+            }
+            names.append(stage_name(stage));
+        }
+        p->entries.set(hash, {std::move(names), lowp, 1});
+    } else {
+        p->untracked++;
+    }
+}
+
+void Dump(SkTraceMemoryDump* dump) {
+    for (int i = 0; i < kKindCount; i++) {
+        const KindCounters& counters = gKinds[i];
+        if (uint64_t choices = counters.choices.load()) {
+            SkString name = SkStringPrintf("skia/blitter_stats/%s", KindName((Kind)i));
+            dump->dumpNumericValue(name.c_str(), "choices", "objects", choices);
+            dump->dumpNumericValue(name.c_str(), "pixels", "objects", counters.pixels.load());
+        }
+    }
+
+    const uint64_t lowp  = gLowpPipelines.load(),
+                   highp = gHighpPipelines.load();
+    if (lowp + highp == 0) {
+        return;
+    }
+    static constexpr char kPipelines[] = "skia/raster_pipeline_stats";
+    dump->dumpNumericValue(kPipelines, "lowp", "objects", lowp);
+    dump->dumpNumericValue(kPipelines, "highp", "objects", highp);
+    for (int stage = 0; stage < kStageCount; stage++) {
+        if (uint64_t fallbacks = gFallbacks[stage].load()) {
+            SkString name = SkStringPrintf("%s/highp_fallback/%s",
+                                           kPipelines,
+                                           stage_name((SkRasterPipeline::StockStage)stage));
+            dump->dumpNumericValue(name.c_str(), "count", "objects", fallbacks);
+        }
+    }
+
+    Pipelines* p = pipelines();
+    SkAutoMutexExclusive lock(p->mutex);
+    dump->dumpNumericValue(kPipelines, "untracked", "objects", p->untracked);
+    p->entries.foreach([&](uint32_t hash, PipelineEntry* entry) {
+        SkString name = SkStringPrintf("%s/pipeline_%08x", kPipelines, hash);
+        dump->dumpNumericValue(name.c_str(), "count", "objects", entry->count);
+        dump->dumpStringValue (name.c_str(), "precision", entry->lowp ? "lowp" : "highp");
+        dump->dumpStringValue (name.c_str(), "stages", entry->stages.c_str());
+    });
+}
+
+void Trace() {
+    for (int i = 0; i < kKindCount; i++) {
+        const KindCounters& counters = gKinds[i];
+        TRACE_COUNTER2("skia.blitter", KindName((Kind)i),
+                       "choices", counters.choices.load(),
+                       "pixels",  counters.pixels.load());
+    }
+    TRACE_COUNTER2("skia.blitter", "raster_pipeline",
+                   "lowp",  gLowpPipelines.load(),
+                   "highp", gHighpPipelines.load());
+}
+
+}  // namespace SkBlitterStats
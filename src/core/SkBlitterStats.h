@@ -0,0 +1,69 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlitterStats_DEFINED
+#define SkBlitterStats_DEFINED
+
+#include "include/core/SkSpan.h"
+#include "src/core/SkRasterPipeline.h"
+
+#include <atomic>
+
+class SkArenaAlloc;
+class SkBlitter;
+class SkTraceMemoryDump;
+
+// Optional process-wide counters describing how raster draws get blitted: which blitter
+// SkBlitter::Choose() or ChooseSprite() picks, how many pixels each kind of blitter covers,
+// and which stages SkRasterPipelines are built from, in lowp or highp.
+//
+// Counting is off by default.  While off, each hook costs one relaxed atomic load.
+namespace SkBlitterStats {
+
+    enum class Kind {
+        kNull,
+        kA8Coverage,
+        kARGB32,
+        kARGB32Black,
+        kARGB32Opaque,
+        kARGB32Shader,
+        kRGB565Shader,
+        kRasterPipeline,
+        kVM,
+        kSpriteMemcpy,
+        kSpriteLegacy,
+        kSpriteRasterPipeline,
+        kSpriteVM,
+
+        kLast = kSpriteVM,
+    };
+    static constexpr int kKindCount = (int)Kind::kLast + 1;
+
+    const char* KindName(Kind);
+
+    extern std::atomic<bool> gEnabled;
+    static inline bool Enabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+    bool SetEnabled(bool);  // Returns the previous setting.
+    void Reset();
+
+    // Counts a choice of blitter.  When counting is enabled, returns a blitter that wraps
+    // (and forwards everything to) blitter, counting the pixels it blits; otherwise blitter.
+    SkBlitter* Chose(Kind, SkBlitter* blitter, SkArenaAlloc*);
+
+    // Counts an SkRasterPipeline built to run in lowp, or in highp, where fallback is the index
+    // of the stage that had no lowp implementation (or -1 if lowp was never attempted).
+    void BuiltPipeline(SkSpan<const SkRasterPipeline::StockStage> stages, bool lowp,
+                       int fallback);
+
+    // Report all counters, to a memory dump, or as SkEventTracer counter events.
+    void Dump(SkTraceMemoryDump*);
+    void Trace();
+
+}  // namespace SkBlitterStats
+
+#endif  // SkBlitterStats_DEFINED
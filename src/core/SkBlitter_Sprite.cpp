@@ -7,6 +7,7 @@
 
 #include "include/core/SkColorSpace.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitterStats.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkCoreBlitters.h"
@@ -187,8 +188,14 @@ SkBlitter* SkBlitter::ChooseSprite(const SkPixmap& dst, const SkPaint& paint,
     */
     SkASSERT(alloc != nullptr);
 
+    using Kind = SkBlitterStats::Kind;
+    auto chose = [&](Kind kind, SkBlitter* blitter) {
+        return SkBlitterStats::Chose(kind, blitter, alloc);
+    };
+
     if (gUseSkVMBlitter) {
-        return SkVMBlitter::Make(dst, paint, source,left,top, alloc, std::move(clipShader));
+        return chose(Kind::kSpriteVM,
+                     SkVMBlitter::Make(dst, paint, source,left,top, alloc, std::move(clipShader)));
     }
 
     // TODO: in principle SkRasterPipelineSpriteBlitter could be made to handle this.
@@ -197,10 +204,12 @@ SkBlitter* SkBlitter::ChooseSprite(const SkPixmap& dst, const SkPaint& paint,
     }
 
     SkSpriteBlitter* blitter = nullptr;
+    Kind kind = Kind::kSpriteLegacy;
 
     if (0 == SkColorSpaceXformSteps(source,dst).flags.mask() && !clipShader) {
         if (!blitter && SkSpriteBlitter_Memcpy::Supports(dst, source, paint)) {
             blitter = alloc->make<SkSpriteBlitter_Memcpy>(source);
+            kind = Kind::kSpriteMemcpy;
         }
         if (!blitter) {
             switch (dst.colorType()) {
@@ -220,11 +229,13 @@ SkBlitter* SkBlitter::ChooseSprite(const SkPixmap& dst, const SkPaint& paint,
     }
     if (!blitter && !paint.getMaskFilter()) {
         blitter = alloc->make<SkRasterPipelineSpriteBlitter>(source, alloc, clipShader);
+        kind = Kind::kSpriteRasterPipeline;
     }
 
     if (blitter && blitter->setup(dst, left,top, paint)) {
-        return blitter;
+        return chose(kind, blitter);
     }
 
-    return SkVMBlitter::Make(dst, paint, source,left,top, alloc, std::move(clipShader));
+    return chose(Kind::kSpriteVM,
+                 SkVMBlitter::Make(dst, paint, source,left,top, alloc, std::move(clipShader)));
 }
@@ -519,6 +519,15 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
         SkASSERT(!smallR[1].isEmpty());
     }
 
+    // The patch is positioned by fOuterRect, so its mask only depends on where smallR sits within
+    // a pixel.  Move smallR to within a pixel of the origin before looking it up, so rects of any
+    // size or position with the same blur and subpixel phase share one small cached mask.
+    const SkScalar tx = -SkScalarFloorToScalar(smallR[0].fLeft),
+                   ty = -SkScalarFloorToScalar(smallR[0].fTop);
+    for (int i = 0; i < count; ++i) {
+        smallR[i].offset(tx, ty);
+    }
+
     const SkScalar sigma = this->computeXformedSigma(matrix);
     SkCachedData* cache = find_cached_rects(&patch->fMask, sigma, fBlurStyle, smallR, count);
     if (!cache) {
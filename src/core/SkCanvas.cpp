@@ -47,8 +47,10 @@
 #include "src/image/SkSurface_Base.h"
 #include "src/utils/SkPatchUtils.h"
 
+#include <algorithm>
 #include <memory>
 #include <new>
+#include <vector>
 
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrDirectContext.h"
@@ -191,6 +193,92 @@ enum class CheckForOverwrite : bool {
 
 }  // namespace
 
+// A backdrop is a pure function of the prior device's pixels that the backdrop filter reads, the
+// filter, and the new layer's geometry, so when all of those match a previous saveLayer we can copy
+// that layer's initial pixels instead of filtering again. The pixels are compared directly rather
+// than trusting a generation ID: raster devices don't bump one on every draw, and UIs that redraw
+// an unchanged background each frame would never hit. Comparing is far cheaper than filtering.
+struct SkCanvas::BackdropCache {
+    struct Key {
+        uint32_t    fFilterID;
+        bool        fLayerHasFilter;
+        SkMatrix    fLayerMatrix;
+        SkMatrix    fDeviceMatrix;
+        SkIRect     fLayerBounds;
+        SkImageInfo fLayerInfo;
+        SkIRect     fSourceBounds;  // The region of the prior device read by the filter.
+
+        bool operator==(const Key& that) const {
+            return fFilterID       == that.fFilterID
+                && fLayerHasFilter == that.fLayerHasFilter
+                && fLayerMatrix    == that.fLayerMatrix
+                && fDeviceMatrix   == that.fDeviceMatrix
+                && fLayerBounds    == that.fLayerBounds
+                && fLayerInfo      == that.fLayerInfo
+                && fSourceBounds   == that.fSourceBounds;
+        }
+    };
+
+    struct Entry {
+        Key      fKey;
+        SkBitmap fSource;    // The pixels in fSourceBounds when the backdrop was filtered.
+        SkBitmap fBackdrop;  // The new layer's pixels once the backdrop was drawn into it.
+    };
+
+    // Enough for a few backdrops per frame; the most recently used is last.
+    static constexpr size_t kMaxEntries = 4;
+    std::vector<Entry> fEntries;
+
+    static bool SamePixels(const SkPixmap& a, const SkBitmap& b) {
+        if (a.info() != b.info()) {
+            return false;
+        }
+        const size_t rowBytes = a.info().minRowBytes();
+        for (int y = 0; y < a.height(); ++y) {
+            if (0 != memcmp(a.addr(0, y), b.getAddr(0, y), rowBytes)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static SkBitmap Copy(const SkPixmap& pm) {
+        SkBitmap bm;
+        if (bm.tryAllocPixels(pm.info()) && pm.readPixels(bm.pixmap())) {
+            bm.setImmutable();
+        } else {
+            bm.reset();
+        }
+        return bm;
+    }
+
+    // Returns the backdrop for 'key' drawn from 'source', moving it to the back, or null.
+    const SkBitmap* find(const Key& key, const SkPixmap& source) {
+        for (auto entry = fEntries.begin(); entry != fEntries.end(); ++entry) {
+            if (entry->fKey == key && SamePixels(source, entry->fSource)) {
+                std::rotate(entry, entry + 1, fEntries.end());
+                return &fEntries.back().fBackdrop;
+            }
+        }
+        return nullptr;
+    }
+
+    void add(const Key& key, const SkPixmap& source, const SkPixmap& backdrop) {
+        Entry entry = {key, Copy(source), Copy(backdrop)};
+        if (entry.fSource.drawsNothing() || entry.fBackdrop.drawsNothing()) {
+            return;
+        }
+        // Whatever we had for this key was drawn from different pixels, so it's stale.
+        fEntries.erase(std::remove_if(fEntries.begin(), fEntries.end(),
+                                      [&](const Entry& e) { return e.fKey == key; }),
+                       fEntries.end());
+        if (fEntries.size() == kMaxEntries) {
+            fEntries.erase(fEntries.begin());
+        }
+        fEntries.push_back(std::move(entry));
+    }
+};
+
 SkCanvas::Layer::Layer(sk_sp<SkBaseDevice> device,
                        sk_sp<SkImageFilter> imageFilter,
                        const SkPaint& paint)
@@ -799,89 +887,121 @@ static bool draw_layer_as_sprite(const SkMatrix& matrix, const SkISize& size) {
     return SkTreatAsSprite(matrix, size, sampling, paint);
 }
 
-void SkCanvas::internalDrawDeviceWithFilter(SkBaseDevice* src,
-                                            SkBaseDevice* dst,
-                                            const SkImageFilter* filter,
-                                            const SkPaint& paint,
-                                            DeviceCompatibleWithFilter compat) {
-    check_drawdevice_colorspaces(dst->imageInfo().colorSpace(),
-                                 src->imageInfo().colorSpace());
+namespace {
 
-    // 'filter' sees the src device's buffer as the implicit input image, and processes the image
-    // in this device space (referred to as the "layer" space). However, the filter
-    // parameters need to respect the current matrix, which is not necessarily the local matrix that
-    // was set on 'src' (e.g. because we've popped src off the stack already).
-    // TODO (michaelludwig): Stay in SkM44 once skif::Mapping supports SkM44 instead of SkMatrix.
-    SkMatrix localToSrc = (src->globalToDevice() * fMCRec->fMatrix).asM33();
-    SkISize srcDims = src->imageInfo().dimensions();
+// How the contents of a src device are read to produce the input of a filter drawn into dst.
+struct FilterInputPlan {
+    skif::Mapping fMapping;
+    skif::LayerSpace<SkIRect> fRequiredInput;
+    // Whether src must first be transformed into an intermediate image, and with what transform
+    bool fNeedsIntermediateImage = false;
+    SkMatrix fSrcToIntermediate;
+    // The pixels of src that are read; may be empty, in which case nothing is drawn
+    SkIRect fSrcSubset = SkIRect::MakeEmpty();
+};
 
-    // Whether or not we need to make a transformed tmp image from 'src', and what that transform is
-    bool needsIntermediateImage = false;
-    SkMatrix srcToIntermediate;
+}  // namespace
 
-    skif::Mapping mapping;
-    skif::LayerSpace<SkIRect> requiredInput;
-    if (compat == DeviceCompatibleWithFilter::kYes) {
+// Returns false if 'filter' can't be drawn from 'src' into 'dst' at all. 'localToSrc' maps the
+// canvas' local coordinates to src's device space.
+static bool plan_filter_input(const SkBaseDevice* src, const SkBaseDevice* dst,
+                              const SkImageFilter* filter, const SkMatrix& localToSrc,
+                              bool compatible, FilterInputPlan* plan) {
+    const SkISize srcDims = src->imageInfo().dimensions();
+    if (compatible) {
         // Just use the relative transform from src to dst and the src's whole image, since
         // internalSaveLayer should have already determined what was necessary.
-        mapping = skif::Mapping(src->getRelativeTransform(*dst), localToSrc);
-        requiredInput = skif::LayerSpace<SkIRect>(SkIRect::MakeSize(srcDims));
-        SkASSERT(!requiredInput.isEmpty());
+        plan->fMapping = skif::Mapping(src->getRelativeTransform(*dst), localToSrc);
+        plan->fRequiredInput = skif::LayerSpace<SkIRect>(SkIRect::MakeSize(srcDims));
+        SkASSERT(!plan->fRequiredInput.isEmpty());
     } else {
         // Compute the image filter mapping by decomposing the local->device matrix of dst and
         // re-determining the required input.
-        std::tie(mapping, requiredInput) = get_layer_mapping_and_bounds(
+        std::tie(plan->fMapping, plan->fRequiredInput) = get_layer_mapping_and_bounds(
                 filter, dst->localToDevice(), skif::DeviceSpace<SkIRect>(dst->devClipBounds()));
-        if (requiredInput.isEmpty()) {
-            return;
+        if (plan->fRequiredInput.isEmpty()) {
+            return false;
         }
 
         // The above mapping transforms from local to dst's device space, where the layer space
         // represents the intermediate buffer. Now we need to determine the transform from src to
         // intermediate to prepare the input to the filter.
+        SkMatrix& srcToIntermediate = plan->fSrcToIntermediate;
         if (!localToSrc.invert(&srcToIntermediate)) {
-            return;
+            return false;
         }
-        srcToIntermediate.postConcat(mapping.layerMatrix());
+        srcToIntermediate.postConcat(plan->fMapping.layerMatrix());
         if (draw_layer_as_sprite(srcToIntermediate, srcDims)) {
             // src differs from intermediate by just an integer translation, so it can be applied
             // automatically when taking a subset of src if we update the mapping.
             skif::LayerSpace<SkIPoint> srcOrigin({(int) srcToIntermediate.getTranslateX(),
                                                   (int) srcToIntermediate.getTranslateY()});
-            mapping.applyOrigin(srcOrigin);
-            requiredInput.offset(-srcOrigin);
+            plan->fMapping.applyOrigin(srcOrigin);
+            plan->fRequiredInput.offset(-srcOrigin);
         } else {
             // The contents of 'src' will be drawn to an intermediate buffer using srcToIntermediate
             // and that buffer will be the input to the image filter.
-            needsIntermediateImage = true;
+            plan->fNeedsIntermediateImage = true;
+        }
+    }
+
+    SkIRect srcSubset;
+    if (!plan->fNeedsIntermediateImage) {
+        srcSubset = SkIRect(plan->fRequiredInput);
+    } else {
+        SkRect srcRect;
+        if (!SkMatrixPriv::InverseMapRect(plan->fSrcToIntermediate, &srcRect,
+                                          SkRect::Make(SkIRect(plan->fRequiredInput)))) {
+            return false;
         }
+        srcSubset = srcRect.roundOut();
     }
+    if (srcSubset.intersect(SkIRect::MakeSize(srcDims))) {
+        plan->fSrcSubset = srcSubset;
+    }
+    return true;
+}
+
+void SkCanvas::internalDrawDeviceWithFilter(SkBaseDevice* src,
+                                            SkBaseDevice* dst,
+                                            const SkImageFilter* filter,
+                                            const SkPaint& paint,
+                                            DeviceCompatibleWithFilter compat) {
+    check_drawdevice_colorspaces(dst->imageInfo().colorSpace(),
+                                 src->imageInfo().colorSpace());
+
+    // 'filter' sees the src device's buffer as the implicit input image, and processes the image
+    // in this device space (referred to as the "layer" space). However, the filter
+    // parameters need to respect the current matrix, which is not necessarily the local matrix that
+    // was set on 'src' (e.g. because we've popped src off the stack already).
+    // TODO (michaelludwig): Stay in SkM44 once skif::Mapping supports SkM44 instead of SkMatrix.
+    SkMatrix localToSrc = (src->globalToDevice() * fMCRec->fMatrix).asM33();
+
+    FilterInputPlan plan;
+    if (!plan_filter_input(src, dst, filter, localToSrc,
+                           compat == DeviceCompatibleWithFilter::kYes, &plan)) {
+        return;
+    }
+    skif::Mapping& mapping = plan.fMapping;
+    const skif::LayerSpace<SkIRect>& requiredInput = plan.fRequiredInput;
+    const SkIRect& srcSubset = plan.fSrcSubset;
 
     sk_sp<SkSpecialImage> filterInput;
-    if (!needsIntermediateImage) {
+    if (!plan.fNeedsIntermediateImage) {
         // The src device can be snapped directly
-        skif::LayerSpace<SkIRect> srcSubset(SkIRect::MakeSize(srcDims));
-        if (srcSubset.intersect(requiredInput)) {
-            filterInput = src->snapSpecial(SkIRect(srcSubset));
+        if (!srcSubset.isEmpty()) {
+            filterInput = src->snapSpecial(srcSubset);
 
             // TODO: For now image filter input images need to have a (0,0) origin. The required
             // input's top left has been baked into srcSubset so we use that as the image origin.
-            mapping.applyOrigin(srcSubset.topLeft());
+            mapping.applyOrigin(skif::LayerSpace<SkIPoint>(srcSubset.topLeft()));
         }
     } else {
         // We need to produce a temporary image that is equivalent to 'src' but transformed to
         // a coordinate space compatible with the image filter
         SkASSERT(compat == DeviceCompatibleWithFilter::kUnknown);
-        SkRect srcRect;
-        if (!SkMatrixPriv::InverseMapRect(srcToIntermediate, &srcRect,
-                                          SkRect::Make(SkIRect(requiredInput)))) {
-            return;
-        }
-
-        SkIRect srcSubset = srcRect.roundOut();
         sk_sp<SkSpecialImage> srcImage;
-        if (srcSubset.intersect(SkIRect::MakeSize(srcDims)) &&
-            (srcImage = src->snapSpecial(srcSubset))) {
+        if (!srcSubset.isEmpty() && (srcImage = src->snapSpecial(srcSubset))) {
             // Make a new surface and draw 'srcImage' into it with the srcToIntermediate transform
             // to produce the final input image for the filter
             SkBaseDevice::CreateInfo info(make_layer_info(src->imageInfo(), requiredInput.width(),
@@ -893,7 +1013,7 @@ void SkCanvas::internalDrawDeviceWithFilter(SkBaseDevice* src,
             if (!intermediateDevice) {
                 return;
             }
-            intermediateDevice->setOrigin(SkM44(srcToIntermediate),
+            intermediateDevice->setOrigin(SkM44(plan.fSrcToIntermediate),
                                           requiredInput.left(), requiredInput.top());
 
             SkMatrix offsetLocalToDevice = intermediateDevice->localToDevice();
@@ -1096,11 +1216,44 @@ void SkCanvas::internalSaveLayer(const SaveLayerRec& rec, SaveLayerStrategy stra
         // devices differ by integer translations and are always compatible.
         auto compat = (filter || backdropFilter) ? DeviceCompatibleWithFilter::kUnknown
                                                  : DeviceCompatibleWithFilter::kYes;
-        this->internalDrawDeviceWithFilter(priorDevice,     // src
-                                           newDevice.get(), // dst
-                                           backdropFilter,
-                                           backdropPaint,
-                                           compat);
+
+        // Only the part of the prior device that the backdrop filter reads is compared and kept.
+        SkPixmap priorPixels, sourcePixels, layerPixels;
+        FilterInputPlan plan;
+        const bool cacheBackdrop =
+                (rec.fSaveLayerFlags & kCacheBackdrop_SaveLayerFlag) &&
+                !(rec.fSaveLayerFlags & kMaskAgainstCoverage_EXPERIMENTAL_DONT_USE_SaveLayerFlag) &&
+                rec.fBackdrop &&
+                priorDevice->peekPixels(&priorPixels) &&
+                newDevice->accessPixels(&layerPixels) &&
+                plan_filter_input(priorDevice, newDevice.get(), backdropFilter,
+                                  (priorDevice->globalToDevice() * fMCRec->fMatrix).asM33(),
+                                  compat == DeviceCompatibleWithFilter::kYes, &plan) &&
+                priorPixels.extractSubset(&sourcePixels, plan.fSrcSubset);
+        BackdropCache::Key key;
+        const SkBitmap* cached = nullptr;
+        if (cacheBackdrop) {
+            key = {as_IFB(rec.fBackdrop)->uniqueID(), filter != nullptr,
+                   newLayerMapping.layerMatrix(), newLayerMapping.deviceMatrix(),
+                   SkIRect(layerBounds), layerPixels.info(), plan.fSrcSubset};
+            if (!fBackdropCache) {
+                fBackdropCache = std::make_unique<BackdropCache>();
+            }
+            cached = fBackdropCache->find(key, sourcePixels);
+        }
+
+        if (cached) {
+            SkAssertResult(cached->readPixels(layerPixels));
+        } else {
+            this->internalDrawDeviceWithFilter(priorDevice,     // src
+                                               newDevice.get(), // dst
+                                               backdropFilter,
+                                               backdropPaint,
+                                               compat);
+            if (cacheBackdrop) {
+                fBackdropCache->add(key, sourcePixels, layerPixels);
+            }
+        }
     }
 
     fMCRec->newLayer(std::move(newDevice), sk_ref_sp(filter), restorePaint);
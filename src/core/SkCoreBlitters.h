@@ -167,6 +167,11 @@ private:
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
                                          const SkMatrixProvider& matrixProvider, SkArenaAlloc*,
                                          sk_sp<SkShader> clipShader);
+// Like the above, but lets tests and benches choose whether blitAntiH() coalesces a scanline's
+// runs into coverage spans (as it always does otherwise) or draws them one at a time.
+SkBlitter* SkCreateRasterPipelineBlitterForTesting(const SkPixmap&, const SkPaint&,
+                                                   const SkMatrixProvider&, SkArenaAlloc*,
+                                                   bool coalesceAntiH);
 // Use this if you've pre-baked a shader pipeline, including modulating with paint alpha.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
                                          const SkRasterPipeline& shaderPipeline,
@@ -26,6 +26,7 @@
 #include "src/core/SkBlitter.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkDrawProcs.h"
+#include "src/core/SkMaskCache.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixUtils.h"
 #include "src/core/SkPathEffectBase.h"
@@ -38,6 +39,7 @@
 #include "src/core/SkTLazy.h"
 #include "src/core/SkUtils.h"
 
+#include <atomic>
 #include <utility>
 
 static SkPaint make_paint_with_image(const SkPaint& origPaint, const SkBitmap& bitmap,
@@ -871,6 +873,101 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     proc(devPath, *fRC, blitter);
 }
 
+// Opt-in: cache the coverage masks of paths the client keeps around, so redrawing one with the
+// same matrix is a blitMask() rather than another scan conversion.
+static std::atomic<bool> gCachePathCoverageMasks{false};
+
+bool SkDraw::SetPathCoverageMaskCacheEnabled(bool enabled) {
+    return gCachePathCoverageMasks.exchange(enabled);
+}
+
+// Renders path's coverage, as drawn with matrix and paint, into an A8 mask backed by cache data.
+// Returns nullptr if the mask would be empty, or too big to be worth caching.
+static SkCachedData* render_path_mask(const SkPath& path, const SkMatrix& matrix,
+                                      const SkPaint& paint, SkMask* mask) {
+    static constexpr size_t kMaxMaskBytes = 256 * 1024;
+
+    SkRect storage;
+    const SkRect& bounds = paint.computeFastBounds(path.getBounds(), &storage);
+    // Outset for anti-aliasing, and for hairlines and their caps.
+    mask->fBounds  = matrix.mapRect(bounds).makeOutset(2, 2).roundOut();
+    mask->fFormat  = SkMask::kA8_Format;
+    mask->fRowBytes = mask->fBounds.width();
+    const size_t size = mask->computeImageSize();
+    if (size == 0 || size > kMaxMaskBytes) {
+        return nullptr;
+    }
+    SkCachedData* data = SkResourceCache::NewCachedData(size);
+    if (!data) {
+        return nullptr;
+    }
+    mask->fImage = (uint8_t*)data->writable_data();
+    sk_bzero(mask->fImage, size);
+
+    SkDraw draw;
+    SkAssertResult(draw.fDst.reset(*mask));
+
+    SkRasterClip clip(SkIRect::MakeWH(mask->fBounds.width(), mask->fBounds.height()));
+    SkSimpleMatrixProvider matrixProvider(
+            SkMatrix::Translate(-mask->fBounds.fLeft, -mask->fBounds.fTop) * matrix);
+    draw.fRC             = &clip;
+    draw.fMatrixProvider = &matrixProvider;
+
+    SkPaint coverage;
+    coverage.setAntiAlias (paint.isAntiAlias());
+    coverage.setStyle     (paint.getStyle());
+    coverage.setStrokeWidth(paint.getStrokeWidth());
+    coverage.setStrokeMiter(paint.getStrokeMiter());
+    coverage.setStrokeCap (paint.getStrokeCap());
+    coverage.setStrokeJoin(paint.getStrokeJoin());
+
+    // A volatile copy (sharing path's points) keeps this draw from looking in the cache itself.
+    SkPath tmp(path);
+    tmp.setIsVolatile(true);
+    draw.drawPath(tmp, coverage);
+    return data;
+}
+
+bool SkDraw::drawCachedPathMask(const SkPath& path, const SkPaint& paint,
+                                const SkMatrix& ctm, SkResourceCache* localCache) const {
+    if (path.isVolatile() || path.isInverseFillType() || ctm.hasPerspective() ||
+        paint.getPathEffect() || paint.getMaskFilter()) {
+        return false;
+    }
+
+    // We bake only the subpixel part of the translation into the mask, snapped to quarter
+    // pixels, and apply the whole pixels when we blit it.
+    static constexpr SkScalar kSubpixelSteps = 4,
+                              kMaxTranslate  = 1 << 20;
+    const SkScalar tx = ctm.getTranslateX(),
+                   ty = ctm.getTranslateY();
+    if (!(SkScalarAbs(tx) < kMaxTranslate && SkScalarAbs(ty) < kMaxTranslate)) {
+        return false;
+    }
+    const SkScalar snappedX = SkScalarRoundToScalar(tx * kSubpixelSteps) / kSubpixelSteps,
+                   snappedY = SkScalarRoundToScalar(ty * kSubpixelSteps) / kSubpixelSteps;
+    const int wholeX = SkScalarFloorToInt(snappedX),
+              wholeY = SkScalarFloorToInt(snappedY);
+
+    SkMatrix matrix = ctm;
+    matrix.setTranslateX(snappedX - wholeX);
+    matrix.setTranslateY(snappedY - wholeY);
+
+    SkMask mask;
+    sk_sp<SkCachedData> data(SkMaskCache::FindAndRef(path, matrix, paint, &mask, localCache));
+    if (!data) {
+        data.reset(render_path_mask(path, matrix, paint, &mask));
+        if (!data) {
+            return false;
+        }
+        SkMaskCache::Add(path, matrix, paint, mask, data.get(), localCache);
+    }
+
+    mask.fBounds.offset(wholeX, wholeY);
+    this->drawDevMask(mask, paint);
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -931,6 +1028,11 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    if (gCachePathCoverageMasks && !pathIsMutable && !drawCoverage && !customBlitter &&
+        this->drawCachedPathMask(*pathPtr, *paint, matrixProvider->localToDevice())) {
+        return;
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = nullptr;
@@ -26,6 +26,7 @@ class SkMatrixProvider;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
+class SkResourceCache;
 struct SkRect;
 class SkRRect;
 class SkVertices;
@@ -122,6 +123,16 @@ public:
     static RectType ComputeRectType(const SkRect&, const SkPaint&, const SkMatrix&,
                                     SkPoint* strokeSize);
 
+    // Turns on or off caching the coverage masks of paths drawn by drawPath(), returning the
+    // previous setting.  See SkGraphics::SetPathCoverageMaskCacheEnabled().
+    static bool SetPathCoverageMaskCacheEnabled(bool);
+
+    // Draws path by blitting its coverage mask, from the cache or rendered and added to it.
+    // Returns false if path's coverage can't be cached.  drawPath() uses the global
+    // SkResourceCache; tests may pass their own.
+    bool drawCachedPathMask(const SkPath& path, const SkPaint&, const SkMatrix&,
+                            SkResourceCache* localCache = nullptr) const;
+
 private:
     void drawBitmapAsMask(const SkBitmap&, const SkSamplingOptions&, const SkPaint&) const;
     void drawFixedVertices(const SkVertices* vertices,
@@ -17,15 +17,20 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTime.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkBlitterStats.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkDraw.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkScalerContext.h"
+#include "src/core/SkScan.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
+#include "src/core/SkVMBlitter.h"
+#include "src/shaders/SkPerlinNoiseShaderPriv.h"
 
 #include <stdlib.h>
 
@@ -40,12 +45,15 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkVMBlitter::DumpProgramCacheStatistics(dump);
+  SkBlitterStats::Dump(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkGraphics::PurgeVMProgramCache();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -125,6 +133,51 @@ void SkGraphics::PurgeFontCache() {
     SkTypefaceCache::PurgeAll();
 }
 
+int SkGraphics::GetVMProgramCacheCountUsed() {
+    return SkVMBlitter::GetProgramCacheCountUsed();
+}
+
+int SkGraphics::GetVMProgramCacheCountLimit() {
+    return SkVMBlitter::GetProgramCacheCountLimit();
+}
+
+int SkGraphics::SetVMProgramCacheCountLimit(int count) {
+    return SkVMBlitter::SetProgramCacheCountLimit(count);
+}
+
+void SkGraphics::PurgeVMProgramCache() {
+    SkVMBlitter::PurgeProgramCache();
+}
+
+SkGraphics::VMProgramPersistentCache* SkGraphics::SetVMProgramPersistentCache(
+        VMProgramPersistentCache* cache) {
+    return SkVMBlitter::SetProgramPersistentCache(cache);
+}
+
+bool SkGraphics::SetPathCoverageMaskCacheEnabled(bool enabled) {
+    return SkDraw::SetPathCoverageMaskCacheEnabled(enabled);
+}
+
+bool SkGraphics::SetPerlinNoiseTileCacheEnabled(bool enabled) {
+    return SkPerlinNoiseShaderPriv::SetTileCacheEnabled(enabled);
+}
+
+SkExecutor* SkGraphics::SetParallelPathFillExecutor(SkExecutor* executor, int maxThreads) {
+    return SkScan::SetParallelFillExecutor(executor, maxThreads);
+}
+
+bool SkGraphics::SetBlitterStatisticsEnabled(bool enabled) {
+    return SkBlitterStats::SetEnabled(enabled);
+}
+
+void SkGraphics::ResetBlitterStatistics() {
+    SkBlitterStats::Reset();
+}
+
+void SkGraphics::TraceBlitterStatistics() {
+    SkBlitterStats::Trace();
+}
+
 extern bool gSkVMAllowJIT;
 
 void SkGraphics::AllowJIT() {
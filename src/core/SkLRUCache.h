@@ -76,10 +76,22 @@ public:
         }
     }
 
-    int count() {
+    int count() const {
         return fMap.count();
     }
 
+    int maxCount() const {
+        return fMaxCount;
+    }
+
+    /** Changes the capacity, evicting least recently used entries if over the new limit. */
+    void setMaxCount(int maxCount) {
+        fMaxCount = maxCount;
+        while (fMap.count() > fMaxCount) {
+            this->remove(fLRU.tail()->fKey);
+        }
+    }
+
     template <typename Fn>  // f(K*, V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
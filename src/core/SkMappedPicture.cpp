@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkMappedPicture.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkVertices.h"
+#include "src/core/SkPictureData.h"
+#include "src/core/SkPicturePlayback.h"
+#include "src/core/SkReadBuffer.h"
+
+// Counts the ops in the stream by their sizes, without decoding any of them.
+static int count_ops(const SkData& opData) {
+    SkReadBuffer reader(opData.data(), opData.size());
+    int count = 0;
+    while (!reader.eof() && reader.isValid()) {
+        const size_t offset = reader.offset();
+        uint32_t bits = reader.readInt(),
+                 size = bits & 0xffffff;
+        if (size == 0xffffff) {
+            // SkPictureRecord::addDraw() only adds 1 to the size for the extra size word.
+            size = reader.readInt() + 3;
+        }
+        if (!reader.validate(size >= reader.offset() - offset)) {
+            break;
+        }
+        reader.skip(offset + size - reader.offset());
+        count++;
+    }
+    return count;
+}
+
+SkMappedPicture::SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData> data)
+    : fCullRect(cull)
+    , fData(std::move(data))
+    , fOpCount(count_ops(*fData->opData())) {}
+
+SkMappedPicture::~SkMappedPicture() = default;
+
+void SkMappedPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    SkPicturePlayback playback(fData.get());
+
+    // As SkBigPicture does, only use the index if the query doesn't hold the whole picture.
+    const int count = fData->opIndexCount();
+    if (count == 0 || canvas->getLocalClipBounds().contains(fCullRect)) {
+        playback.draw(canvas, callback, nullptr);
+        return;
+    }
+
+    fBBHOnce([&] {
+        fBBH = SkRTreeFactory()();
+        fBBH->insert(fData->opIndexBounds(), count);
+    });
+    std::vector<int> ops;
+    fBBH->search(canvas->getLocalClipBounds(), &ops);
+    playback.drawIndexed(canvas, callback, ops);
+}
+
+int SkMappedPicture::approximateOpCount(bool nested) const {
+    int count = fOpCount;
+    if (nested) {
+        for (const auto& pic : fData->pictures()) {
+            count += pic->approximateOpCount(true);
+        }
+    }
+    return count;
+}
+
+size_t SkMappedPicture::approximateBytesUsed() const {
+    // This grows as paints, paths and images are decoded by playback.
+    return sizeof(*this) + fData->approximateBytesUsed();
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMappedPicture_DEFINED
+#define SkMappedPicture_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/private/SkOnce.h"
+
+#include <memory>
+
+class SkBBoxHierarchy;
+class SkPictureData;
+
+// An SkPicture played back straight from its serialized SkPictureData, rather than re-recorded
+// into an SkRecord like SkPicture::MakeFromData() does.  See SkPicture::MakeFromDataWithoutCopy().
+// If the data has an op index, playback into a clip that doesn't hold the whole picture only
+// reads, and decodes the paints, paths and images of, the ops that the clip touches.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData>);
+    ~SkMappedPicture() override;
+
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    int approximateOpCount(bool nested) const override;
+    size_t approximateBytesUsed() const override;
+
+private:
+    const SkRect                         fCullRect;
+    std::unique_ptr<const SkPictureData> fData;
+    int                                  fOpCount;
+
+    // Built from the op index the first time only part of the picture is drawn.
+    mutable SkOnce                       fBBHOnce;
+    mutable sk_sp<SkBBoxHierarchy>       fBBH;
+};
+
+#endif//SkMappedPicture_DEFINED
@@ -15,6 +15,7 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkOpts.h"
 
 #include <cmath>
 #include <climits>
@@ -90,6 +91,18 @@ public:
 
     int    border()     const { return fBorder; }
 
+    // A window of one has empty passes, which only the scalar Scan handles.
+    bool canBlurRows() const { return fPass0Size > 0 && fPass1Size > 0 && fPass2Size > 0; }
+
+    // Blur rows of A8 pixels with SkOpts::mask_blur_rows, writing row y as column y of dst.
+    void blurRows(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                  uint8_t* dst, size_t dstRB, int dstW) const {
+        const int passes[3] = {fPass0Size, fPass1Size, fPass2Size};
+        int noChangeCount = fSlidingWindow > srcW ? fSlidingWindow - srcW : 0;
+        SkOpts::mask_blur_rows(src, srcRB, srcW, rows, dst, dstRB, dstW,
+                               passes, fWeight, noChangeCount);
+    }
+
 public:
     class Scan {
     public:
@@ -955,7 +968,15 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+    return this->blur(src, dst, /*useBlurRows=*/true);
+}
 
+SkIPoint SkMaskBlurFilter::blurForTesting(const SkMask& src, SkMask* dst,
+                                          bool useBlurRows) const {
+    return this->blur(src, dst, useBlurRows);
+}
+
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst, bool useBlurRows) const {
     if (fSigmaW < 2.0 && fSigmaH < 2.0) {
         return small_blur(fSigmaW, fSigmaH, src, dst);
     }
@@ -1011,6 +1032,10 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
             }
         } break;
         case SkMask::kA8_Format: {
+            if (useBlurRows && planW.canBlurRows()) {
+                planW.blurRows(src.fImage, src.fRowBytes, srcW, srcH, tmp, tmpW, tmpH);
+                break;
+            }
             const uint8_t* a8Start = src.fImage;
             auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
             auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
@@ -1043,6 +1068,10 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
+    if (useBlurRows && planH.canBlurRows()) {
+        planH.blurRows(tmp, tmpW, tmpW, tmpH, dst->fImage, dst->fRowBytes, dstH);
+        return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+    }
     const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
     for (int y = 0; y < tmpH; y++) {
         auto tmpStart = &tmp[y * tmpW];
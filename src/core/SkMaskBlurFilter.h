@@ -29,7 +29,13 @@ public:
     // Given a src SkMask, generate dst SkMask returning the border width and height.
     SkIPoint blur(const SkMask& src, SkMask* dst) const;
 
+    // Like blur(), but if useBlurRows is false, A8 masks are always blurred one row at a time
+    // instead of several rows at once with SkOpts::mask_blur_rows. Both give identical masks.
+    SkIPoint blurForTesting(const SkMask& src, SkMask* dst, bool useBlurRows) const;
+
 private:
+    SkIPoint blur(const SkMask& src, SkMask* dst, bool useBlurRows) const;
+
     const double fSigmaW;
     const double fSigmaH;
 };
@@ -183,3 +183,91 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
     RectsBlurKey key(sigma, style, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathCoverageKeyNamespaceLabel;
+
+struct PathCoverageKey : public SkResourceCache::Key {
+public:
+    PathCoverageKey(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint)
+        : fFlags((uint32_t)path.getFillType()       << 0 |
+                 (uint32_t)paint.isAntiAlias()      << 2 |
+                 (uint32_t)paint.getStyle()         << 3 |
+                 (uint32_t)paint.getStrokeCap()     << 5 |
+                 (uint32_t)paint.getStrokeJoin()    << 7)
+        , fStrokeWidth(paint.getStrokeWidth())
+        , fStrokeMiter(paint.getStrokeMiter())
+        , fMatrix{matrix.getScaleX(), matrix.getSkewX(),  matrix.getTranslateX(),
+                  matrix.getSkewY(),  matrix.getScaleY(), matrix.getTranslateY()}
+    {
+        SkASSERT(!matrix.hasPerspective());
+        this->init(&gPathCoverageKeyNamespaceLabel, path.getGenerationID(),
+                   sizeof(fFlags) + sizeof(fStrokeWidth) + sizeof(fStrokeMiter) +
+                   sizeof(fMatrix));
+    }
+
+    uint32_t fFlags;
+    SkScalar fStrokeWidth;
+    SkScalar fStrokeMiter;
+    SkScalar fMatrix[6];
+};
+
+struct PathCoverageRec : public SkResourceCache::Rec {
+    PathCoverageRec(PathCoverageKey key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathCoverageRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathCoverageKey fKey;
+    MaskValue       fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-coverage"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathCoverageRec& rec = static_cast<const PathCoverageRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                      const SkPaint& paint, SkMask* mask,
+                                      SkResourceCache* localCache) {
+    MaskValue result;
+    PathCoverageKey key(path, matrix, paint);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathCoverageRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    *mask = result.fMask;
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                      const SkMask& mask, SkCachedData* data, SkResourceCache* localCache) {
+    PathCoverageKey key(path, matrix, paint);
+    return CHECK_LOCAL(localCache, add, Add, new PathCoverageRec(key, mask, data));
+}
@@ -9,6 +9,9 @@
 #define SkMaskCache_DEFINED
 
 #include "include/core/SkBlurTypes.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "src/core/SkCachedData.h"
@@ -39,6 +42,17 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     * Coverage masks of paths, keyed by the path's generation ID and fill type, the matrix it's
+     * drawn with, and the paint's anti-aliasing and stroke parameters.
+     */
+    static SkCachedData* FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                    const SkPaint& paint, SkMask* mask,
+                                    SkResourceCache* localCache = nullptr);
+    static void Add(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                    const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
 };
 
 #endif
@@ -43,6 +43,7 @@
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
 #include "src/opts/SkChecksum_opts.h"
+#include "src/opts/SkMaskBlurFilter_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -83,6 +84,8 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(cubic_solver);
 
+    DEFINE_DEFAULT(mask_blur_rows);
+
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
@@ -105,6 +108,18 @@ namespace SkOpts {
         = SK_OPTS_NS::lowp::start_pipeline;
 #undef M
 
+#define M(name, ...) SK_OPTS_NS::fused::name,
+    void (*fused_highp[])(size_t,size_t,size_t,size_t,void**) = {
+        SK_RASTER_PIPELINE_FUSED_HIGHP(M)
+    };
+#undef M
+
+#define M(name, ...) SK_OPTS_NS::lowp::fused::name,
+    void (*fused_lowp[])(size_t,size_t,size_t,size_t,void**) = {
+        SK_RASTER_PIPELINE_FUSED_LOWP(M)
+    };
+#undef M
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_ssse3();
     void Init_sse42();
@@ -56,6 +56,12 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // Blurs rows of an A8 image with SkMaskBlurFilter's three sliding box filters of sizes
+    // passes[] and 32.32 fixed point weight, writing blurred row y as column y of dst.
+    extern void (*mask_blur_rows)(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                                  uint8_t* dst, size_t dstRB, int dstW,
+                                  const int passes[3], uint64_t weight, int noChangeCount);
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
@@ -77,6 +83,14 @@ namespace SkOpts {
     extern void (*start_pipeline_lowp )(size_t,size_t,size_t,size_t, void**);
 #undef M
 
+#define M(name, ...) +1
+    // Fused pipelines, in SK_RASTER_PIPELINE_FUSED_{HIGHP,LOWP} order.  Lowp ones may be null.
+    extern void (*fused_highp[SK_RASTER_PIPELINE_FUSED_HIGHP(M)])(size_t,size_t,size_t,size_t,
+                                                                  void**);
+    extern void (*fused_lowp [SK_RASTER_PIPELINE_FUSED_LOWP (M)])(size_t,size_t,size_t,size_t,
+                                                                  void**);
+#undef M
+
     extern void (*interpret_skvm)(const skvm::InterpreterInstruction insts[], int ninsts,
                                   int nregs, int loop, const int strides[], int nargs,
                                   int n, void* args[]);
@@ -7,17 +7,21 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBBHFactory.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkMappedPicture.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkResourceCache.h"
 #include <atomic>
 
@@ -131,7 +135,10 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    // Keep pictures that were recorded with a BBH that way, as their op index shows they were.
+    SkRTreeFactory factory;
+    SkCanvas* canvas = r.beginRecording(info.fCullRect, data->opIndexCount() ? &factory : nullptr);
+    playback.draw(canvas, nullptr/*no callback*/, buffer);
     return r.finishRecordingAsPicture();
 }
 
@@ -156,8 +163,28 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
     return MakeFromStream(&stream, procs, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialProcs* procs,
+                                         SkExecutor* executor) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data->data(), data->size());
+    return MakeFromStream(&stream, procs, nullptr, nullptr, executor);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromDataWithoutCopy(sk_sp<SkData> data,
+                                                    const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    return MakeFromStream(&stream, procs, nullptr, std::move(data));
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           sk_sp<SkData> source,
+                                           SkExecutor* executor) {
     SkPictInfo info;
     if (!StreamIsSKP(stream, &info)) {
         return nullptr;
@@ -172,8 +199,16 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     if (!stream->readU8(&trailingStreamByteAfterPictInfo)) { return nullptr; }
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
-            std::unique_ptr<SkPictureData> data(
-                    SkPictureData::CreateFromStream(stream, info, procs, typefaces));
+            if (source) {
+                std::unique_ptr<SkPictureData> data(SkPictureData::CreateFromStream(
+                        stream, info, procs, typefaces, std::move(source)));
+                if (!data || !data->opData()) {
+                    return nullptr;
+                }
+                return sk_make_sp<SkMappedPicture>(info.fCullRect, std::move(data));
+            }
+            std::unique_ptr<SkPictureData> data(SkPictureData::CreateFromStream(
+                    stream, info, procs, typefaces, nullptr, executor));
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -217,13 +252,40 @@ sk_sp<SkPicture> SkPicturePriv::MakeFromBuffer(SkReadBuffer& buffer) {
     return SkPicture::Forwardport(info, data.get(), &buffer);
 }
 
-SkPictureData* SkPicture::backport() const {
+// Plays picture into rec as playback() would, returning its op index: where each of its ops was
+// written in rec's op data, and their bounds, laid out as SK_PICT_OP_INDEX_TAG describes.
+static sk_sp<SkData> playback_indexed(const SkBigPicture& picture, SkPictureRecord* rec) {
+    const int count = picture.record()->count();
+    const size_t offsetsSize = (count + 1) * sizeof(uint32_t);
+    sk_sp<SkData> index = SkData::MakeUninitialized(offsetsSize + count * sizeof(SkRect));
+    uint32_t* offsets = static_cast<uint32_t*>(index->writable_data());
+    SkRect* bounds = SkTAddOffset<SkRect>(offsets, offsetsSize);
+    SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(count);
+    SkRecordFillBounds(picture.cullRect(), *picture.record(), bounds, meta);
+
+    rec->save();
+        offsets[0] = SkToU32(rec->writeStream().bytesWritten());
+        picture.playbackEachOp(rec, [&](int i) {
+            offsets[i + 1] = SkToU32(rec->writeStream().bytesWritten());
+        });
+    rec->restore();
+    return index;
+}
+
+SkPictureData* SkPicture::backport(bool withOpIndex) const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(info.fCullRect.roundOut(), 0/*flags*/);
+    sk_sp<SkData> opIndex;
     rec.beginRecording();
-        this->playback(&rec);
+        // Pictures recorded with a BBH can keep one when they're serialized, as an op index.
+        const SkBigPicture* big = this->asSkBigPicture();
+        if (withOpIndex && big && big->bbh()) {
+            opIndex = playback_indexed(*big, &rec);
+        } else {
+            this->playback(&rec);
+        }
     rec.endRecording();
-    return new SkPictureData(rec, info);
+    return new SkPictureData(rec, info, std::move(opIndex));
 }
 
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procs) const {
@@ -286,7 +348,7 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
         return;
     }
 
-    std::unique_ptr<SkPictureData> data(this->backport());
+    std::unique_ptr<SkPictureData> data(this->backport(procs.fWritePictureOpIndex));
     if (data) {
         stream->write8(kPictureData_TrailingStreamByteAfterPictInfo);
         data->serialize(stream, procs, typefaceSet, textBlobsOnly);
@@ -7,6 +7,7 @@
 
 #include "src/core/SkPictureData.h"
 
+#include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/SkTo.h"
@@ -14,10 +15,14 @@
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSafeMath.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "src/core/SkVerticesPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <new>
 
 template <typename T> int SafeCount(const T* obj) {
@@ -35,7 +40,8 @@ void SkPictureData::initForPlayback() const {
 }
 
 SkPictureData::SkPictureData(const SkPictureRecord& record,
-                             const SkPictInfo& info)
+                             const SkPictInfo& info,
+                             sk_sp<SkData> opIndex)
     : fPictures(record.getPictures())
     , fDrawables(record.getDrawables())
     , fTextBlobs(record.getTextBlobs())
@@ -54,9 +60,42 @@ SkPictureData::SkPictureData(const SkPictureRecord& record,
         fPaths[n-1] = path;
     });
 
+    if (opIndex) {
+        const size_t count = (opIndex->size() - sizeof(uint32_t)) /
+                             (sizeof(uint32_t) + sizeof(SkRect));
+        SkAssertResult(this->setOpIndex(std::move(opIndex), SkToU32(count)));
+    }
+
     this->initForPlayback();
 }
 
+bool SkPictureData::setOpIndex(sk_sp<SkData> opIndex, uint32_t count) {
+    SkSafeMath safe;
+    const size_t offsetsSize = safe.mul(safe.add(count, 1), sizeof(uint32_t));
+    const size_t size = safe.add(offsetsSize, safe.mul(count, sizeof(SkRect)));
+    if (!safe || !SkTFitsIn<int>(count) || !fOpData || !opIndex || opIndex->size() != size) {
+        return false;
+    }
+
+    // Each op must lie within the op data, after the one before it.
+    const uint32_t* offsets = static_cast<const uint32_t*>(opIndex->data());
+    const SkRect* bounds = SkTAddOffset<const SkRect>(offsets, offsetsSize);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!SkIsAlign4(offsets[i]) || offsets[i] > offsets[i + 1] || !bounds[i].isFinite()) {
+            return false;
+        }
+    }
+    if (offsets[count] > fOpData->size()) {
+        return false;
+    }
+
+    fOpIndex        = std::move(opIndex);
+    fOpIndexCount   = SkToInt(count);
+    fOpIndexOffsets = offsets;
+    fOpIndexBounds  = bounds;
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -140,6 +179,26 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
     }
 }
 
+static void write_text_blobs(SkWriteBuffer& buffer,
+                             const SkTArray<sk_sp<const SkTextBlob>>& textBlobs) {
+    if (!textBlobs.empty()) {
+        write_tag_size(buffer, SK_PICT_TEXTBLOB_BUFFER_TAG, textBlobs.count());
+        for (const auto& blob : textBlobs) {
+            SkTextBlobPriv::Flatten(*blob, buffer);
+        }
+    }
+}
+
+static void write_vertices(SkWriteBuffer& buffer,
+                           const SkTArray<sk_sp<const SkVertices>>& vertices) {
+    if (!vertices.empty()) {
+        write_tag_size(buffer, SK_PICT_VERTICES_BUFFER_TAG, vertices.count());
+        for (const auto& vert : vertices) {
+            vert->priv().encode(buffer);
+        }
+    }
+}
+
 void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) const {
     if (!textBlobsOnly) {
         int numPaints = fPaints.count();
@@ -160,20 +219,10 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) c
         }
     }
 
-    if (!fTextBlobs.empty()) {
-        write_tag_size(buffer, SK_PICT_TEXTBLOB_BUFFER_TAG, fTextBlobs.count());
-        for (const auto& blob : fTextBlobs) {
-            SkTextBlobPriv::Flatten(*blob, buffer);
-        }
-    }
+    write_text_blobs(buffer, fTextBlobs);
 
     if (!textBlobsOnly) {
-        if (!fVertices.empty()) {
-            write_tag_size(buffer, SK_PICT_VERTICES_BUFFER_TAG, fVertices.count());
-            for (const auto& vert : fVertices) {
-                vert->priv().encode(buffer);
-            }
-        }
+        write_vertices(buffer, fVertices);
 
         if (!fImages.empty()) {
             write_tag_size(buffer, SK_PICT_IMAGE_BUFFER_TAG, fImages.count());
@@ -184,6 +233,59 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) c
     }
 }
 
+// Writes array as an indexed array (see SK_PICT_INDEXED_PAINT_BUFFER_TAG), filling in each
+// offset once the item before it has been written.
+template <typename T, typename WriteFn>
+static void write_indexed(SkBinaryWriteBuffer& buffer, uint32_t tag, const SkTArray<T>& array,
+                          WriteFn&& write) {
+    const int count = array.count();
+    if (count == 0) {
+        return;
+    }
+    write_tag_size(buffer, tag, count);
+
+    const size_t offsets = buffer.bytesWritten();
+    for (int i = 0; i <= count; i++) {
+        buffer.writeUInt(0);
+    }
+    const size_t items = buffer.bytesWritten();
+    for (int i = 0; i < count; i++) {
+        write(array[i]);
+        buffer.overwriteUIntAt(offsets + (i + 1) * sizeof(uint32_t),
+                               SkToU32(buffer.bytesWritten() - items));
+    }
+}
+
+// The stream format indexes the paints, paths and images, so that a picture played back in place
+// (see CreateFromStream()) only has to decode the ones it actually draws.
+void SkPictureData::flattenIndexedToBuffer(SkBinaryWriteBuffer& buffer, bool textBlobsOnly) const {
+    if (!textBlobsOnly) {
+        write_indexed(buffer, SK_PICT_INDEXED_PAINT_BUFFER_TAG, fPaints,
+                      [&](const SkPaint& paint) { buffer.writePaint(paint); });
+        write_indexed(buffer, SK_PICT_INDEXED_PATH_BUFFER_TAG, fPaths,
+                      [&](const SkPath& path) { buffer.writePath(path); });
+    }
+
+    write_text_blobs(buffer, fTextBlobs);
+
+    if (!textBlobsOnly) {
+        write_vertices(buffer, fVertices);
+        write_indexed(buffer, SK_PICT_INDEXED_IMAGE_BUFFER_TAG, fImages,
+                      [&](const sk_sp<const SkImage>& img) { buffer.writeImage(img.get()); });
+    }
+}
+
+// Pads the stream so that the data of the tag written next starts 4-byte aligned, as
+// SkReadBuffer needs it to be to read it in place.
+static void write_pad_tag(SkWStream* stream) {
+    const size_t written = stream->bytesWritten();
+    if (size_t pad = SkAlign4(written) - written) {
+        write_tag_size(stream, SK_PICT_PAD_TAG, pad);
+        const uint32_t zero = 0;
+        stream->write(&zero, pad);
+    }
+}
+
 // SkPictureData::serialize() will write out paints, and then write out an array of typefaces
 // (unique set). However, paint's serializer will respect SerialProcs, which can cause us to
 // call that custom typefaceproc on *every* typeface, not just on the unique ones. To avoid this,
@@ -204,8 +306,13 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet, bool textBlobsOnly) const {
     // This can happen at pretty much any time, so might as well do it first.
+    write_pad_tag(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
+    if (fOpIndex) {
+        write_tag_size(stream, SK_PICT_OP_INDEX_TAG, fOpIndexCount);
+        stream->write(fOpIndex->data(), fOpIndex->size());
+    }
 
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
@@ -218,7 +325,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     buffer.setFactoryRecorder(sk_ref_sp(&factSet));
     buffer.setSerialProcs(skip_typeface_proc(procs));
     buffer.setTypefaceRecorder(sk_ref_sp(typefaceSet));
-    this->flattenToBuffer(buffer, textBlobsOnly);
+    this->flattenIndexedToBuffer(buffer, textBlobsOnly);
 
     // Pretend to serialize our sub-pictures for the side effect of filling typefaceSet
     // with typefaces from sub-pictures.
@@ -242,6 +349,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     WriteTypefaces(stream, *typefaceSet, procs);
 
     // Write the buffer.
+    write_pad_tag(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -281,6 +389,19 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the next size bytes of stream, which is reading source. They're left in place when
+// they're 4-byte aligned, as SkReadBuffer needs them to be, and copied otherwise.
+static sk_sp<SkData> read_in_place(const sk_sp<SkData>& source, SkStream* stream, size_t size) {
+    const size_t offset = stream->getPosition();
+    if (offset > source->size() || !SkIsAlign4((uintptr_t)source->bytes() + offset)) {
+        return SkData::MakeFromStream(stream, size);
+    }
+    if (stream->skip(size) != size) {
+        return nullptr;
+    }
+    return SkData::MakeSubset(source.get(), offset, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -289,11 +410,30 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = fSource ? read_in_place(fSource, stream, size)
+                              : SkData::MakeFromStream(stream, size);
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_OP_INDEX_TAG: {
+            SkSafeMath safe;
+            const size_t bytes = safe.add(safe.mul(safe.add(size, 1), sizeof(uint32_t)),
+                                          safe.mul(size, sizeof(SkRect)));
+            if (!safe || fOpIndex) {
+                return false;
+            }
+            sk_sp<SkData> opIndex = fSource ? read_in_place(fSource, stream, bytes)
+                                            : SkData::MakeFromStream(stream, bytes);
+            if (!this->setOpIndex(std::move(opIndex), size)) {
+                return false;
+            }
+        } break;
+        case SK_PICT_PAD_TAG:
+            if (size > 3 || stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
             fFactoryPlayback = std::make_unique<SkFactoryPlayback>(size);
@@ -330,7 +470,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve_back(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback,
+                                                     fSource, fExecutor);
                 if (!pic) {
                     return false;
                 }
@@ -338,12 +479,24 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* arrays;
+            if (fSource) {
+                // Indexed arrays will be decoded from here later, so we have to keep it.
+                fArrays = read_in_place(fSource, stream, size);
+                if (!fArrays) {
+                    return false;
+                }
+                arrays = fArrays->data();
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                arrays = storage.get();
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(arrays, size);
             buffer.setVersion(fInfo.getVersion());
 
             if (!fFactoryPlayback) {
@@ -352,6 +505,15 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fFactoryPlayback->setupBuffer(buffer);
             buffer.setDeserialProcs(procs);
 
+            if ((fSource || fExecutor) && fTFPlayback.count() == 0 &&
+                topLevelTFPlayback != &fTFPlayback) {
+                // Items are decoded with setupItemBuffer(), which uses our own typefaces, and
+                // decoding lazily may happen after the top picture is gone, so take our own refs.
+                fTFPlayback.setCount(topLevelTFPlayback->count());
+                for (size_t i = 0; i < fTFPlayback.count(); i++) {
+                    fTFPlayback[i] = (*topLevelTFPlayback)[i];
+                }
+            }
             if (fTFPlayback.count() > 0) {
                 // .skp files <= v43 have typefaces serialized with each sub picture.
                 fTFPlayback.setupBuffer(buffer);
@@ -406,8 +568,97 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Reads an indexed array, either now, or when lazy is not null, just far enough to find its
+// items later.
+template <typename T, typename ReadFn>
+void SkPictureData::parseIndexedArray(SkReadBuffer& buffer, uint32_t inCount, SkTArray<T>* array,
+                                      LazyIndex* lazy, ReadFn read) {
+    if (!buffer.validate(array->empty() && inCount < SK_MaxS32)) {
+        return;
+    }
+    const int count = SkToInt(inCount);
+    const uint32_t* offsets = buffer.skipT<uint32_t>(count + 1);
+    if (!buffer.validate(offsets && offsets[0] == 0)) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!buffer.validate(offsets[i] <= offsets[i + 1] && SkIsAlign4(offsets[i + 1]))) {
+            return;
+        }
+    }
+
+    if (lazy) {
+        lazy->fOffsets = offsets;
+        lazy->fItems   = static_cast<const char*>(buffer.skip(offsets[count]));
+        if (buffer.isValid()) {
+            lazy->fOnce.reset(new SkOnce[count]);
+            lazy->fFailed.reset(new bool[count]());
+            array->push_back_n(count);
+        }
+        return;
+    }
+
+    if (fExecutor && count > 1) {
+        LazyIndex index;
+        index.fOffsets = offsets;
+        index.fItems   = static_cast<const char*>(buffer.skip(offsets[count]));
+        if (!buffer.isValid()) {
+            return;
+        }
+        array->push_back_n(count);
+
+        // Give each task a run of items, enough to keep every thread busy even if some of the
+        // items (e.g. images) take far longer to decode than others.
+        static constexpr int kMaxTasks = 64;
+        const int tasks = std::min(count, kMaxTasks);
+        std::atomic<bool> valid{true};
+        SkTaskGroup group(*fExecutor);
+        group.batch(tasks, [&](int task) {
+            SkReadBuffer item;
+            for (int i = task * count / tasks; i < (task + 1) * count / tasks; i++) {
+                this->setupItemBuffer(index, i, &item);
+                read(item, &(*array)[i]);
+                if (!item.isValid() || !item.eof()) {
+                    valid.store(false, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        group.wait();
+        buffer.validate(valid.load());
+        return;
+    }
+
+    const size_t items = buffer.offset();
+    array->reserve_back(count);
+    for (int i = 0; i < count; i++) {
+        read(buffer, &array->push_back());
+        if (!buffer.validate(buffer.offset() == items + offsets[i + 1])) {
+            return;
+        }
+    }
+}
+
 void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
     switch (tag) {
+        case SK_PICT_INDEXED_PAINT_BUFFER_TAG:
+            this->parseIndexedArray(buffer, size, &fPaints, fArrays ? &fLazyPaints : nullptr,
+                                    [](SkReadBuffer& buffer, SkPaint* paint) {
+                                        *paint = buffer.readPaint();
+                                    });
+            break;
+        case SK_PICT_INDEXED_PATH_BUFFER_TAG:
+            this->parseIndexedArray(buffer, size, &fPaths, fArrays ? &fLazyPaths : nullptr,
+                                    [](SkReadBuffer& buffer, SkPath* path) {
+                                        buffer.readPath(path);
+                                    });
+            break;
+        case SK_PICT_INDEXED_IMAGE_BUFFER_TAG:
+            this->parseIndexedArray(buffer, size, &fImages, fArrays ? &fLazyImages : nullptr,
+                                    [](SkReadBuffer& buffer, sk_sp<const SkImage>* image) {
+                                        *image = buffer.readImage();
+                                    });
+            break;
         case SK_PICT_PAINT_BUFFER_TAG: {
             if (!buffer.validate(SkTFitsIn<int>(size))) {
                 return;
@@ -472,15 +723,29 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               sk_sp<SkData> source,
+                                               SkExecutor* executor) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
+    if (source) {
+        SkASSERT(stream->getMemoryBase() == source->data());
+        data->fSource = std::move(source);
+        data->fProcs  = procs;
+    } else if (executor) {
+        data->fExecutor = executor;
+        data->fProcs    = procs;
+    }
 
     if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
         return nullptr;
     }
+    if (data->fSource) {
+        // We'll be played back directly rather than re-recorded; see initForPlayback().
+        data->initForPlayback();
+    }
     return data.release();
 }
 
@@ -537,8 +802,11 @@ const SkPaint* SkPictureData::optionalPaint(SkReadBuffer* reader) const {
     if (index == 0) {
         return nullptr; // recorder wrote a zero for no paint (likely drawimage)
     }
-    return reader->validate(index > 0 && index <= fPaints.count()) ?
-        &fPaints[index - 1] : nullptr;
+    const SkPaint* paint = reader->validate(index > 0 && index <= fPaints.count()) ?
+        this->paint(index - 1) : nullptr;
+    // A paint that failed to decode invalidates the reader, so playback stops here.
+    reader->validate(paint != nullptr);
+    return paint;
 }
 
 const SkPaint& SkPictureData::requiredPaint(SkReadBuffer* reader) const {
@@ -549,3 +817,107 @@ const SkPaint& SkPictureData::requiredPaint(SkReadBuffer* reader) const {
     static const SkPaint& stub = *(new SkPaint);
     return stub;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkPictureData::setupItemBuffer(const LazyIndex& lazy, int i, SkReadBuffer* buffer) const {
+    buffer->setMemory(lazy.fItems + lazy.fOffsets[i], lazy.fOffsets[i + 1] - lazy.fOffsets[i]);
+    buffer->setVersion(fInfo.getVersion());
+    fFactoryPlayback->setupBuffer(*buffer);
+    fTFPlayback.setupBuffer(*buffer);
+    buffer->setDeserialProcs(fProcs);
+}
+
+// These only ever run once per item, before anyone can see it, so it's safe to write it here.
+
+bool SkPictureData::decodePaint(int i) const {
+    SkReadBuffer buffer;
+    this->setupItemBuffer(fLazyPaints, i, &buffer);
+    SkPaint paint = buffer.readPaint();
+    if (!buffer.isValid() || !buffer.eof()) {
+        return false;
+    }
+    const_cast<SkPaint&>(fPaints[i]) = std::move(paint);
+    return true;
+}
+
+bool SkPictureData::decodePath(int i) const {
+    SkReadBuffer buffer;
+    this->setupItemBuffer(fLazyPaths, i, &buffer);
+    SkPath path;
+    buffer.readPath(&path);
+    if (!buffer.isValid() || !buffer.eof()) {
+        return false;
+    }
+    path.updateBoundsCache();
+    fDecodedBytes.fetch_add(path.approximateBytesUsed() - sizeof(SkPath),
+                            std::memory_order_relaxed);
+    const_cast<SkPath&>(fPaths[i]) = std::move(path);
+    return true;
+}
+
+// Lazily decoded images hold their encoded data; the rest, typically, their pixels.
+static size_t image_bytes_used(const SkImage& image) {
+    if (sk_sp<SkData> encoded = image.refEncodedData()) {
+        return encoded->size();
+    }
+    return image.imageInfo().computeMinByteSize();
+}
+
+void SkPictureData::decodeImage(int i) const {
+    SkReadBuffer buffer;
+    this->setupItemBuffer(fLazyImages, i, &buffer);
+    sk_sp<SkImage> image = buffer.readImage();
+    if (!buffer.isValid() || !image) {
+        // Like readImage(), never leave ops that draw an image with a null one.
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(1, 1);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        image = bitmap.asImage();
+    }
+    fDecodedBytes.fetch_add(image_bytes_used(*image), std::memory_order_relaxed);
+    const_cast<sk_sp<const SkImage>&>(fImages[i]) = std::move(image);
+}
+
+size_t SkPictureData::approximateBytesUsed() const {
+    // Data read in place stays wherever the source was mapped from.
+    auto copied = [this](const sk_sp<SkData>& data) -> size_t {
+        if (!data) {
+            return 0;
+        }
+        const uintptr_t begin = (uintptr_t)data->data(),
+                        source = fSource ? (uintptr_t)fSource->data() : 0;
+        const bool inPlace = fSource && begin >= source &&
+                             begin + data->size() <= source + fSource->size();
+        return inPlace ? 0 : data->size();
+    };
+    size_t bytes = sizeof(*this) + copied(fOpData) + copied(fOpIndex) + copied(fArrays);
+
+    // As in SkRecord, paints only count their own size.
+    bytes += fPaints.count() * sizeof(SkPaint);
+    if (fLazyPaths.fOnce) {
+        bytes += fPaths.count() * sizeof(SkPath);
+    } else {
+        for (const SkPath& path : fPaths) {
+            bytes += path.approximateBytesUsed();
+        }
+    }
+    bytes += fImages.count() * sizeof(sk_sp<const SkImage>);
+    if (!fLazyImages.fOnce) {
+        for (const auto& image : fImages) {
+            bytes += image ? image_bytes_used(*image) : 0;
+        }
+    }
+    bytes += fDecodedBytes.load(std::memory_order_relaxed);
+
+    for (const auto& pic : fPictures) {
+        bytes += pic->approximateBytesUsed();
+    }
+    for (const auto& blob : fTextBlobs) {
+        bytes += SkTextBlobPriv::ApproximateBytesUsed(*blob);
+    }
+    for (const auto& vertices : fVertices) {
+        bytes += vertices->approximateSize();
+    }
+    return bytes;
+}
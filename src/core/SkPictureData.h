@@ -11,14 +11,18 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkDrawable.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTArray.h"
 #include "src/core/SkPictureFlat.h"
 
+#include <atomic>
 #include <memory>
 
+class SkBinaryWriteBuffer;
 class SkData;
+class SkExecutor;
 class SkPictureRecord;
-struct SkSerialProcs;
 class SkStream;
 class SkWStream;
 class SkBBoxHierarchy;
@@ -63,6 +67,21 @@ public:
 #define SK_PICT_TEXTBLOB_BUFFER_TAG SkSetFourByteTag('b', 'l', 'o', 'b')
 #define SK_PICT_VERTICES_BUFFER_TAG SkSetFourByteTag('v', 'e', 'r', 't')
 #define SK_PICT_IMAGE_BUFFER_TAG    SkSetFourByteTag('i', 'm', 'a', 'g')
+// Since kIndexedArrays_Version the stream format writes paints, paths and images as a count,
+// count+1 byte offsets relative to the end of those offsets, and then the items themselves, so
+// that any one of them can be decoded without decoding the others first.
+#define SK_PICT_INDEXED_PAINT_BUFFER_TAG SkSetFourByteTag('p', 'n', 't', 'x')
+#define SK_PICT_INDEXED_PATH_BUFFER_TAG  SkSetFourByteTag('p', 't', 'h', 'x')
+#define SK_PICT_INDEXED_IMAGE_BUFFER_TAG SkSetFourByteTag('i', 'm', 'g', 'x')
+
+// Written after the op data by pictures recorded with a BBH when SkSerialProcs asks for it, where
+// size is the number of ops in their SkRecord.  It's followed by size+1 offsets into the op data,
+// where op i was written between offsets i and i+1, and then the size SkRects that
+// SkRecordFillBounds() computed for those ops.
+#define SK_PICT_OP_INDEX_TAG SkSetFourByteTag('o', 'p', 'i', 'x')
+
+// Followed by size zero bytes, so that the next tag's data is 4-byte aligned in the stream.
+#define SK_PICT_PAD_TAG     SkSetFourByteTag('p', 'a', 'd', ' ')
 
 // Always write this last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
@@ -75,12 +94,22 @@ T* read_index_base_1_or_null(SkReadBuffer* reader, const SkTArray<sk_sp<T>>& arr
 
 class SkPictureData {
 public:
-    SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
+    // opIndex, if not null, is laid out as the data following an SK_PICT_OP_INDEX_TAG.
+    SkPictureData(const SkPictureRecord& record, const SkPictInfo&,
+                  sk_sp<SkData> opIndex = nullptr);
     // Does not affect ownership of SkStream.
+    // If source is not null, stream must be reading it from memory (e.g. an SkMemoryStream).
+    // The op data and arrays are then left in place in source wherever they are 4-byte aligned,
+    // and indexed paints, paths and images are only decoded when first used, so procs must stay
+    // valid for as long as the returned SkPictureData.
+    // Otherwise, if executor is not null, indexed paints, paths and images are decoded on it in
+    // parallel, so procs must be safe to call from several threads at once.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           sk_sp<SkData> source = nullptr,
+                                           SkExecutor* executor = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
@@ -88,6 +117,17 @@ public:
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // The op index, if any: see SK_PICT_OP_INDEX_TAG.  opIndexCount() is 0 when there's none.
+    int opIndexCount() const { return fOpIndexCount; }
+    const uint32_t* opIndexOffsets() const { return fOpIndexOffsets; }
+    const SkRect* opIndexBounds() const { return fOpIndexBounds; }
+
+    const SkTArray<sk_sp<const SkPicture>>& pictures() const { return fPictures; }
+
+    // Approximately how many bytes this holds, not counting any data left in place in the source
+    // it was created from, nor paints, paths and images that have yet to be decoded.
+    size_t approximateBytesUsed() const;
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
@@ -99,13 +139,15 @@ public:
     const SkImage* getImage(SkReadBuffer* reader) const {
         // images are written base-0, unlike paths, pictures, drawables, etc.
         const int index = reader->readInt();
-        return reader->validateIndex(index, fImages.count()) ? fImages[index].get() : nullptr;
+        return reader->validateIndex(index, fImages.count()) ? this->image(index) : nullptr;
     }
 
     const SkPath& getPath(SkReadBuffer* reader) const {
         int index = reader->readInt();
-        return reader->validate(index > 0 && index <= fPaths.count()) ?
-                fPaths[index - 1] : fEmptyPath;
+        const SkPath* path = reader->validate(index > 0 && index <= fPaths.count()) ?
+                this->path(index - 1) : nullptr;
+        // A path that failed to decode invalidates the reader, so playback stops here.
+        return reader->validate(path != nullptr) ? *path : fEmptyPath;
     }
 
     const SkPicture* getPicture(SkReadBuffer* reader) const {
@@ -132,17 +174,80 @@ public:
     }
 
 private:
+    // Where the items of an indexed array are, to decode them one at a time: on first use, or
+    // in parallel on fExecutor.
+    struct LazyIndex {
+        const uint32_t*           fOffsets = nullptr;   // count+1 offsets, relative to fItems
+        const char*               fItems   = nullptr;
+        std::unique_ptr<SkOnce[]> fOnce;                // null unless the array is lazy
+        std::unique_ptr<bool[]>   fFailed;              // items that failed to decode
+    };
+
+    // These return null if the paint or path failed to decode.
+    const SkPaint* paint(int i) const {
+        if (fLazyPaints.fOnce) {
+            fLazyPaints.fOnce[i]([&] { fLazyPaints.fFailed[i] = !this->decodePaint(i); });
+            if (fLazyPaints.fFailed[i]) {
+                return nullptr;
+            }
+        }
+        return &fPaints[i];
+    }
+    const SkPath* path(int i) const {
+        if (fLazyPaths.fOnce) {
+            fLazyPaths.fOnce[i]([&] { fLazyPaths.fFailed[i] = !this->decodePath(i); });
+            if (fLazyPaths.fFailed[i]) {
+                return nullptr;
+            }
+        }
+        return &fPaths[i];
+    }
+    const SkImage* image(int i) const {
+        if (fLazyImages.fOnce) {
+            fLazyImages.fOnce[i]([&] { this->decodeImage(i); });
+        }
+        return fImages[i].get();
+    }
+
+    // Each is called once, under its item's SkOnce, to fill in a default-constructed item.
+    // Paints and paths that fail to decode are left as they were, and false is returned; an image
+    // that fails to decode becomes a transparent one, as SkReadBuffer::readImage() makes.
+    bool decodePaint(int i) const;
+    bool decodePath(int i) const;
+    void decodeImage(int i) const;
+    // Points buffer at item i of an indexed array, set up to read it on any thread.
+    void setupItemBuffer(const LazyIndex&, int i, SkReadBuffer*) const;
+
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
                         const SkDeserialProcs&, SkTypefacePlayback*);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
+    template <typename T, typename ReadFn>
+    void parseIndexedArray(SkReadBuffer&, uint32_t count, SkTArray<T>*, LazyIndex*, ReadFn);
     void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
+    void flattenIndexedToBuffer(SkBinaryWriteBuffer&, bool textBlobsOnly) const;
+    bool setOpIndex(sk_sp<SkData>, uint32_t count);
 
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    sk_sp<SkData>   fOpIndex;   // optional, see SK_PICT_OP_INDEX_TAG
+    int             fOpIndexCount   = 0;
+    const uint32_t* fOpIndexOffsets = nullptr;  // both point into fOpIndex
+    const SkRect*   fOpIndexBounds  = nullptr;
+
+    // Only set by CreateFromStream() when given a source to leave the data in.
+    sk_sp<SkData>   fSource;
+    sk_sp<SkData>   fArrays;    // the ARRAYS buffer, which the lazy indices point into
+    SkDeserialProcs fProcs;     // also set when decoding on fExecutor
+    SkExecutor*     fExecutor = nullptr;
+    LazyIndex       fLazyPaints,
+                    fLazyPaths,
+                    fLazyImages;
+    // What lazily decoded paths and images hold beyond their slots in fPaths and fImages.
+    mutable std::atomic<size_t> fDecodedBytes{0};
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
@@ -46,31 +46,69 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
 
     SkAutoCanvasRestore acr(canvas, false);
 
-    while (!reader.eof() && reader.isValid()) {
-        if (callback && callback->abort()) {
+    if (!this->drawOps(&reader, reader.size(), canvas, callback, initialMatrix)) {
+        return;
+    }
+
+    // need to propagate invalid state to the parent reader
+    if (buffer) {
+        buffer->validate(reader.isValid());
+    }
+}
+
+void SkPicturePlayback::drawIndexed(SkCanvas* canvas,
+                                    SkPicture::AbortCallback* callback,
+                                    const std::vector<int>& ops) {
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    const SkData* opData = fPictureData->opData().get();
+    const uint32_t* offsets = fPictureData->opIndexOffsets();
+    SkASSERT(offsets);
+
+    SkM44 initialMatrix = canvas->getLocalToDevice();
+
+    // The index doesn't cover the save and restore that the whole picture's ops were written
+    // between, so they're done here, as SkRecordDraw() does for an SkBigPicture.
+    SkAutoCanvasRestore acr(canvas, true);
+
+    SkReadBuffer reader;
+    for (int i : ops) {
+        SkASSERT(0 <= i && i < fPictureData->opIndexCount());
+        // The reader spans all of the op data, as offsets to skip to on a clip are relative to it.
+        reader.setMemory(opData->data(), opData->size());
+        reader.skip(offsets[i]);
+        if (!this->drawOps(&reader, offsets[i + 1], canvas, callback, initialMatrix) ||
+            !reader.isValid()) {
             return;
         }
+    }
+}
+
+bool SkPicturePlayback::drawOps(SkReadBuffer* reader, size_t stop, SkCanvas* canvas,
+                                SkPicture::AbortCallback* callback,
+                                const SkM44& initialMatrix) {
+    while (reader->offset() < stop && reader->isValid()) {
+        if (callback && callback->abort()) {
+            return false;
+        }
 
-        fCurOffset = reader.offset();
+        fCurOffset = reader->offset();
 
-        uint32_t bits = reader.readInt();
+        uint32_t bits = reader->readInt();
         uint32_t op   = bits >> 24,
                  size = bits & 0xffffff;
         if (size == 0xffffff) {
-            size = reader.readInt();
+            size = reader->readInt();
         }
 
-        if (!reader.validate(size > 0 && op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
-            return;
+        if (!reader->validate(size > 0 && op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+            return false;
         }
 
-        this->handleOp(&reader, (DrawType)op, size, canvas, initialMatrix);
-    }
-
-    // need to propagate invalid state to the parent reader
-    if (buffer) {
-        buffer->validate(reader.isValid());
+        this->handleOp(reader, (DrawType)op, size, canvas, initialMatrix);
     }
+    return true;
 }
 
 static void validate_offsetToRestore(SkReadBuffer* reader, size_t offsetToRestore) {
@@ -10,6 +10,8 @@
 
 #include "src/core/SkPictureFlat.h"
 
+#include <vector>
+
 class SkBitmap;
 class SkCanvas;
 class SkPaint;
@@ -25,6 +27,9 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Draws just the given ops from the picture data's op index, in the order given.
+    void drawIndexed(SkCanvas* canvas, SkPicture::AbortCallback*, const std::vector<int>& ops);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
@@ -37,6 +42,11 @@ protected:
     // The offset of the current operation when within the draw method
     size_t fCurOffset;
 
+    // Draws ops from reader until it reaches stop or one of them leaves it invalid.  Returns false
+    // if the callback aborted it or it read a malformed op header.
+    bool drawOps(SkReadBuffer* reader, size_t stop, SkCanvas* canvas,
+                 SkPicture::AbortCallback*, const SkM44& initialMatrix);
+
     void handleOp(SkReadBuffer* reader,
                   DrawType op,
                   uint32_t size,
@@ -99,6 +99,8 @@ public:
     // V87: SkPaint now holds a user-defined blend function (SkBlender), no longer has DrawLooper
     // V88: Add blender to ComposeShader and BlendImageFilter
     // V89: Deprecated SkClipOps are no longer supported
+    // V90: Stream format keeps op data and arrays 4-byte aligned, paints/paths/images indexed
+    // V91: Pictures recorded with a BBH store an index of their ops' offsets and bounds
 
     enum Version {
         kPictureShaderFilterParam_Version   = 82,
@@ -109,10 +111,12 @@ public:
         kSkBlenderInSkPaint                 = 87,
         kBlenderInEffects                   = 88,
         kNoExpandingClipOps                 = 89,
+        kIndexedArrays_Version              = 90,
+        kOpIndex_Version                    = 91,
 
         // Only SKPs within the min/current picture version range (inclusive) can be read.
         kMin_Version     = kPictureShaderFilterParam_Version,
-        kCurrent_Version = kNoExpandingClipOps
+        kCurrent_Version = kOpIndex_Version
     };
 };
 
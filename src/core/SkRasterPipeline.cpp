@@ -8,10 +8,12 @@
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkNx.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkBlitterStats.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipeline.h"
 #include <algorithm>
+#include <initializer_list>
 
 bool gForceHighPrecisionRasterPipeline;
 
@@ -354,7 +356,101 @@ void SkRasterPipeline::append_gamut_clamp_if_normalized(const SkImageInfo& info)
     }
 }
 
+// Reports the pipeline we just built to SkBlitterStats.  fallback is the stage that kept us from
+// building a lowp pipeline, if any.
+void SkRasterPipeline::report_stats(bool lowp, const StageList* fallback) const {
+    SkAutoSTMalloc<32, StockStage> stages(fNumStages);
+    int n = fNumStages,
+        fallbackIndex = -1;
+    for (const StageList* st = fStages; st; st = st->prev) {
+        stages[--n] = st->stage;
+        if (st == fallback) {
+            fallbackIndex = n;
+        }
+    }
+    SkBlitterStats::BuiltPipeline({stages.get(), (size_t)fNumStages}, lowp, fallbackIndex);
+}
+
+// If our stages exactly match one of the fused pipelines of the given precision, fills the program
+// ending at ip with just our contexts, and returns that fused pipeline.  Otherwise, returns null.
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_fused_pipeline(void** ip,
+                                                                         bool lowp) const {
+    static constexpr int kMaxFusedStages = 16;
+    struct Fused {
+        int        count;
+        StockStage stages[kMaxFusedStages];
+    };
+#define M(name, ...) {(int)std::initializer_list<StockStage>{__VA_ARGS__}.size(), {__VA_ARGS__}},
+    static constexpr Fused kHighp[] = { SK_RASTER_PIPELINE_FUSED_HIGHP(M) },
+                           kLowp [] = { SK_RASTER_PIPELINE_FUSED_LOWP (M) };
+#undef M
+
+    const Fused* fused = lowp ? kLowp : kHighp;
+    const int    count = lowp ? SK_ARRAY_COUNT(kLowp) : SK_ARRAY_COUNT(kHighp);
+    for (int i = 0; i < count; i++) {
+        if (fused[i].count != fNumStages) {
+            continue;
+        }
+        // Stages are stored backwards in fStages, so we compare back to front.
+        int n = fNumStages;
+        const StageList* st = fStages;
+        while (st && st->stage == fused[i].stages[n-1]) {
+            st = st->prev;
+            n--;
+        }
+        if (st) {
+            continue;
+        }
+
+        auto fn = lowp ? SkOpts::fused_lowp[i] : SkOpts::fused_highp[i];
+        if (!fn) {
+            return nullptr;
+        }
+
+        // A fused pipeline's program is just its contexts, in order, starting at the front of the
+        // program we'd otherwise fill.
+        int contexts = 0;
+        for (st = fStages; st; st = st->prev) {
+            contexts += st->ctx ? 1 : 0;
+        }
+        ip = ip - fSlotsNeeded + contexts;
+        for (st = fStages; st; st = st->prev) {
+            if (st->ctx) {
+                *--ip = st->ctx;
+            }
+        }
+        if (SkBlitterStats::Enabled()) {
+            this->report_stats(lowp, nullptr);
+        }
+        return fn;
+    }
+    return nullptr;
+}
+
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_fused_pipeline(void** ip) const {
+    // Every lowp fused pipeline could run as an ordinary lowp pipeline, so they can go first.
+    // Highp fused pipelines include some highp-only stage, so they're next no matter what.
+    if (!gForceHighPrecisionRasterPipeline) {
+        if (auto fn = this->build_fused_pipeline(ip, /*lowp=*/true)) {
+            return fn;
+        }
+    }
+    return this->build_fused_pipeline(ip, /*lowp=*/false);
+}
+
+bool SkRasterPipeline::isFusedForTesting() const {
+    SkAutoSTMalloc<64, void*> program(fSlotsNeeded);
+    return fAllowFused && this->build_fused_pipeline(program.get() + fSlotsNeeded) != nullptr;
+}
+
 SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
+    if (fAllowFused) {
+        if (auto fn = this->build_fused_pipeline(ip)) {
+            return fn;
+        }
+    }
+
+    const StageList* fallback = nullptr;
     if (!gForceHighPrecisionRasterPipeline) {
         // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
         void** reset_point = ip;
@@ -369,13 +465,20 @@ SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) co
                 *--ip = (void*)fn;
             } else {
                 ip = reset_point;
+                fallback = st;
                 break;
             }
         }
         if (ip != reset_point) {
+            if (SkBlitterStats::Enabled()) {
+                this->report_stats(/*lowp=*/true, nullptr);
+            }
             return SkOpts::start_pipeline_lowp;
         }
     }
+    if (SkBlitterStats::Enabled()) {
+        this->report_stats(/*lowp=*/false, fallback);
+    }
 
     *--ip = (void*)SkOpts::just_return_highp;
     for (const StageList* st = fStages; st; st = st->prev) {
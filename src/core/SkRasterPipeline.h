@@ -91,6 +91,7 @@ class SkData;
     M(clamp_x_1) M(mirror_x_1) M(repeat_x_1)                       \
     M(evenly_spaced_gradient)                                      \
     M(gradient)                                                    \
+    M(gradient_lut)                                                \
     M(evenly_spaced_2_stop_gradient)                               \
     M(xy_to_unit_angle)                                            \
     M(xy_to_radius)                                                \
@@ -109,8 +110,42 @@ class SkData;
     M(emboss)                                                      \
     M(swizzle)
 
+// Some stage sequences are so common (solid color srcover, gradients, bilerped images) that we also
+// build them as fused pipelines: one function per sequence, calling each stage's body inline, with
+// no calls from stage to stage.  build_pipeline() uses one whenever our stages match it exactly.
+// Lowp fused pipelines must use only stages with lowp implementations, and each highp fused
+// pipeline must use some stage without one, so that we'd never have built it in lowp anyway.
+//   M(name, stages...)
+#define SK_RASTER_PIPELINE_FUSED_LOWP(M)                                                        \
+    M(srcover_color_rgba_8888,    uniform_color, clamp_gamut, srcover_rgba_8888)                \
+    M(srcover_color_bgra_8888,    uniform_color, clamp_gamut, swap_rb, srcover_rgba_8888)       \
+    M(srcover_color_rgba_8888_a8, uniform_color, clamp_gamut, scale_u8,                         \
+                                  load_8888_dst, srcover, store_8888)                           \
+    M(srcover_color_bgra_8888_a8, uniform_color, clamp_gamut, scale_u8,                         \
+                                  load_8888_dst, swap_rb_dst, srcover, swap_rb, store_8888)     \
+    M(linear_gradient_rgba_8888,  seed_shader, matrix_scale_translate, clamp_x_1,               \
+                                  evenly_spaced_2_stop_gradient, clamp_gamut, store_8888)       \
+    M(linear_gradient_bgra_8888,  seed_shader, matrix_scale_translate, clamp_x_1,               \
+                                  evenly_spaced_2_stop_gradient, clamp_gamut, swap_rb,          \
+                                  store_8888)                                                   \
+    M(linear_gradient_2x3_rgba_8888, seed_shader, matrix_2x3, clamp_x_1,                        \
+                                     evenly_spaced_2_stop_gradient, clamp_gamut, store_8888)    \
+    M(linear_gradient_2x3_bgra_8888, seed_shader, matrix_2x3, clamp_x_1,                        \
+                                     evenly_spaced_2_stop_gradient, clamp_gamut, swap_rb,       \
+                                     store_8888)
+
+#define SK_RASTER_PIPELINE_FUSED_HIGHP(M)                                                       \
+    M(bilerp_rgba_8888,      seed_shader, matrix_scale_translate, bilerp_clamp_8888,            \
+                             clamp_gamut, store_8888)                                           \
+    M(bilerp_bgra_8888,      seed_shader, matrix_scale_translate, bilerp_clamp_8888, swap_rb,   \
+                             clamp_gamut, swap_rb, store_8888)                                  \
+    M(bilerp_2x3_rgba_8888,  seed_shader, matrix_2x3, bilerp_clamp_8888,                        \
+                             clamp_gamut, store_8888)                                           \
+    M(bilerp_2x3_bgra_8888,  seed_shader, matrix_2x3, bilerp_clamp_8888, swap_rb,               \
+                             clamp_gamut, swap_rb, store_8888)
+
 // The largest number of pixels we handle at a time.
-static const int SkRasterPipeline_kMaxStride = 16;
+static const int SkRasterPipeline_kMaxStride = 32;
 
 // Structs representing the arguments to some common stages.
 
@@ -170,6 +205,15 @@ struct SkRasterPipeline_GradientCtx {
     bool interpolatedInPremul;
 };
 
+struct SkRasterPipeline_GradientLUTCtx {
+    // colors[0] is used for t < 0, colors[1...n] sample [0,1] evenly, and colors[n+1] is used for
+    // t >= 1, with a copy of it in colors[n+2] to interpolate towards.  Each is RGBA 8888,
+    // interpolated as the gradient would have been, but premul only if it interpolates in premul.
+    const uint32_t* colors;
+    float scale;  // n - 1
+    float limit;  // n + 1
+};
+
 struct SkRasterPipeline_EvenlySpaced2StopGradientCtx {
     float f[4];
     float b[4];
@@ -253,6 +297,12 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // Tests and benches turn off fused pipelines to compare them with ordinary stage-by-stage ones.
+    void setAllowFusedForTesting(bool allow) { fAllowFused = allow; }
+
+    // Would run() and compile() use one of the fused pipelines for our stages right now?
+    bool isFusedForTesting() const;
+
 private:
     struct StageList {
         StageList* prev;
@@ -262,6 +312,9 @@ private:
 
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
     StartPipelineFn build_pipeline(void**) const;
+    StartPipelineFn build_fused_pipeline(void**) const;
+    StartPipelineFn build_fused_pipeline(void**, bool lowp) const;
+    void report_stats(bool lowp, const StageList* fallback) const;
 
     void unchecked_append(StockStage, void*);
 
@@ -270,6 +323,7 @@ private:
     StageList*    fStages;
     int           fNumStages;
     int           fSlotsNeeded;
+    bool          fAllowFused = true;
 };
 
 template <size_t bytes>
@@ -54,6 +54,13 @@ private:
     void append_clip_scale    (SkRasterPipeline*) const;
     void append_clip_lerp     (SkRasterPipeline*) const;
 
+    // blitAntiH() without fCoalesceAntiH: one pipeline run per run.
+    void blitAntiHRuns(int x, int y, const SkAlpha[], const int16_t[]);
+
+    friend SkBlitter* SkCreateRasterPipelineBlitterForTesting(const SkPixmap&, const SkPaint&,
+                                                              const SkMatrixProvider&,
+                                                              SkArenaAlloc*, bool coalesceAntiH);
+
     SkPixmap               fDst;
     SkBlendMode            fBlend;
     SkArenaAlloc*          fAlloc;
@@ -66,6 +73,12 @@ private:
         fMaskPtr      = {nullptr,0};  // Updated each call to blitMask().
     SkRasterPipeline_EmbossCtx fEmbossCtx;  // Used only for k3D_Format masks.
 
+    // When set, blitAntiH() gathers a scanline's partial-coverage runs into one coverage row and
+    // runs the A8 mask pipeline once over it, rather than running a pipeline for each run.
+    bool     fCoalesceAntiH = true;
+    // blitAntiH() coverage for one scanline, indexed by x.  Allocated on first use.
+    uint8_t* fCoverageRow = nullptr;
+
     // We may be able to specialize blitH() or blitRect() into a memset.
     void   (*fMemset2D)(SkPixmap*, int x,int y, int w,int h, uint64_t color) = nullptr;
     uint64_t fMemsetColor = 0;   // Big enough for largest memsettable dst format, F16.
@@ -132,6 +145,19 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
     return nullptr;
 }
 
+SkBlitter* SkCreateRasterPipelineBlitterForTesting(const SkPixmap& dst,
+                                                   const SkPaint& paint,
+                                                   const SkMatrixProvider& matrixProvider,
+                                                   SkArenaAlloc* alloc,
+                                                   bool coalesceAntiH) {
+    auto blitter = static_cast<SkRasterPipelineBlitter*>(
+            SkCreateRasterPipelineBlitter(dst, paint, matrixProvider, alloc, nullptr));
+    if (blitter) {
+        blitter->fCoalesceAntiH = coalesceAntiH;
+    }
+    return blitter;
+}
+
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
                                          const SkRasterPipeline& shaderPipeline,
@@ -366,6 +392,54 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
 }
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
+    if (!fCoalesceAntiH) {
+        return this->blitAntiHRuns(x,y,aa,runs);
+    }
+
+    // Opaque runs at least this long are worth breaking a span for, to draw them with blitH(),
+    // which skips coverage entirely and may even memset.  Shorter ones join the span.
+    static constexpr int kMinOpaqueRun = 16;
+
+    if (!fCoverageRow) {
+        fCoverageRow = fAlloc->makeArrayDefault<uint8_t>(fDst.width());
+    }
+
+    // The span [spanX,x) has its coverage in fCoverageRow, waiting to be drawn.
+    int spanX = x;
+    auto flush = [&] {
+        if (spanX < x) {
+            SkIRect clip = {spanX,y, x,y+1};
+
+            SkMask mask;
+            mask.fImage    = fCoverageRow + spanX;
+            mask.fBounds   = clip;
+            mask.fRowBytes = 0;
+            mask.fFormat   = SkMask::kA8_Format;
+
+            this->blitMask(mask, clip);
+        }
+    };
+
+    for (int16_t run = *runs; run > 0; run = *runs) {
+        SkASSERT(0 <= x && x + run <= fDst.width());
+        if (*aa == 0x00 || (*aa == 0xff && run >= kMinOpaqueRun)) {
+            flush();
+            if (*aa == 0xff) {
+                this->blitH(x,y,run);
+            }
+            spanX = x + run;
+        } else {
+            memset(fCoverageRow + x, *aa, run);
+        }
+        x    += run;
+        runs += run;
+        aa   += run;
+    }
+    flush();
+}
+
+void SkRasterPipelineBlitter::blitAntiHRuns(int x, int y,
+                                            const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
@@ -6,12 +6,33 @@
  */
 
 
+#include "include/private/SkSpinlock.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkScan.h"
 
 std::atomic<bool> gSkUseAnalyticAA{true};
 std::atomic<bool> gSkForceAnalyticAA{false};
+std::atomic<bool> gSkUseCoverageAccumulationAA{false};
+
+// The executor and its thread limit are always set and read together.
+static SkSpinlock  gParallelFillLock;
+static SkExecutor* gParallelFillExecutor SK_GUARDED_BY(gParallelFillLock) = nullptr;
+static int         gParallelFillThreads  SK_GUARDED_BY(gParallelFillLock) = 1;
+
+SkExecutor* SkScan::SetParallelFillExecutor(SkExecutor* executor, int maxThreads) {
+    SkAutoSpinlock lock(gParallelFillLock);
+    SkExecutor* prev = gParallelFillExecutor;
+    gParallelFillExecutor = executor;
+    gParallelFillThreads  = maxThreads;
+    return prev;
+}
+
+SkExecutor* SkScan::ParallelFillExecutor(int* maxThreads) {
+    SkAutoSpinlock lock(gParallelFillLock);
+    *maxThreads = gParallelFillThreads;
+    return gParallelFillExecutor;
+}
 
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
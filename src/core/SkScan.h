@@ -13,6 +13,7 @@
 #include "include/private/SkFixed.h"
 #include <atomic>
 
+class SkExecutor;
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
@@ -25,6 +26,10 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+// When set, paths we'd otherwise supersample (big, complex ones) accumulate coverage instead.
+// That's faster, but exact only for paths that don't cross themselves; where edges cross,
+// pixels may come out with more coverage than supersampling would give them.
+extern std::atomic<bool> gSkUseCoverageAccumulationAA;
 
 class AdditiveBlitter;
 
@@ -75,6 +80,19 @@ public:
     // Needed by do_fill_path in SkScanPriv.h
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
 
+    // Anti-aliases a non-inverse path by accumulating the area each of its lines covers in each
+    // pixel.  AntiFillPath() picks this for big, complex paths when gSkUseCoverageAccumulationAA
+    // is set; tests call it directly.  Given an executor, huge paths are scan converted in bands
+    // of rows, up to maxThreads bands at a time on it.  The pixels don't depend on the number of
+    // threads.
+    static void AccumulateFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                   const SkIRect& clipBounds,
+                                   SkExecutor* executor = nullptr, int maxThreads = 1);
+
+    // Sets the executor AntiFillPath() accumulates coverage of huge paths on, returning the
+    // previous one.  See SkGraphics::SetParallelPathFillExecutor().
+    static SkExecutor* SetParallelFillExecutor(SkExecutor*, int maxThreads);
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -95,6 +113,7 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static SkExecutor* ParallelFillExecutor(int* maxThreads);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/private/SkTArray.h"
+#include "include/private/SkTDArray.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+
+Coverage accumulation is another way to anti-alias paths, the way many font rasterizers do it.
+Rather than sorting edges and walking them together (AAA), or supersampling (SAA), we draw each
+line of the flattened path on its own into a buffer of floats, one cell per pixel.  A line adds
+to each cell it crosses the signed area it covers there, and adds what remains of its height to
+the next cell over, so that a running sum across a row gives the winding coverage of each pixel.
+
+Lines never interact, so there's nothing to sort and edge count costs nothing extra, but every
+pixel in the path's bounds has to be summed.  That makes this fast for big paths with lots of
+short edges, and a poor fit for simple or small ones.
+
+What we sum is each pixel's average winding, not how much of it has non-zero (or odd) winding.
+Those agree, so this is exact, only for paths that don't intersect themselves.  In pixels where
+edges cross we may overestimate coverage.  Like the font rasterizers this comes from, we accept
+that in exchange for never sorting edges, which is why this is opt-in through
+gSkUseCoverageAccumulationAA rather than used for every path that would be fast this way.
+
+The running sums are where we spend our time, so we compute them 8 cells at a time, along with
+turning them into alpha.
+
+*/
+
+namespace {
+
+// We flatten curves into lines that stray no more than this many pixels from them.  Every pixel
+// an edge passes through is then off by at most about this much coverage.
+constexpr float kTolerance = 1 / 32.0f;
+
+// A line, always pointing down (y0 < y1), remembering whether it originally pointed up.
+struct Line {
+    float x0, y0, x1, y1;
+    float dir;  // +1 for lines that pointed down, -1 for those that pointed up.
+};
+
+// Flattens a path into Lines, relative to the top-left of the region we're filling, with x
+// pinned to [0,width].  Anything left of the region winds the same at x=0 as it did where it
+// was, and anything right of it doesn't matter to us at all.
+class LineBuilder {
+public:
+    LineBuilder(float left, float top, float width) : fOrigin{left, top}, fWidth(width) {}
+
+    void moveTo(SkPoint p) { fLast = p - fOrigin; }
+
+    void lineTo(SkPoint p) {
+        p -= fOrigin;
+        this->add(fLast, p);
+        fLast = p;
+    }
+
+    void quadTo(SkPoint p1, SkPoint p2) {
+        const SkPoint pts[] = { fLast + fOrigin, p1, p2 };
+        const int n = segments(2 * second_difference(pts[0], p1, p2));
+        for (int i = 1; i < n; i++) {
+            this->lineTo(SkEvalQuadAt(pts, i * (1.0f / n)));
+        }
+        this->lineTo(p2);
+    }
+
+    void cubicTo(SkPoint p1, SkPoint p2, SkPoint p3) {
+        const SkPoint pts[] = { fLast + fOrigin, p1, p2, p3 };
+        const int n = segments(6 * std::max(second_difference(pts[0], p1, p2),
+                                            second_difference(p1, p2, p3)));
+        for (int i = 1; i < n; i++) {
+            SkPoint p;
+            SkEvalCubicAt(pts, i * (1.0f / n), &p, nullptr, nullptr);
+            this->lineTo(p);
+        }
+        this->lineTo(p3);
+    }
+
+    SkTDArray<Line>* lines() { return &fLines; }
+
+private:
+    static float second_difference(SkPoint a, SkPoint b, SkPoint c) {
+        return ((a - b) + (c - b)).length();
+    }
+
+    // How many lines to split a curve into so that none strays more than kTolerance from it,
+    // given a bound on the length of its second derivative.  (A chord spanning h of a curve's
+    // parameter strays from it by at most h^2/8 times that bound.)
+    static int segments(float secondDerivative) {
+        float n = std::ceil(std::sqrt(secondDerivative * (1 / (8 * kTolerance))));
+        return (int)std::min(std::max(n, 1.0f), 1024.0f);
+    }
+
+    void add(SkPoint a, SkPoint b) {
+        if (a.fY == b.fY) {
+            return;  // Horizontal lines don't change coverage.
+        }
+        // Split lines that cross either side, so each piece is entirely inside or outside.
+        for (float edge : {0.0f, fWidth}) {
+            if ((a.fX < edge && edge < b.fX) || (b.fX < edge && edge < a.fX)) {
+                SkPoint mid = {edge, a.fY + (edge - a.fX) / (b.fX - a.fX) * (b.fY - a.fY)};
+                this->add(a, mid);
+                this->add(mid, b);
+                return;
+            }
+        }
+        auto pin = [this](float x) { return std::min(std::max(x, 0.0f), fWidth); };
+        if (a.fY < b.fY) {
+            fLines.push_back({pin(a.fX), a.fY, pin(b.fX), b.fY, +1.0f});
+        } else {
+            fLines.push_back({pin(b.fX), b.fY, pin(a.fX), a.fY, -1.0f});
+        }
+    }
+
+    const SkPoint   fOrigin;
+    const float     fWidth;
+    SkPoint         fLast = {0, 0};
+    SkTDArray<Line> fLines;
+};
+
+// Adds the area line covers in rows [top,bottom) to the cells of acc, widening each row's
+// range of dirty cells [dirtyL[y], dirtyR[y]) to include any cells it touches.
+void accumulate_line(const Line& line, float* acc, int stride, int top, int bottom,
+                     int* dirtyL, int* dirtyR) {
+    const int yStart = std::max((int)std::floor(line.y0), top),
+              yEnd   = std::min((int)std::ceil (line.y1), bottom);
+    const float dxdy = (line.x1 - line.x0) / (line.y1 - line.y0),
+                xMax = (float)(stride - 2);
+
+    // We find x at the top and bottom of each row directly rather than by stepping from row to
+    // row, so a row's coverage never depends on which rows were accumulated before it.
+    auto x_at = [&](float y) {
+        return std::min(std::max(line.x0 + dxdy * (y - line.y0), 0.0f), xMax);
+    };
+    for (int y = yStart; y < yEnd; y++) {
+        const float yTop    = std::max((float)y, line.y0),
+                    yBottom = std::min((float)(y+1), line.y1),
+                    d       = (yBottom - yTop) * line.dir;
+        const float x     = x_at(yTop),
+                    xNext = x_at(yBottom);
+
+        const float x0 = std::min(x, xNext),
+                    x1 = std::max(x, xNext);
+        const int x0i = (int)x0,  // x0 >= 0, so this is floor().
+                  x1i = (int)std::ceil(x1);
+
+        float* row = acc + (y - top) * stride;
+        if (x1i <= x0i + 1) {
+            // The line stays within one pixel: split its area between that pixel and the next.
+            const float xm = 0.5f * (x + xNext) - x0i;
+            row[x0i + 0] += d - d * xm;
+            row[x0i + 1] += d * xm;
+        } else {
+            // The line crosses several pixels: a triangle in the first, trapezoids in the middle,
+            // and whatever's left over in the last.
+            const float s   = 1 / (x1 - x0),
+                        x0f = x0 - x0i,
+                        a0  = 0.5f * s * (1 - x0f) * (1 - x0f),
+                        x1f = x1 - x1i + 1,
+                        am  = 0.5f * s * x1f * x1f;
+            row[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                row[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - x0f);
+                row[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; xi++) {
+                    row[xi] += d * s;
+                }
+                const float a2 = a1 + (x1i - x0i - 3) * s;
+                row[x1i - 1] += d * (1 - a2 - am);
+            }
+            row[x1i] += d * am;
+        }
+
+        const int r = y - top;
+        dirtyL[r] = std::min(dirtyL[r], x0i);
+        dirtyR[r] = std::max(dirtyR[r], x1i + 2);
+    }
+}
+
+using F8 = skvx::Vec<8,float>;
+
+F8 to_coverage(F8 sum, bool evenOdd) {
+    F8 c = max(sum, -sum);
+    if (evenOdd) {
+        c = c - 2 * floor(c * 0.5f);
+        c = min(c, 2 - c);
+    }
+    return min(c, 1.0f);
+}
+
+SkAlpha to_alpha(float sum, bool evenOdd) {
+    F8 c = to_coverage(F8(sum), evenOdd) * 255 + 0.5f;
+    return (SkAlpha)c[0];
+}
+
+// Sums the cells of row in [left,right) into alpha, clearing them as we go.
+// Returns the sum of all the cells.
+float resolve_row(float* row, int left, int right, bool evenOdd, SkAlpha* alpha) {
+    float sum = 0;
+    int x = left;
+    for (; x + 8 <= right; x += 8) {
+        F8 v = F8::Load(row + x);
+        v += skvx::shuffle<0,0,1,2,3,4,5,6>(v) * F8{0,1,1,1,1,1,1,1};
+        v += skvx::shuffle<0,0,0,1,2,3,4,5>(v) * F8{0,0,1,1,1,1,1,1};
+        v += skvx::shuffle<0,0,0,0,0,1,2,3>(v) * F8{0,0,0,0,1,1,1,1};
+        v += sum;
+        sum = v[7];
+
+        skvx::cast<uint8_t>(to_coverage(v, evenOdd) * 255 + 0.5f).store(alpha + x);
+        F8(0).store(row + x);
+    }
+    for (; x < right; x++) {
+        sum += row[x];
+        row[x] = 0;
+        alpha[x] = to_alpha(sum, evenOdd);
+    }
+    return sum;
+}
+
+// The lines that touch each band of rows, in path order.
+struct Bands {
+    int                count;
+    SkAutoTMalloc<int> start;  // Lines touching band b are index[start[b] .. start[b+1]).
+    SkAutoTMalloc<int> index;
+};
+
+void bin_lines(const SkTDArray<Line>& lines, int height, int bandHeight, Bands* bands) {
+    bands->count  = (height + bandHeight - 1) / bandHeight;
+    bands->start.reset(bands->count + 1);
+    sk_bzero(bands->start.get(), sizeof(int) * (bands->count + 1));
+
+    // Each line's bands are [b0,b1), or empty if the line misses every row.
+    auto band_range = [&](const Line& line, int* b0, int* b1) {
+        const int top    = std::max((int)std::floor(line.y0), 0),
+                  bottom = std::min((int)std::ceil (line.y1), height);
+        *b0 = top / bandHeight;
+        *b1 = top < bottom ? (bottom - 1) / bandHeight + 1 : *b0;
+    };
+    int b0, b1;
+    for (const Line& line : lines) {
+        band_range(line, &b0, &b1);
+        for (int b = b0; b < b1; b++) {
+            bands->start[b + 1]++;
+        }
+    }
+    for (int b = 0; b < bands->count; b++) {
+        bands->start[b + 1] += bands->start[b];
+    }
+    bands->index.reset(bands->start[bands->count]);
+
+    SkAutoTMalloc<int> next(bands->count);
+    memcpy(next.get(), bands->start.get(), sizeof(int) * bands->count);
+    for (int i = 0; i < lines.count(); i++) {
+        band_range(lines[i], &b0, &b1);
+        for (int b = b0; b < b1; b++) {
+            bands->index[next[b]++] = i;
+        }
+    }
+}
+
+// Scratch space to scan convert one band of rows into alpha.
+class BandBuffer {
+public:
+    BandBuffer(int width, int rows)
+        : fAcc  ((size_t)(width + 2) * rows)
+        , fAlpha((size_t)width * rows)
+        , fLeft (rows)
+        , fRight(rows) {
+        sk_bzero(fAcc.get(), sizeof(float) * (width + 2) * rows);
+    }
+
+    // Scan converts rows [top,bottom) into alpha, recording which pixels of each row to blit.
+    void fill(const SkTDArray<Line>& lines, const int* index, int count,
+              int width, int top, int bottom, bool evenOdd) {
+        const int stride = width + 2,  // Lines pinned to x=width can touch two cells past it.
+                  rows   = bottom - top;
+        int* dirtyL = fLeft.get();
+        int* dirtyR = fRight.get();
+        std::fill(dirtyL, dirtyL + rows, stride);
+        std::fill(dirtyR, dirtyR + rows, 0);
+
+        for (int i = 0; i < count; i++) {
+            accumulate_line(lines[index[i]], fAcc.get(), stride, top, bottom, dirtyL, dirtyR);
+        }
+
+        for (int r = 0; r < rows; r++) {
+            const int left  = dirtyL[r],
+                      right = std::min(dirtyR[r], width);
+            if (left >= dirtyR[r]) {
+                fLeft[r] = fRight[r] = 0;  // Nothing touched this row.
+                continue;
+            }
+            float*   row   = fAcc.get() + (size_t)r * stride;
+            SkAlpha* alpha = fAlpha.get() + (size_t)r * width;
+
+            float sum = resolve_row(row, left, right, evenOdd, alpha);
+            for (int x = right; x < dirtyR[r]; x++) {
+                row[x] = 0;  // Cells past the last pixel don't affect any coverage.
+            }
+
+            // Any coverage left at the last cell we touched carries on to the right edge.
+            int end = right;
+            if (const SkAlpha rest = to_alpha(sum, evenOdd); rest && right < width) {
+                memset(alpha + right, rest, width - right);
+                end = width;
+            }
+            fLeft[r]  = left;
+            fRight[r] = end;
+        }
+    }
+
+    // Blits the rows fill() scan converted, as runs of equal alpha.
+    void blit(SkBlitter* blitter, int x, int y, int width, int rows,
+              SkAlpha* aa, int16_t* runs) const {
+        for (int r = 0; r < rows; r++) {
+            const int left  = fLeft[r],
+                      right = fRight[r];
+            if (left >= right) {
+                continue;
+            }
+            const SkAlpha* alpha = fAlpha.get() + (size_t)r * width;
+            for (int i = left; i < right;) {
+                int end = i + 1;
+                while (end < right && alpha[end] == alpha[i]) {
+                    end++;
+                }
+                aa  [i - left] = alpha[i];
+                runs[i - left] = SkToS16(end - i);
+                i = end;
+            }
+            runs[right - left] = 0;
+            blitter->blitAntiH(x + left, y + r, aa, runs);
+        }
+    }
+
+private:
+    SkAutoTMalloc<float>   fAcc;
+    SkAutoTMalloc<SkAlpha> fAlpha;
+    SkAutoTMalloc<int>     fLeft,
+                           fRight;
+};
+
+}  // namespace
+
+void SkScan::AccumulateFillPath(const SkPath&  path,
+                                SkBlitter*     blitter,
+                                const SkIRect& ir,
+                                const SkIRect& clipBounds,
+                                SkExecutor*    executor,
+                                int            maxThreads) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+    const int width  = bounds.width(),
+              height = bounds.height();
+    const bool evenOdd = path.getFillType() == SkPathFillType::kEvenOdd;
+
+    LineBuilder builder((float)bounds.fLeft, (float)bounds.fTop, (float)width);
+    {
+        SkPath::Iter iter(path, /*forceClose=*/true);
+        SkPoint pts[4];
+        for (SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+            switch (verb) {
+                case SkPath::kMove_Verb:  builder.moveTo(pts[0]);                 break;
+                case SkPath::kLine_Verb:  builder.lineTo(pts[1]);                 break;
+                case SkPath::kQuad_Verb:  builder.quadTo(pts[1], pts[2]);         break;
+                case SkPath::kCubic_Verb: builder.cubicTo(pts[1], pts[2], pts[3]); break;
+                case SkPath::kConic_Verb: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quads = quadder.computeQuads(pts, iter.conicWeight(),
+                                                                kTolerance);
+                    for (int i = 0; i < quadder.countQuads(); i++) {
+                        builder.quadTo(quads[2*i+1], quads[2*i+2]);
+                    }
+                } break;
+                case SkPath::kClose_Verb:
+                case SkPath::kDone_Verb: break;
+            }
+        }
+    }
+    const SkTDArray<Line>& lines = *builder.lines();
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    // We work in bands of rows, to keep the accumulation buffers a reasonable size.  Each row
+    // comes out the same no matter how we band, so huge paths can fill several bands at once.
+    static constexpr int kMaxCells         = 1 << 16,
+                         kMinParallelLines = 1 << 14;
+    const int threads = executor && lines.count() >= kMinParallelLines
+                      ? std::max(1, maxThreads) : 1;
+
+    int bandHeight = std::min(height, std::max(1, kMaxCells / (width + 2)));
+    if (threads > 1) {
+        bandHeight = std::min(bandHeight, (height + threads - 1) / threads);
+    }
+    Bands bands;
+    bin_lines(lines, height, bandHeight, &bands);
+
+    const int parallel = std::min(threads, bands.count);
+    SkTArray<BandBuffer> buffers(parallel);
+    for (int i = 0; i < parallel; i++) {
+        buffers.emplace_back(width, bandHeight);
+    }
+    SkAutoTMalloc<SkAlpha> aa(width + 1);
+    SkAutoTMalloc<int16_t> runs(width + 1);
+
+    auto fill = [&](int band, BandBuffer* buffer) {
+        const int top    = band * bandHeight,
+                  bottom = std::min(top + bandHeight, height),
+                  first  = bands.start[band];
+        buffer->fill(lines, bands.index.get() + first, bands.start[band + 1] - first,
+                     width, top, bottom, evenOdd);
+    };
+    auto blit = [&](int band, const BandBuffer& buffer) {
+        const int top = band * bandHeight;
+        buffer.blit(blitter, bounds.fLeft, bounds.fTop + top, width,
+                    std::min(bandHeight, height - top), aa.get(), runs.get());
+    };
+
+    // Our blitter isn't thread safe, so we blit each batch of bands here, in order, once
+    // they've all been scan converted.
+    for (int band = 0; band < bands.count; band += parallel) {
+        const int n = std::min(parallel, bands.count - band);
+        if (n > 1) {
+            SkTaskGroup tg(*executor);
+            tg.batch(n, [&](int i) { fill(band + i, &buffers[i]); });
+            tg.wait();
+        } else {
+            fill(band, &buffers[0]);
+        }
+        for (int i = 0; i < n; i++) {
+            blit(band + i, buffers[i]);
+        }
+    }
+}
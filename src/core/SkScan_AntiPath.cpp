@@ -635,6 +635,14 @@ static void compute_complexity(const SkPath& path, SkScalar& avgLength, SkScalar
     }
 }
 
+// Huge paths can accumulate coverage in bands in parallel, if we've been given an executor.
+// The bands together draw exactly what accumulating serially would, but not what AAA or SAA
+// would, so this never changes which of those a path is filled with.
+static bool ShouldFillInParallel(const SkPath& path, const SkExecutor* executor) {
+    static constexpr int kMinParallelPoints = 1 << 14;
+    return executor && path.countPoints() >= kMinParallelPoints;
+}
+
 static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar complexity) {
 #if defined(SK_DISABLE_AAA)
     return false;
@@ -789,6 +797,15 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
         SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    } else if (gSkUseCoverageAccumulationAA && !isInverse) {
+        int parallelThreads;
+        SkExecutor* parallelExecutor = ParallelFillExecutor(&parallelThreads);
+        if (ShouldFillInParallel(path, parallelExecutor)) {
+            SkScan::AccumulateFillPath(path, blitter, ir, clipRgn->getBounds(),
+                                       parallelExecutor, parallelThreads);
+        } else {
+            SkScan::AccumulateFillPath(path, blitter, ir, clipRgn->getBounds());
+        }
     } else {
         SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
     }
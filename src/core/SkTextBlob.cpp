@@ -648,6 +648,19 @@ sk_sp<SkTextBlob> SkTextBlobBuilder::make() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+size_t SkTextBlobPriv::ApproximateBytesUsed(const SkTextBlob& blob) {
+    SkSafeMath safe;
+    size_t size = sizeof(SkTextBlob);
+    const auto* run = SkTextBlob::RunRecord::First(&blob);
+    do {
+        size = safe.add(size, SkTextBlob::RunRecord::StorageSize(run->glyphCount(),
+                                                                 run->textSize(),
+                                                                 run->positioning(), &safe));
+        run = SkTextBlob::RunRecord::Next(run);
+    } while (run);
+    return safe ? size : 0;
+}
+
 void SkTextBlobPriv::Flatten(const SkTextBlob& blob, SkWriteBuffer& buffer) {
     // seems like we could skip this, and just recompute bounds in unflatten, but
     // some cc_unittests fail if we remove this...
@@ -37,6 +37,11 @@ public:
      *          invalid.
      */
     static sk_sp<SkTextBlob> MakeFromBuffer(SkReadBuffer&);
+
+    /**
+     *  Returns the size of the blob and its runs.
+     */
+    static size_t ApproximateBytesUsed(const SkTextBlob&);
 };
 
 //
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/private/SkChecksum.h"
@@ -39,6 +40,7 @@
 
 bool gSkVMAllowJIT{false};
 bool gSkVMJITViaDylib{false};
+bool gSkVMJITAllowAVX512{true};
 
 #if defined(SKVM_JIT)
     #if defined(SK_BUILD_FOR_WIN)
@@ -155,9 +157,13 @@ namespace skvm {
         int loop = 0;
         std::vector<int> strides;
 
+        std::vector<OptimizedInstruction> optimized;  // Kept around for serialize().
+
         std::atomic<void*> jit_entry{nullptr};   // TODO: minimal std::memory_orders
-        size_t jit_size = 0;
-        void*  dylib    = nullptr;
+        size_t jit_size      = 0;
+        size_t jit_code_size = 0;  // <= jit_size, which is rounded up to whole pages.
+        void*  dylib         = nullptr;
+        bool   avx512        = false;  // Does jit() use 16 AVX-512 lanes instead of 8 AVX2 lanes?
 
     #if defined(SKVM_LLVM)
         std::unique_ptr<llvm::LLVMContext>     llvm_ctx;
@@ -535,13 +541,17 @@ namespace skvm {
     }
 
     Program Builder::done(const char* debug_name, bool allow_jit) const {
+        return this->done(debug_name, allow_jit, gSkVMJITAllowAVX512);
+    }
+
+    Program Builder::done(const char* debug_name, bool allow_jit, bool allow_avx512) const {
         char buf[64] = "skvm-jit-";
         if (!debug_name) {
             *SkStrAppendU32(buf+9, this->hash()) = '\0';
             debug_name = buf;
         }
 
-        return {this->optimize(), fStrides, debug_name, allow_jit};
+        return {this->optimize(), fStrides, debug_name, allow_jit, allow_avx512};
     }
 
     uint64_t Builder::hash() const {
@@ -1744,6 +1754,27 @@ namespace skvm {
     }
 
 
+    // Pack x86 opcode map selector to 5-bit VEX / 2-bit EVEX encoding.
+    static int vex_map(int map) {
+        switch (map) {
+            case   0x0f: return 0b00001;
+            case 0x380f: return 0b00010;
+            case 0x3a0f: return 0b00011;
+            // Several more cases only used by XOP / TBM.
+        }
+        SkUNREACHABLE;
+    }
+
+    // Pack  mandatory SSE opcode prefix byte to 2-bit VEX / EVEX encoding.
+    static int vex_pp(int pp) {
+        switch (pp) {
+            case 0x66: return 0b01;
+            case 0xf3: return 0b10;
+            case 0xf2: return 0b11;
+        }
+        return 0b00;
+    }
+
     // The VEX prefix extends SSE operations to AVX.  Used generally, even with XMM.
     struct VEX {
         int     len;
@@ -1758,27 +1789,8 @@ namespace skvm {
                    int vvvv,   // 4-bit second operand register.  Pass our x for 3-arg ops.
                    bool   L,   // Set for 256-bit ymm operations, off for 128-bit xmm.
                    int   pp) { // SSE mandatory prefix: 0x66, 0xf3, 0xf2, else none.
-
-        // Pack x86 opcode map selector to 5-bit VEX encoding.
-        map = [map]{
-            switch (map) {
-                case   0x0f: return 0b00001;
-                case 0x380f: return 0b00010;
-                case 0x3a0f: return 0b00011;
-                // Several more cases only used by XOP / TBM.
-            }
-            SkUNREACHABLE;
-        }();
-
-        // Pack  mandatory SSE opcode prefix byte to 2-bit VEX encoding.
-        pp = [pp]{
-            switch (pp) {
-                case 0x66: return 0b01;
-                case 0xf3: return 0b10;
-                case 0xf2: return 0b11;
-            }
-            return 0b00;
-        }();
+        map = vex_map(map);
+        pp  = vex_pp(pp);
 
         VEX vex = {0, {0,0,0}};
         if (X == 0 && B == 0 && WE == 0 && map == 0b00001) {
@@ -1805,6 +1817,37 @@ namespace skvm {
         return vex;
     }
 
+    // The EVEX prefix extends VEX again for AVX-512.  We only use it for 512-bit operations
+    // on zmm0-15, so the extra register bits R' and V' (for zmm16-31) are always zero.
+    struct EVEX {
+        uint8_t bytes[4];
+    };
+
+    static EVEX evex(bool   W,   // Same as VEX WE.
+                     bool   R,   // Same as VEX R.
+                     bool   X,   // Same as VEX X, or the high bit of rm for register operands.
+                     bool   B,   // Same as VEX B.
+                     int  map,   // SSE opcode map selector: 0x0f, 0x380f, 0x3a0f.
+                     int vvvv,   // 4-bit second operand register.
+                     int   pp,   // SSE mandatory prefix: 0x66, 0xf3, 0xf2, else none.
+                     int  aaa) { // Opmask register, with k0 meaning no mask.
+        EVEX evex;
+        evex.bytes[0] = 0x62;
+        evex.bytes[1] = (vex_map(map) &  3) << 0
+                      | 1                   << 4   // ~R'
+                      | (~(int)B      &  1) << 5
+                      | (~(int)X      &  1) << 6
+                      | (~(int)R      &  1) << 7;
+        evex.bytes[2] = (vex_pp(pp)   &  3) << 0
+                      | 1                   << 2   // Fixed 1.
+                      | (~vvvv        & 15) << 3
+                      | (W            &  1) << 7;
+        evex.bytes[3] = (aaa          &  7) << 0
+                      | 1                   << 3   // ~V'
+                      | 0b10                << 5;  // L'L, 512-bit.
+        return evex;
+    }
+
     Assembler::Assembler(void* buf) : fCode((uint8_t*)buf), fSize(0) {}
 
     size_t Assembler::size() const { return fSize; }
@@ -2189,6 +2232,190 @@ namespace skvm {
         this->byte(sib(scale, ix&7, base&7));
     }
 
+    void Assembler::vinserti128(Ymm dst, Ymm x, Operand y, int imm) {
+        this->op(0x66,0x3a0f,0x38, dst,x,y);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    // EVEX 8-bit displacements are implicitly scaled by N, the size of the memory access,
+    // so disp8 works only when disp is a small multiple of N.
+    static Mod evex_mod(int* disp, int N) {
+        if (*disp == 0) {
+            return Mod::Indirect;
+        }
+        if (*disp % N == 0 && SkTFitsIn<int8_t>(*disp / N)) {
+            *disp /= N;
+            return Mod::OneByteImm;
+        }
+        return Mod::FourByteImm;
+    }
+
+    void Assembler::op(int prefix, int map, int opcode, int dst, int x, Operand y,
+                       W w, int N, K mask) {
+        switch (y.kind) {
+            case Operand::REG: {
+                EVEX e = evex(w, dst>>3, y.reg>>4, y.reg>>3,
+                              map, x, prefix, mask);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(Mod::Direct, dst&7, y.reg&7));
+            } return;
+
+            case Operand::MEM: {
+                const Mem& m = y.mem;
+                const bool need_SIB = m.base  == rsp
+                                   || m.index != rsp;
+
+                int disp = m.disp;
+                const Mod md = evex_mod(&disp, N);
+
+                EVEX e = evex(w, dst>>3, m.index>>3, m.base>>3,
+                              map, x, prefix, mask);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(md, dst&7, (need_SIB ? rsp : m.base)&7));
+                if (need_SIB) {
+                    this->byte(sib(m.scale, m.index&7, m.base&7));
+                }
+                this->bytes(&disp, imm_bytes(md));
+            } return;
+
+            case Operand::LABEL: {
+                // IP-relative addressing always uses a 32-bit displacement, never compressed.
+                const int rip = rbp;
+
+                EVEX e = evex(w, dst>>3, 0, rip>>3,
+                              map, x, prefix, mask);
+                this->bytes(e.bytes, 4);
+                this->byte(opcode);
+                this->byte(mod_rm(Mod::Indirect, dst&7, rip&7));
+                this->word(this->disp32(y.label));
+            } return;
+        }
+    }
+
+    void Assembler::vpandd (Zmm dst, Zmm x, Operand y) { this->op(0x66,0x0f,0xdb, dst,x,y); }
+    void Assembler::vpandnd(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x0f,0xdf, dst,x,y); }
+    void Assembler::vpord  (Zmm dst, Zmm x, Operand y) { this->op(0x66,0x0f,0xeb, dst,x,y); }
+    void Assembler::vpxord (Zmm dst, Zmm x, Operand y) { this->op(0x66,0x0f,0xef, dst,x,y); }
+
+    void Assembler::vpternlogd(Zmm dst, Zmm x, Operand y, int imm) {
+        this->op(0x66,0x3a0f,0x25, dst,x,y);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    void Assembler::vpaddd (Zmm dst, Zmm x, Operand y) { this->op(0x66,  0x0f,0xfe, dst,x,y); }
+    void Assembler::vpsubd (Zmm dst, Zmm x, Operand y) { this->op(0x66,  0x0f,0xfa, dst,x,y); }
+    void Assembler::vpmulld(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0x40, dst,x,y); }
+
+    void Assembler::vaddps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x58, dst,x,y); }
+    void Assembler::vsubps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x5c, dst,x,y); }
+    void Assembler::vmulps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x59, dst,x,y); }
+    void Assembler::vdivps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x5e, dst,x,y); }
+    void Assembler::vminps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x5d, dst,x,y); }
+    void Assembler::vmaxps(Zmm dst, Zmm x, Operand y) { this->op(0,0x0f,0x5f, dst,x,y); }
+
+    void Assembler::vsqrtps(Zmm dst, Operand x) { this->op(0,0x0f,0x51, dst,x); }
+
+    void Assembler::vfmadd132ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0x98, dst,x,y); }
+    void Assembler::vfmadd213ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xa8, dst,x,y); }
+    void Assembler::vfmadd231ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xb8, dst,x,y); }
+
+    void Assembler::vfmsub132ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0x9a, dst,x,y); }
+    void Assembler::vfmsub213ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xaa, dst,x,y); }
+    void Assembler::vfmsub231ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xba, dst,x,y); }
+
+    void Assembler::vfnmadd132ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0x9c, dst,x,y); }
+    void Assembler::vfnmadd213ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xac, dst,x,y); }
+    void Assembler::vfnmadd231ps(Zmm dst, Zmm x, Operand y) { this->op(0x66,0x380f,0xbc, dst,x,y); }
+
+    // As with the ymm shifts, the opcode extension goes in "dst", dst in x, and x in y.
+    void Assembler::vpslld(Zmm dst, Zmm x, int imm) {
+        this->op(0x66,0x0f,0x72,6, dst,x, W0,64,k0);
+        this->byte(imm);
+    }
+    void Assembler::vpsrld(Zmm dst, Zmm x, int imm) {
+        this->op(0x66,0x0f,0x72,2, dst,x, W0,64,k0);
+        this->byte(imm);
+    }
+    void Assembler::vpsrad(Zmm dst, Zmm x, int imm) {
+        this->op(0x66,0x0f,0x72,4, dst,x, W0,64,k0);
+        this->byte(imm);
+    }
+
+    void Assembler::vpcmpeqd(K dst, Zmm x, Operand y) { this->op(0x66,0x0f,0x76, (Zmm)dst,x,y); }
+    void Assembler::vpcmpgtd(K dst, Zmm x, Operand y) { this->op(0x66,0x0f,0x66, (Zmm)dst,x,y); }
+
+    void Assembler::vcmpps(K dst, Zmm x, Operand y, int imm) {
+        this->op(0,0x0f,0xc2, (Zmm)dst,x,y);
+        this->imm_byte_after_operand(y, imm);
+    }
+
+    void Assembler::vpmovm2d(Zmm dst, K x) { this->op(0xf3,0x380f,0x38, dst,(Zmm)x); }
+
+    void Assembler::kxnorw(K dst, K x, K y) {
+        this->op(0,0x0f,0x46, (Ymm)dst,(Ymm)x,(Ymm)y);
+    }
+    void Assembler::kortestw(K x, K y) {
+        this->op(0,0x0f,0x98, (Xmm)x,(Xmm)y);
+    }
+
+    void Assembler::vrndscaleps(Zmm dst, Operand x, Rounding imm) {
+        this->op(0x66,0x3a0f,0x08, dst,x);
+        this->imm_byte_after_operand(x, imm);
+    }
+
+    void Assembler::vmovups(Zmm dst, Operand src) { this->op(0,0x0f,0x10, dst,src); }
+    void Assembler::vmovups(Operand dst, Zmm src) { this->op(0,0x0f,0x11, src,dst); }
+
+    void Assembler::vcvtdq2ps (Zmm dst, Operand x) { this->op(   0,0x0f,0x5b, dst,x); }
+    void Assembler::vcvttps2dq(Zmm dst, Operand x) { this->op(0xf3,0x0f,0x5b, dst,x); }
+    void Assembler::vcvtps2dq (Zmm dst, Operand x) { this->op(0x66,0x0f,0x5b, dst,x); }
+
+    void Assembler::vcvtps2ph(Operand dst, Zmm x, Rounding imm) {
+        this->op(0x66,0x3a0f,0x1d, x,dst, 32);
+        this->imm_byte_after_operand(dst, imm);
+    }
+    void Assembler::vcvtph2ps(Zmm dst, Operand x) { this->op(0x66,0x380f,0x13, dst,x, 32); }
+
+    void Assembler::vbroadcastss(Zmm dst, Operand y) { this->op(0x66,0x380f,0x18, dst,y, 4); }
+
+    void Assembler::vpmovzxwd(Zmm dst, Operand src) { this->op(0x66,0x380f,0x33, dst,src, 32); }
+    void Assembler::vpmovzxbd(Zmm dst, Operand src) { this->op(0x66,0x380f,0x31, dst,src, 16); }
+    void Assembler::vpmovdw  (Operand dst, Zmm src) { this->op(0xf3,0x380f,0x33, src,dst, 32); }
+    void Assembler::vpmovdb  (Operand dst, Zmm src) { this->op(0xf3,0x380f,0x31, src,dst, 16); }
+
+    void Assembler::vpermi2d(Zmm ix, Zmm x, Operand y) { this->op(0x66,0x380f,0x76, ix,x,y); }
+
+    void Assembler::vextracti32x4(Operand dst, Zmm src, int imm) {
+        this->op(0x66,0x3a0f,0x39, src,dst, 16);
+        SkASSERT(dst.kind != Operand::LABEL);
+        this->byte(imm);
+    }
+
+    // Gathers and scatters always use an SIB byte, with a vector register as the index.
+    void Assembler::vsib(int opcode, int reg, Scale scale, Zmm ix, GP64 base, int disp, K mask) {
+        SkASSERT(mask != k0);   // k0 can't be used as the mask here.
+        EVEX e = evex(W0, reg>>3, ix>>3, base>>3,
+                      0x380f, 0, 0x66, mask);
+        this->bytes(e.bytes, 4);
+        this->byte(opcode);
+        const Mod md = evex_mod(&disp, 4);
+        this->byte(mod_rm(md, reg&7, rsp/*use SIB*/));
+        this->byte(sib(scale, ix&7, base&7));
+        this->bytes(&disp, imm_bytes(md));
+    }
+
+    void Assembler::vpgatherdd(Zmm dst, Scale scale, Zmm ix, GP64 base, int disp, K mask) {
+        // As with vgatherdps, no aliasing is permitted.
+        SkASSERT(dst != ix);
+        this->vsib(0x90, dst, scale,ix,base,disp, mask);
+    }
+
+    void Assembler::vpscatterdd(Scale scale, Zmm ix, GP64 base, int disp, K mask, Zmm src) {
+        this->vsib(0xa0, src, scale,ix,base,disp, mask);
+    }
+
     // https://static.docs.arm.com/ddi0596/a/DDI_0596_ARM_a64_instruction_set_architecture.pdf
 
     static int operator"" _mask(unsigned long long bits) { return (1<<(int)bits)-1; }
@@ -2936,8 +3163,9 @@ namespace skvm {
     #endif
 
         fImpl->jit_entry.store(nullptr);
-        fImpl->jit_size  = 0;
-        fImpl->dylib     = nullptr;
+        fImpl->jit_size      = 0;
+        fImpl->jit_code_size = 0;
+        fImpl->dylib         = nullptr;
     }
 
     Program::Program() : fImpl(std::make_unique<Impl>()) {}
@@ -2958,8 +3186,10 @@ namespace skvm {
 
     Program::Program(const std::vector<OptimizedInstruction>& instructions,
                      const std::vector<int>& strides,
-                     const char* debug_name, bool allow_jit) : Program() {
-        fImpl->strides = strides;
+                     const char* debug_name, bool allow_jit, bool allow_avx512) : Program() {
+        fImpl->strides   = strides;
+        fImpl->optimized = instructions;
+        fImpl->avx512    = allow_avx512 && SkCpu::Supports(SkCpu::SKX);
         if (gSkVMAllowJIT && allow_jit) {
         #if 1 && defined(SKVM_LLVM)
             this->setupLLVM(instructions, debug_name);
@@ -2978,6 +3208,188 @@ namespace skvm {
     int  Program::loop () const { return fImpl->loop; }
     bool Program::empty() const { return fImpl->instructions.empty(); }
 
+    // ~~~~ Program serialization ~~~~ //
+    //
+    // Serialized Programs start with a header identifying the format and this build's list of
+    // Ops, and a checksum of everything that follows: the argument strides, the optimized
+    // instructions, and then optionally JIT machine code tagged with the target it was built for.
+    //
+    // We trust serialized Programs exactly as much as any other code we run, but still validate
+    // enough that a stale or truncated cache entry is rejected rather than misinterpreted.
+
+    static constexpr uint32_t kSerializedMagic   = 0x6d766b73,  // 'skvm'
+                              kSerializedVersion = 1;
+    static constexpr int kOpCount = 0
+    #define M(op) + 1
+        SKVM_OPS(M)
+    #undef M
+    ;
+
+    // What sort of machine code does Program::jit() generate with or without AVX-512?
+    // 0 means none.
+    static uint32_t jit_target(bool avx512) {
+    #if defined(SKVM_JIT) && !defined(SKVM_LLVM) && !defined(SKVM_JIT_BUT_IGNORE_IT)
+        uint32_t target = 0;
+        #if defined(__x86_64__) || defined(_M_X64)
+            if (!SkCpu::Supports(SkCpu::HSW)) {
+                return 0;
+            }
+            target = avx512 ? 2 : 1;
+        #elif defined(__aarch64__)
+            target = 3;
+        #endif
+        #if defined(SK_BUILD_FOR_WIN)
+            target |= 0x100;  // Windows has its own calling convention.
+        #endif
+        return target;
+    #else
+        return 0;
+    #endif
+    }
+
+    sk_sp<SkData> Program::serialize() const {
+        this->waitForLLVM();
+
+        SkDynamicMemoryWStream body;
+        body.write32((uint32_t)fImpl->strides.size());
+        for (int stride : fImpl->strides) {
+            body.write32((uint32_t)stride);
+        }
+
+        body.write32((uint32_t)fImpl->optimized.size());
+        for (const OptimizedInstruction& inst : fImpl->optimized) {
+            const int32_t fields[] = {
+                (int32_t)inst.op, inst.x, inst.y, inst.z, inst.w,
+                inst.immA, inst.immB, inst.immC, inst.death, inst.can_hoist,
+            };
+            body.write(fields, sizeof(fields));
+        }
+
+        // Code loaded from a dylib or built by LLVM lives elsewhere; just reJIT those next time.
+        const void* code = fImpl->jit_entry.load();
+        if (code && !fImpl->dylib && fImpl->jit_code_size && jit_target(fImpl->avx512)) {
+            body.write32(jit_target(fImpl->avx512));
+            body.write32((uint32_t)fImpl->jit_code_size);
+            body.write(code, fImpl->jit_code_size);
+        } else {
+            body.write32(0);
+        }
+
+        sk_sp<SkData> bodyData = body.detachAsData();
+        SkDynamicMemoryWStream out;
+        out.write32(kSerializedMagic);
+        out.write32(kSerializedVersion);
+        out.write32((uint32_t)kOpCount);
+        out.write32(SkOpts::hash(bodyData->data(), bodyData->size()));
+        out.write(bodyData->data(), bodyData->size());
+        return out.detachAsData();
+    }
+
+    bool Program::Deserialize(const void* data, size_t size, Program* program,
+                              const char* debug_name, bool allow_jit) {
+        constexpr size_t kHeaderSize = 4*sizeof(uint32_t);
+        if (!data || size < kHeaderSize) {
+            return false;
+        }
+        SkMemoryStream in(data, size, /*copyData=*/false);
+
+        uint32_t magic, version, opCount, checksum;
+        if (!in.readU32(&magic)    || magic   != kSerializedMagic   ||
+            !in.readU32(&version)  || version != kSerializedVersion ||
+            !in.readU32(&opCount)  || opCount != (uint32_t)kOpCount ||
+            !in.readU32(&checksum) ||
+            checksum != SkOpts::hash((const char*)data + kHeaderSize, size - kHeaderSize)) {
+            return false;
+        }
+
+        // Every count we read is checked against the bytes remaining before we allocate for it.
+        auto read_count = [&](size_t elementSize, uint32_t* count) {
+            return in.readU32(count) && (size_t)*count * elementSize <= in.getLength()
+                                                                      - in.getPosition();
+        };
+
+        uint32_t nargs;
+        if (!read_count(sizeof(int32_t), &nargs)) {
+            return false;
+        }
+        std::vector<int> strides(nargs);
+        for (int& stride : strides) {
+            int32_t v;
+            if (!in.readS32(&v) || v < 0) {
+                return false;
+            }
+            stride = v;
+        }
+
+        uint32_t ninstructions;
+        if (!read_count(10*sizeof(int32_t), &ninstructions)) {
+            return false;
+        }
+        std::vector<OptimizedInstruction> instructions(ninstructions);
+        for (Val id = 0; id < (Val)ninstructions; id++) {
+            int32_t f[10];
+            if (in.read(f, sizeof(f)) != sizeof(f)) {
+                return false;
+            }
+            OptimizedInstruction& inst = instructions[id];
+            inst = {(Op)f[0], f[1],f[2],f[3],f[4], f[5],f[6],f[7], f[8], f[9] != 0};
+
+            // Arguments must come earlier in the program, and values must be used before they die.
+            if (f[0] < 0 || f[0] >= kOpCount) {
+                return false;
+            }
+            for (Val arg : {inst.x, inst.y, inst.z, inst.w}) {
+                if (arg < NA || arg >= id) {
+                    return false;
+                }
+            }
+            if (inst.death < id || inst.death > (Val)ninstructions) {
+                return false;
+            }
+            // Ops that read or write through a program argument use immA to pick which.
+            if (Op::store8 <= inst.op && inst.op <= Op::array32 && inst.op != Op::index &&
+                    (inst.immA < 0 || inst.immA >= (int)nargs)) {
+                return false;
+            }
+        }
+
+        uint32_t target;
+        if (!in.readU32(&target)) {
+            return false;
+        }
+        const void* code = nullptr;
+        uint32_t code_size = 0;
+        if (target != 0) {
+            if (!read_count(1, &code_size)) {
+                return false;
+            }
+            code = (const char*)in.getMemoryBase() + in.getPosition();
+        }
+
+        if (!debug_name) {
+            debug_name = "skvm-jit-deserialized";
+        }
+
+        Program p;
+        p.fImpl->strides   = std::move(strides);
+        p.fImpl->optimized = instructions;
+        p.fImpl->avx512    = gSkVMJITAllowAVX512 && SkCpu::Supports(SkCpu::SKX);
+        if (gSkVMAllowJIT && allow_jit) {
+        #if 1 && defined(SKVM_LLVM)
+            p.setupLLVM(instructions, debug_name);
+        #elif 1 && defined(SKVM_JIT)
+            if (!code || target != jit_target(p.fImpl->avx512) || gSkVMJITViaDylib ||
+                    !p.setupJITFromCode(code, code_size, debug_name)) {
+                p.setupJIT(instructions, debug_name);
+            }
+        #endif
+        }
+        p.setupInterpreter(instructions);
+
+        *program = std::move(p);
+        return true;
+    }
+
     // Translate OptimizedInstructions to InterpreterInstructions.
     void Program::setupInterpreter(const std::vector<OptimizedInstruction>& instructions) {
         // Register each instruction is assigned to.
@@ -3098,6 +3510,10 @@ namespace skvm {
         SkTHashMap<int, A::Label> constants;    // Constants (mostly splats) share the same pool.
         A::Label                  iota;         // Varies per lane, for Op::index.
         A::Label                  load64_index; // Used to load low or high half of 64-bit lanes.
+        A::Label                  evens, odds,  // AVX-512 only: {0,2,4,...}, {1,3,5,...},
+                                  zip_lo,       // {0,16,1,17,...,7,23},
+                                  zip_hi,       // {8,24,9,25,...,15,31},
+                                  stride4;      // {0,4,8,...,60}.
 
         // The `regs` array tracks everything we know about each register's state:
         //   - NA:   empty
@@ -3117,7 +3533,10 @@ namespace skvm {
         if (!SkCpu::Supports(SkCpu::HSW)) {
             return false;
         }
-        const int K = 8;
+        // With AVX-512 we run 16 lanes at a time in zmm registers, otherwise 8 lanes in ymm.
+        // Either way the scalar tail loop uses the AVX code, which only looks at lane 0.
+        const bool avx512 = fImpl->avx512;
+        const int K = avx512 ? 16 : 8;
         #if defined(_M_X64)  // Important to check this first; clang-cl defines both.
             const A::GP64 N = A::rcx,
                         GP0 = A::rax,
@@ -3222,19 +3641,23 @@ namespace skvm {
         auto load_from_memory = [&](Reg r, Val v) {
             if (instructions[v].op == Op::splat) {
                 if (instructions[v].immA == 0) {
-                    a->vpxor(r,r,r);
+                    a->vpxor(r,r,r);  // VEX-encoded ops zero the top half of zmm registers too.
+                } else if (avx512) {
+                    a->vmovups((A::Zmm)r, constants.find(instructions[v].immA));
                 } else {
                     a->vmovups(r, constants.find(instructions[v].immA));
                 }
             } else {
                 SkASSERT(stack_slot[v] != NA);
-                a->vmovups(r, A::Mem{A::rsp, stack_slot[v]*K*4});
+                if (avx512) { a->vmovups((A::Zmm)r, A::Mem{A::rsp, stack_slot[v]*K*4}); }
+                else        { a->vmovups(        r, A::Mem{A::rsp, stack_slot[v]*K*4}); }
             }
         };
         auto store_to_stack = [&](Reg r, Val v) {
             SkASSERT(next_stack_slot < nstack_slots);
             stack_slot[v] = next_stack_slot++;
-            a->vmovups(A::Mem{A::rsp, stack_slot[v]*K*4}, r);
+            if (avx512) { a->vmovups(A::Mem{A::rsp, stack_slot[v]*K*4}, (A::Zmm)r); }
+            else        { a->vmovups(A::Mem{A::rsp, stack_slot[v]*K*4},         r); }
         };
     #elif defined(__aarch64__)
         const int K = 4;
@@ -3473,6 +3896,282 @@ namespace skvm {
             };
         #endif
 
+        #if defined(__x86_64__) || defined(_M_X64)
+            if (avx512 && !scalar) {
+                // Just like the AVX code below, but 16 lanes wide.  AVX-512 comparisons
+                // write to an opmask register; we use k1 as scratch, expanding it back
+                // into a vector mask right away.  All gathers and scatters use every lane.
+                using Z = A::Zmm;
+                auto zr   = [&](Val v) { return (Z)r(v); };
+                auto zdst = [&](Val hint1 = NA, Val hint2 = NA) { return (Z)dst(hint1, hint2); };
+                auto ztmp = [&]{ return (Z)alloc_tmp(); };
+                auto zfree = [&](Z tmp) { free_tmp((Reg)tmp); };
+
+                switch (op) {
+                    case Op::splat:
+                        (void)constants[immA];
+                        break;
+
+                    case Op::assert_true: {
+                        a->vpcmpeqd(A::k1, zr(x), &constants[0xffffffff]);
+                        a->kortestw(A::k1, A::k1);
+                        A::Label all_true;
+                        a->jc(&all_true);
+                        a->int3();
+                        a->label(&all_true);
+                    } break;
+
+                    case Op::store8:  a->vpmovdb(A::Mem{arg[immA]}, zr(x)); break;
+                    case Op::store16: a->vpmovdw(A::Mem{arg[immA]}, zr(x)); break;
+                    case Op::store32: a->vmovups(A::Mem{arg[immA]}, zr(x)); break;
+
+                    case Op::store64: {
+                        Z tmp = ztmp();
+                        a->vmovups (tmp, &zip_lo);
+                        a->vpermi2d(tmp, zr(x), any(y));  // {x0,y0,x1,y1,...,x7,y7}
+                        a->vmovups (A::Mem{arg[immA], 0}, tmp);
+                        a->vmovups (tmp, &zip_hi);
+                        a->vpermi2d(tmp, zr(x), any(y));  // {x8,y8,...,x15,y15}
+                        a->vmovups (A::Mem{arg[immA],64}, tmp);
+                        zfree(tmp);
+                    } break;
+
+                    case Op::store128: {
+                        Z ix = ztmp();
+                        a->vmovups(ix, &stride4);
+                        const Val vals[] = {x,y,z,w};
+                        for (int i = 0; i < 4; i++) {
+                            a->kxnorw(A::k1, A::k1, A::k1);
+                            a->vpscatterdd(A::FOUR, ix, arg[immA], 4*i, A::k1, zr(vals[i]));
+                        }
+                        zfree(ix);
+                    } break;
+
+                    case Op::load8:  a->vpmovzxbd(zdst(), A::Mem{arg[immA]}); break;
+                    case Op::load16: a->vpmovzxwd(zdst(), A::Mem{arg[immA]}); break;
+                    case Op::load32: a->vmovups  (zdst(), A::Mem{arg[immA]}); break;
+
+                    case Op::load64: {
+                        Z tmp = ztmp();
+                        a->vmovups (tmp, A::Mem{arg[immA]});
+                        a->vmovups (zdst(), immB ? &odds : &evens);
+                        a->vpermi2d(zdst(), tmp, A::Mem{arg[immA],64});
+                        zfree(tmp);
+                    } break;
+
+                    case Op::load128: {
+                        Z ix = ztmp();
+                        a->vmovups(ix, &stride4);
+                        a->kxnorw(A::k1, A::k1, A::k1);
+                        a->vpgatherdd(zdst(), A::FOUR, ix, arg[immA], 4*immB, A::k1);
+                        zfree(ix);
+                    } break;
+
+                    // There's no 8- or 16-bit gather, and a 32-bit gather could read past
+                    // the end of the buffer, so we pluck out each lane one at a time.
+                    case Op::gather8: {
+                        a->mov(GP0, A::Mem{arg[immA], immB});
+
+                        A::Xmm tmp = (A::Xmm)alloc_tmp(),
+                               d   = (A::Xmm)dst();
+                        for (int i = 0; i < 16; i++) {
+                            if (i % 4 == 0) {
+                                a->vextracti32x4(tmp, zr(x), i/4);
+                            }
+                            a->vpextrd(GP1, tmp, i%4);
+                            a->vpinsrb(d, d, A::Mem{GP0,0,GP1,A::ONE}, i);
+                        }
+                        a->vpmovzxbd(zdst(), d);
+                        free_tmp((Reg)tmp);
+                    } break;
+
+                    case Op::gather16: {
+                        a->mov(GP0, A::Mem{arg[immA], immB});
+
+                        A::Xmm tmp = (A::Xmm)alloc_tmp(),
+                               hi  = (A::Xmm)alloc_tmp(),
+                               lo  = (A::Xmm)dst();
+                        for (int i = 0; i < 16; i++) {
+                            if (i % 4 == 0) {
+                                a->vextracti32x4(tmp, zr(x), i/4);
+                            }
+                            a->vpextrd(GP1, tmp, i%4);
+                            A::Xmm half = i < 8 ? lo : hi;
+                            a->vpinsrw(half, half, A::Mem{GP0,0,GP1,A::TWO}, i%8);
+                        }
+                        a->vinserti128((A::Ymm)lo, (A::Ymm)lo, hi, 1);
+                        a->vpmovzxwd(zdst(), (A::Ymm)lo);
+                        free_tmp((Reg)tmp);
+                        free_tmp((Reg)hi);
+                    } break;
+
+                    case Op::gather32:
+                        a->mov(GP0, A::Mem{arg[immA], immB});
+                        a->kxnorw(A::k1, A::k1, A::k1);
+                        a->vpgatherdd(zdst(), A::FOUR, zr(x), GP0, 0, A::k1);
+                        break;
+
+                    case Op::uniform32: a->vbroadcastss(zdst(), A::Mem{arg[immA], immB});
+                                        break;
+
+                    case Op::array32: a->mov(GP0, A::Mem{arg[immA], immB});
+                                      a->vbroadcastss(zdst(), A::Mem{GP0, immC});
+                                      break;
+
+                    case Op::index: a->vmovd((A::Xmm)dst(), N);
+                                    a->vbroadcastss(zdst(), (A::Xmm)dst());
+                                    a->vpsubd(zdst(), zdst(), &iota);
+                                    break;
+
+                    case Op::add_f32:
+                        if (in_reg(x)) { a->vaddps(zdst(x), zr(x), any(y)); }
+                        else           { a->vaddps(zdst(y), zr(y), any(x)); }
+                                         break;
+
+                    case Op::mul_f32:
+                        if (in_reg(x)) { a->vmulps(zdst(x), zr(x), any(y)); }
+                        else           { a->vmulps(zdst(y), zr(y), any(x)); }
+                                         break;
+
+                    case Op::sub_f32: a->vsubps(zdst(x), zr(x), any(y)); break;
+                    case Op::div_f32: a->vdivps(zdst(x), zr(x), any(y)); break;
+                    case Op::min_f32: a->vminps(zdst(y), zr(y), any(x)); break;
+                    case Op::max_f32: a->vmaxps(zdst(y), zr(y), any(x)); break;
+
+                    case Op::fma_f32:
+                        if (try_alias(x)) { a->vfmadd132ps(zdst(x), zr(z), any(y)); } else
+                        if (try_alias(y)) { a->vfmadd213ps(zdst(y), zr(x), any(z)); } else
+                        if (try_alias(z)) { a->vfmadd231ps(zdst(z), zr(x), any(y)); } else
+                                          { a->vmovups    (zdst(), any(x));
+                                            a->vfmadd132ps(zdst(), zr(z), any(y)); }
+                                            break;
+
+                    case Op::fms_f32:
+                        if (try_alias(x)) { a->vfmsub132ps(zdst(x), zr(z), any(y)); } else
+                        if (try_alias(y)) { a->vfmsub213ps(zdst(y), zr(x), any(z)); } else
+                        if (try_alias(z)) { a->vfmsub231ps(zdst(z), zr(x), any(y)); } else
+                                          { a->vmovups    (zdst(), any(x));
+                                            a->vfmsub132ps(zdst(), zr(z), any(y)); }
+                                            break;
+
+                    case Op::fnma_f32:
+                        if (try_alias(x)) { a->vfnmadd132ps(zdst(x), zr(z), any(y)); } else
+                        if (try_alias(y)) { a->vfnmadd213ps(zdst(y), zr(x), any(z)); } else
+                        if (try_alias(z)) { a->vfnmadd231ps(zdst(z), zr(x), any(y)); } else
+                                          { a->vmovups     (zdst(), any(x));
+                                            a->vfnmadd132ps(zdst(), zr(z), any(y)); }
+                                            break;
+
+                    case Op::sqrt_f32:
+                        if (in_reg(x)) { a->vsqrtps(zdst(x),  zr(x)); }
+                        else           { a->vsqrtps(zdst(), any(x)); }
+                                         break;
+
+                    case Op::add_i32:
+                        if (in_reg(x)) { a->vpaddd(zdst(x), zr(x), any(y)); }
+                        else           { a->vpaddd(zdst(y), zr(y), any(x)); }
+                                         break;
+
+                    case Op::mul_i32:
+                        if (in_reg(x)) { a->vpmulld(zdst(x), zr(x), any(y)); }
+                        else           { a->vpmulld(zdst(y), zr(y), any(x)); }
+                                         break;
+
+                    case Op::sub_i32: a->vpsubd(zdst(x), zr(x), any(y)); break;
+
+                    case Op::bit_and:
+                        if (in_reg(x)) { a->vpandd(zdst(x), zr(x), any(y)); }
+                        else           { a->vpandd(zdst(y), zr(y), any(x)); }
+                                         break;
+                    case Op::bit_or:
+                        if (in_reg(x)) { a->vpord(zdst(x), zr(x), any(y)); }
+                        else           { a->vpord(zdst(y), zr(y), any(x)); }
+                                         break;
+                    case Op::bit_xor:
+                        if (in_reg(x)) { a->vpxord(zdst(x), zr(x), any(y)); }
+                        else           { a->vpxord(zdst(y), zr(y), any(x)); }
+                                         break;
+
+                    case Op::bit_clear: a->vpandnd(zdst(y), zr(y), any(x)); break;
+
+                    // vpternlogd's immediate is a truth table indexed by dst<<2 | x<<1 | y.
+                    case Op::select:
+                        if (try_alias(x)) { a->vpternlogd(zdst(x), zr(y), any(z), 0xca); } else
+                        if (try_alias(z)) { a->vpternlogd(zdst(z), zr(x), any(y), 0xb8); } else
+                                          { a->vmovups   (zdst(), any(x));
+                                            a->vpternlogd(zdst(), zr(y), any(z), 0xca); }
+                                            break;
+
+                    case Op::shl_i32: a->vpslld(zdst(x), zr(x), immA); break;
+                    case Op::shr_i32: a->vpsrld(zdst(x), zr(x), immA); break;
+                    case Op::sra_i32: a->vpsrad(zdst(x), zr(x), immA); break;
+
+                    case Op::eq_i32:
+                        if (in_reg(x)) { a->vpcmpeqd(A::k1, zr(x), any(y)); }
+                        else           { a->vpcmpeqd(A::k1, zr(y), any(x)); }
+                        a->vpmovm2d(zdst(x,y), A::k1);
+                        break;
+
+                    case Op::gt_i32: a->vpcmpgtd(A::k1, zr(x), any(y));
+                                     a->vpmovm2d(zdst(x,y), A::k1);
+                                     break;
+
+                    case Op::eq_f32:
+                        if (in_reg(x)) { a->vcmpeqps(A::k1, zr(x), any(y)); }
+                        else           { a->vcmpeqps(A::k1, zr(y), any(x)); }
+                        a->vpmovm2d(zdst(x,y), A::k1);
+                        break;
+
+                    case Op::neq_f32:
+                        if (in_reg(x)) { a->vcmpneqps(A::k1, zr(x), any(y)); }
+                        else           { a->vcmpneqps(A::k1, zr(y), any(x)); }
+                        a->vpmovm2d(zdst(x,y), A::k1);
+                        break;
+
+                    case Op:: gt_f32: a->vcmpltps(A::k1, zr(y), any(x));
+                                      a->vpmovm2d(zdst(x,y), A::k1);
+                                      break;
+                    case Op::gte_f32: a->vcmpleps(A::k1, zr(y), any(x));
+                                      a->vpmovm2d(zdst(x,y), A::k1);
+                                      break;
+
+                    case Op::ceil:
+                        if (in_reg(x)) { a->vrndscaleps(zdst(x),  zr(x), Assembler::CEIL); }
+                        else           { a->vrndscaleps(zdst(), any(x), Assembler::CEIL); }
+                                         break;
+
+                    case Op::floor:
+                        if (in_reg(x)) { a->vrndscaleps(zdst(x),  zr(x), Assembler::FLOOR); }
+                        else           { a->vrndscaleps(zdst(), any(x), Assembler::FLOOR); }
+                                         break;
+
+                    case Op::to_f32:
+                        if (in_reg(x)) { a->vcvtdq2ps(zdst(x),  zr(x)); }
+                        else           { a->vcvtdq2ps(zdst(), any(x)); }
+                                         break;
+
+                    case Op::trunc:
+                        if (in_reg(x)) { a->vcvttps2dq(zdst(x),  zr(x)); }
+                        else           { a->vcvttps2dq(zdst(), any(x)); }
+                                         break;
+
+                    case Op::round:
+                        if (in_reg(x)) { a->vcvtps2dq(zdst(x),  zr(x)); }
+                        else           { a->vcvtps2dq(zdst(), any(x)); }
+                                         break;
+
+                    case Op::to_fp16:
+                        a->vcvtps2ph(dst(x), zr(x), A::CURRENT);  // f32 zmm -> f16 ymm
+                        a->vpmovzxwd(zdst(), dst());              // f16 ymm -> f16 zmm
+                        break;
+
+                    case Op::from_fp16:
+                        a->vpmovdw  (dst(x), zr(x));  // f16 zmm -> f16 ymm
+                        a->vcvtph2ps(zdst(), dst());  // f16 ymm -> f32 zmm
+                        break;
+                }
+            } else
+        #endif
             switch (op) {
                 // Make sure splat constants can be found by load_from_memory() or any().
                 case Op::splat:
@@ -4214,6 +4913,21 @@ namespace skvm {
             }
         }
 
+        auto emit_index = [&](A::Label* label, std::initializer_list<int> ix) {
+            if (!label->references.empty()) {
+                a->align(4);
+                a->label(label);
+                for (int i : ix) {
+                    a->word(i);
+                }
+            }
+        };
+        emit_index(&evens,   { 0, 2, 4, 6,  8,10,12,14, 16,18,20,22, 24,26,28,30});
+        emit_index(&odds,    { 1, 3, 5, 7,  9,11,13,15, 17,19,21,23, 25,27,29,31});
+        emit_index(&zip_lo,  { 0,16, 1,17,  2,18, 3,19,  4,20, 5,21,  6,22, 7,23});
+        emit_index(&zip_hi,  { 8,24, 9,25, 10,26,11,27, 12,28,13,29, 14,30,15,31});
+        emit_index(&stride4, { 0, 4, 8,12, 16,20,24,28, 32,36,40,44, 48,52,56,60});
+
         if (!load64_index.references.empty()) {
             a->align(4);
             a->label(&load64_index);  // {0,2,4,6|1,3,5,7}
@@ -4243,6 +4957,7 @@ namespace skvm {
         a = Assembler{jit_entry};
         SkAssertResult(this->jit(instructions, &stack_hint, &registers_used, &a));
         SkASSERT(a.size() <= fImpl->jit_size);
+        fImpl->jit_code_size = a.size();
 
         // Remap as executable, and flush caches on platforms that need that.
         remap_as_executable(jit_entry, fImpl->jit_size);
@@ -4278,6 +4993,22 @@ namespace skvm {
         }
     #endif
     }
+
+    // Machine code from serialize() is position-independent, so we can just copy it into place.
+    bool Program::setupJITFromCode(const void* code, size_t size, const char* debug_name) {
+        if (size == 0) {
+            return false;
+        }
+        fImpl->jit_size = size;
+        void* jit_entry = alloc_jit_buffer(&fImpl->jit_size);
+        memcpy(jit_entry, code, size);
+        remap_as_executable(jit_entry, fImpl->jit_size);
+        notify_vtune(debug_name, jit_entry, fImpl->jit_size);
+
+        fImpl->jit_code_size = size;
+        fImpl->jit_entry.store(jit_entry);
+        return true;
+    }
 #endif
 
 }  // namespace skvm
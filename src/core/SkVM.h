@@ -10,6 +10,7 @@
 
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
 #include "include/private/SkMacros.h"
 #include "include/private/SkTArray.h"
@@ -17,6 +18,7 @@
 #include "src/core/SkVM_fwd.h"
 #include <vector>      // std::vector
 
+class SkData;
 class SkWStream;
 
 #if defined(SKVM_JIT_WHEN_POSSIBLE) && !defined(SK_BUILD_FOR_IOS)
@@ -61,6 +63,12 @@ namespace skvm {
             ymm0, ymm1, ymm2 , ymm3 , ymm4 , ymm5 , ymm6 , ymm7 ,
             ymm8, ymm9, ymm10, ymm11, ymm12, ymm13, ymm14, ymm15,
         };
+        enum Zmm {
+            zmm0, zmm1, zmm2 , zmm3 , zmm4 , zmm5 , zmm6 , zmm7 ,
+            zmm8, zmm9, zmm10, zmm11, zmm12, zmm13, zmm14, zmm15,
+        };
+        // AVX-512 opmask registers.  As a writemask, k0 means no masking.
+        enum K { k0, k1, k2, k3, k4, k5, k6, k7 };
 
         // X and V values match 5-bit encoding for each (nothing tricky).
         enum X {
@@ -115,6 +123,7 @@ namespace skvm {
             Operand(GP64   r) : reg  (r), kind(REG  ) {}
             Operand(Xmm    r) : reg  (r), kind(REG  ) {}
             Operand(Ymm    r) : reg  (r), kind(REG  ) {}
+            Operand(Zmm    r) : reg  (r), kind(REG  ) {}
             Operand(Mem    m) : mem  (m), kind(MEM  ) {}
             Operand(Label* l) : label(l), kind(LABEL) {}
         };
@@ -237,6 +246,93 @@ namespace skvm {
         // mask = 0;
         void vgatherdps(Ymm dst, Scale scale, Ymm ix, GP64 base, Ymm mask);
 
+        void vinserti128(Ymm dst, Ymm x, Operand y, int imm);  // dst = x; dst[imm] = y, 128-bit
+
+        // AVX-512: EVEX-encoded 512-bit operations on 16 32-bit lanes.
+        // Memory operands may be any alignment; lanes are as in the ymm versions above.
+        void vpandd (Zmm dst, Zmm x, Operand y);
+        void vpandnd(Zmm dst, Zmm x, Operand y);
+        void vpord  (Zmm dst, Zmm x, Operand y);
+        void vpxord (Zmm dst, Zmm x, Operand y);
+
+        // Any bitwise function of three inputs: dst = imm[dst<<2 | x<<1 | y], for each bit.
+        void vpternlogd(Zmm dst, Zmm x, Operand y, int imm);
+
+        void vpaddd (Zmm dst, Zmm x, Operand y);
+        void vpsubd (Zmm dst, Zmm x, Operand y);
+        void vpmulld(Zmm dst, Zmm x, Operand y);
+
+        void vaddps(Zmm dst, Zmm x, Operand y);
+        void vsubps(Zmm dst, Zmm x, Operand y);
+        void vmulps(Zmm dst, Zmm x, Operand y);
+        void vdivps(Zmm dst, Zmm x, Operand y);
+        void vminps(Zmm dst, Zmm x, Operand y);
+        void vmaxps(Zmm dst, Zmm x, Operand y);
+
+        void vsqrtps(Zmm dst, Operand x);
+
+        void vfmadd132ps(Zmm dst, Zmm x, Operand y);
+        void vfmadd213ps(Zmm dst, Zmm x, Operand y);
+        void vfmadd231ps(Zmm dst, Zmm x, Operand y);
+
+        void vfmsub132ps(Zmm dst, Zmm x, Operand y);
+        void vfmsub213ps(Zmm dst, Zmm x, Operand y);
+        void vfmsub231ps(Zmm dst, Zmm x, Operand y);
+
+        void vfnmadd132ps(Zmm dst, Zmm x, Operand y);
+        void vfnmadd213ps(Zmm dst, Zmm x, Operand y);
+        void vfnmadd231ps(Zmm dst, Zmm x, Operand y);
+
+        void vpslld(Zmm dst, Zmm x, int imm);
+        void vpsrld(Zmm dst, Zmm x, int imm);
+        void vpsrad(Zmm dst, Zmm x, int imm);
+
+        // Comparisons write one bit per lane to an opmask register.
+        void vpcmpeqd(K dst, Zmm x, Operand y);
+        void vpcmpgtd(K dst, Zmm x, Operand y);
+
+        void vcmpps   (K dst, Zmm x, Operand y, int imm);
+        void vcmpeqps (K dst, Zmm x, Operand y) { this->vcmpps(dst,x,y,0); }
+        void vcmpltps (K dst, Zmm x, Operand y) { this->vcmpps(dst,x,y,1); }
+        void vcmpleps (K dst, Zmm x, Operand y) { this->vcmpps(dst,x,y,2); }
+        void vcmpneqps(K dst, Zmm x, Operand y) { this->vcmpps(dst,x,y,4); }
+
+        void vpmovm2d(Zmm dst, K x);  // dst[i] = x[i] ? ~0 : 0
+
+        void kxnorw  (K dst, K x, K y);  // dst = ~(x^y), 16-bit; kxnorw(k,k,k) sets all lanes.
+        void kortestw(K x, K y);         // Sets ZF if (x|y) == 0, CF if (x|y) == 0xffff.
+
+        void vrndscaleps(Zmm dst, Operand x, Rounding);
+
+        void vmovups(Zmm dst, Operand x);
+        void vmovups(Operand dst, Zmm x);
+
+        void vcvtdq2ps (Zmm dst, Operand x);
+        void vcvttps2dq(Zmm dst, Operand x);
+        void vcvtps2dq (Zmm dst, Operand x);
+
+        void vcvtps2ph(Operand dst, Zmm x, Rounding);  // dst is Ymm or 256-bit memory.
+        void vcvtph2ps(Zmm dst, Operand x);            // x   is Ymm or 256-bit memory.
+
+        void vbroadcastss(Zmm dst, Operand y);         // y is Xmm or 32-bit memory.
+
+        void vpmovzxwd(Zmm dst, Operand src);   // dst = src, 256-bit, uint16_t -> int
+        void vpmovzxbd(Zmm dst, Operand src);   // dst = src, 128-bit, uint8_t  -> int
+        void vpmovdw  (Operand dst, Zmm src);   // dst = src, 256-bit, int -> uint16_t, truncating
+        void vpmovdb  (Operand dst, Zmm src);   // dst = src, 128-bit, int -> uint8_t,  truncating
+
+        void vpermi2d(Zmm ix, Zmm x, Operand y);  // ix[i] = {x,y}[ix[i] & 31]
+
+        void vextracti32x4(Operand dst, Zmm src, int imm);  // dst = src[imm], 128-bit
+
+        // if (mask[i]) { dst[i] = *(base + disp + scale*ix[i]); }
+        // mask = 0;
+        void vpgatherdd(Zmm dst, Scale scale, Zmm ix, GP64 base, int disp, K mask);
+
+        // if (mask[i]) { *(base + disp + scale*ix[i]) = src[i]; }
+        // mask = 0;
+        void vpscatterdd(Scale scale, Zmm ix, GP64 base, int disp, K mask, Zmm src);
+
 
         void label(Label*);
 
@@ -400,6 +496,17 @@ namespace skvm {
         void op(int p, int m, int o, Xmm d, Xmm x, Operand y, W w=W0) { op(p,m,o, d,x,y,w,L128); }
         void op(int p, int m, int o, Xmm d,        Operand y, W w=W0) { op(p,m,o, d,0,y,w,L128); }
 
+        // Helper for AVX-512 instructions, always 512-bit.  When a memory operand's displacement
+        // fits as a compressed 8-bit disp8*N, we use that; N is the size of the memory access.
+        void op(int prefix, int map, int opcode, int dst, int x, Operand y, W, int N, K mask);
+        void op(int p, int m, int o, Zmm d, Zmm x, Operand y, int N=64) {
+            op(p,m,o, d,x,y,W0,N,k0);
+        }
+        void op(int p, int m, int o, Zmm d,        Operand y, int N=64) {
+            op(p,m,o, d,0,y,W0,N,k0);
+        }
+        void vsib(int opcode, int reg, Scale, Zmm ix, GP64 base, int disp, K mask);
+
         // Helpers for GP64 instructions.
         void op(int opcode, Operand dst, GP64 x);
         void op(int opcode, int opcode_ext, Operand dst, int imm);
@@ -600,6 +707,9 @@ namespace skvm {
         explicit Builder(Features);
 
         Program done(const char* debug_name = nullptr, bool allow_jit=true) const;
+        // As above, but choosing whether the x86 JIT may run 16 lanes at a time with AVX-512
+        // rather than reading gSkVMJITAllowAVX512.
+        Program done(const char* debug_name, bool allow_jit, bool allow_avx512) const;
 
         // Mostly for debugging, tests, etc.
         std::vector<Instruction> program() const { return fProgram; }
@@ -997,7 +1107,7 @@ namespace skvm {
     public:
         Program(const std::vector<OptimizedInstruction>& instructions,
                 const std::vector<int>& strides,
-                const char* debug_name, bool allow_jit);
+                const char* debug_name, bool allow_jit, bool allow_avx512);
 
         Program();
         ~Program();
@@ -1028,9 +1138,21 @@ namespace skvm {
 
         void dump(SkWStream* = nullptr) const;
 
+        // Serialize this Program so it can be recreated by Deserialize(), e.g. in a later process.
+        // This always includes the optimized instructions, and if this Program has been JITted,
+        // its machine code, tagged with the kind of CPU it was compiled for.
+        sk_sp<SkData> serialize() const;
+
+        // Recreate a Program from serialize()'s output, skipping Builder::optimize(), and when the
+        // machine code was compiled for this same kind of CPU, skipping the JIT too.
+        // Returns false, leaving *program unchanged, if data isn't a valid serialized Program.
+        static bool Deserialize(const void* data, size_t size, Program* program,
+                                const char* debug_name = nullptr, bool allow_jit = true);
+
     private:
         void setupInterpreter(const std::vector<OptimizedInstruction>&);
         void setupJIT        (const std::vector<OptimizedInstruction>&, const char* debug_name);
+        bool setupJITFromCode(const void* code, size_t size, const char* debug_name);
         void setupLLVM       (const std::vector<OptimizedInstruction>&, const char* debug_name);
 
         bool jit(const std::vector<OptimizedInstruction>&,
@@ -5,8 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTime.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
@@ -554,42 +559,194 @@ SkVMBlitter::SkVMBlitter(const SkPixmap& device,
                          SkIPoint spriteOffset,
                          const SkMatrixProvider& matrices,
                          sk_sp<SkShader> clip,
+                         ProgramCache* cache,
                          bool* ok)
         : fDevice(device), fSprite(sprite ? *sprite : SkPixmap{})
         , fSpriteOffset(spriteOffset)
         , fUniforms(skvm::UPtr{{0}}, kBlitterUniformsCount)
         , fParams(EffectiveParams(device, sprite, paint, matrices, std::move(clip)))
-        , fKey(CacheKey(fParams, &fUniforms, &fAlloc, ok)) {}
+        , fKey(CacheKey(fParams, &fUniforms, &fAlloc, ok))
+        , fCache(cache ? cache : ProgramCache::Get()) {}
 
-SkVMBlitter::~SkVMBlitter() {
-    if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-        auto cache_program = [&](skvm::Program&& program, Coverage coverage) {
-            if (!program.empty()) {
-                cache->insert_or_update(fKey.withCoverage(coverage), std::move(program));
-            }
-        };
-        cache_program(std::move(fBlitH),         Coverage::Full);
-        cache_program(std::move(fBlitAntiH),     Coverage::UniformF);
-        cache_program(std::move(fBlitMaskA8),    Coverage::MaskA8);
-        cache_program(std::move(fBlitMask3D),    Coverage::Mask3D);
-        cache_program(std::move(fBlitMaskLCD16), Coverage::MaskLCD16);
+SkVMBlitter::~SkVMBlitter() {}
+
+// Each thread also keeps a small lookaside LRU of the programs it has used most recently from the
+// process-wide cache, so hot keys don't need the lock.  Any change to that cache that might drop
+// programs bumps fGeneration, which tells each thread to flush its lookaside the next time it
+// looks there.
+struct SkVMBlitter::ProgramCache::Lookaside {
+    static constexpr int kCount = 8;
+
+    uint32_t generation = 0;
+    SkLRUCache<Key, sk_sp<SharedProgram>> programs{kCount};
+};
+
+SkVMBlitter::ProgramCache* SkVMBlitter::ProgramCache::Get() {
+    static ProgramCache* cache = new ProgramCache(kDefaultCountLimit, /*useLookaside=*/true);
+    return cache;
+}
+
+SkVMBlitter::ProgramCache::ProgramCache(int countLimit)
+        : ProgramCache(countLimit, /*useLookaside=*/false) {}
+
+SkVMBlitter::ProgramCache::ProgramCache(int countLimit, bool useLookaside)
+        : fUseLookaside(useLookaside), fPrograms(std::max(countLimit, 0)) {}
+
+sk_sp<SkVMBlitter::SharedProgram> SkVMBlitter::ProgramCache::find(const Key& key) {
+    Lookaside* lookaside = this->lookaside();
+    if (lookaside) {
+        if (sk_sp<SharedProgram>* found = lookaside->programs.find(key)) {
+            fLookasideHits++;
+            return *found;
+        }
+    }
+
+    sk_sp<SharedProgram> program;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (sk_sp<SharedProgram>* found = fPrograms.find(key)) {
+            program = *found;
+        }
+    }
+    if (!program) {
+        fMisses++;
+        return nullptr;
+    }
+    fHits++;
+    if (lookaside) {
+        lookaside->programs.insert_or_update(key, program);
+    }
+    return program;
+}
 
-        ReleaseProgramCache();
+void SkVMBlitter::ProgramCache::insert(const Key& key, sk_sp<SharedProgram> program,
+                                       double compileNanos) {
+    fCompileNanos += (uint64_t)compileNanos;
+    if (Lookaside* lookaside = this->lookaside()) {
+        lookaside->programs.insert_or_update(key, program);
     }
+    SkAutoMutexExclusive lock(fMutex);
+    // Another thread may have raced us to compile the same key; either program is fine.
+    fPrograms.insert_or_update(key, std::move(program));
+}
+
+SkGraphics::VMProgramPersistentCache* SkVMBlitter::ProgramCache::setPersistentCache(
+        SkGraphics::VMProgramPersistentCache* persistent) {
+    return fPersistent.exchange(persistent);
+}
+
+// Key's hashes are stable from run to run, but bump this if its layout ever changes.
+static sk_sp<SkData> persistent_key(const void* key, size_t keySize) {
+    static constexpr uint32_t kVersion = 1;
+    sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(kVersion) + keySize);
+    memcpy(data->writable_data(), &kVersion, sizeof(kVersion));
+    memcpy(SkTAddOffset<void>(data->writable_data(), sizeof(kVersion)), key, keySize);
+    return data;
+}
+
+bool SkVMBlitter::ProgramCache::loadPersistent(const Key& key, skvm::Program* program) {
+    SkGraphics::VMProgramPersistentCache* persistent = fPersistent.load();
+    if (!persistent) {
+        return false;
+    }
+    sk_sp<SkData> data = persistent->load(*persistent_key(&key, sizeof(Key)));
+    if (data && skvm::Program::Deserialize(data->data(), data->size(), program,
+                                           DebugName(key).c_str())) {
+        fPersistentHits++;
+        return true;
+    }
+    return false;
+}
+
+void SkVMBlitter::ProgramCache::storePersistent(const Key& key, const skvm::Program& program) {
+    if (SkGraphics::VMProgramPersistentCache* persistent = fPersistent.load()) {
+        if (sk_sp<SkData> data = program.serialize()) {
+            persistent->store(*persistent_key(&key, sizeof(Key)), *data, DebugName(key));
+        }
+    }
+}
+
+int SkVMBlitter::ProgramCache::countLimit() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fPrograms.maxCount();
 }
 
-SkLRUCache<SkVMBlitter::Key, skvm::Program>* SkVMBlitter::TryAcquireProgramCache() {
-#if 1 && defined(SKVM_JIT)
-    thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-    return &cache;
+int SkVMBlitter::ProgramCache::setCountLimit(int count) {
+    count = std::max(count, 0);
+    SkAutoMutexExclusive lock(fMutex);
+    int prev = fPrograms.maxCount();
+    fPrograms.setMaxCount(count);
+    fGeneration++;
+    return prev;
+}
+
+int SkVMBlitter::ProgramCache::countUsed() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fPrograms.count();
+}
+
+void SkVMBlitter::ProgramCache::purge() {
+    SkAutoMutexExclusive lock(fMutex);
+    fPrograms.reset();
+    fGeneration++;
+}
+
+void SkVMBlitter::ProgramCache::dumpStatistics(SkTraceMemoryDump* dump) const {
+    static constexpr char kDumpName[] = "skia/sk_vm_program_cache";
+    dump->dumpNumericValue(kDumpName, "program_count", "objects", this->countUsed());
+    dump->dumpNumericValue(kDumpName, "budget_program_count", "objects", this->countLimit());
+    dump->dumpNumericValue(kDumpName, "hits", "objects", fHits.load());
+    dump->dumpNumericValue(kDumpName, "lookaside_hits", "objects", fLookasideHits.load());
+    dump->dumpNumericValue(kDumpName, "misses", "objects", fMisses.load());
+    dump->dumpNumericValue(kDumpName, "persistent_hits", "objects", fPersistentHits.load());
+    dump->dumpNumericValue(kDumpName, "compile_time", "nanoseconds", fCompileNanos.load());
+}
+
+SkVMBlitter::ProgramCache::Lookaside* SkVMBlitter::ProgramCache::lookaside() {
+#if defined(SKVM_JIT)
+    // The lookasides are per-thread, not per-cache, so only one cache may use them.
+    if (!fUseLookaside) {
+        return nullptr;
+    }
+    thread_local static Lookaside lookaside;
+    uint32_t generation = fGeneration.load(std::memory_order_acquire);
+    if (lookaside.generation != generation) {
+        lookaside.programs.reset();
+        lookaside.generation = generation;
+    }
+    return &lookaside;
 #else
     // iOS in particular does not support thread_local until iOS 9.0.
-        // On the other hand, we'll never be able to JIT there anyway.
-        // It's probably fine to not cache any interpreted programs, anywhere.
-        return nullptr;
+    // Everyone goes straight to the shared cache there.
+    return nullptr;
 #endif
 }
 
+int SkVMBlitter::GetProgramCacheCountLimit() {
+    return ProgramCache::Get()->countLimit();
+}
+
+int SkVMBlitter::SetProgramCacheCountLimit(int count) {
+    return ProgramCache::Get()->setCountLimit(count);
+}
+
+int SkVMBlitter::GetProgramCacheCountUsed() {
+    return ProgramCache::Get()->countUsed();
+}
+
+void SkVMBlitter::PurgeProgramCache() {
+    ProgramCache::Get()->purge();
+}
+
+void SkVMBlitter::DumpProgramCacheStatistics(SkTraceMemoryDump* dump) {
+    ProgramCache::Get()->dumpStatistics(dump);
+}
+
+SkGraphics::VMProgramPersistentCache* SkVMBlitter::SetProgramPersistentCache(
+        SkGraphics::VMProgramPersistentCache* persistent) {
+    return ProgramCache::Get()->setPersistentCache(persistent);
+}
+
 SkString SkVMBlitter::DebugName(const Key& key) {
     return SkStringPrintf("Shader-%" PRIx64 "_Clip-%" PRIx64 "_Blender-%" PRIx64
                           "_CS-%" PRIx64 "_CT-%d_AT-%d_Cov-%d",
@@ -602,22 +759,21 @@ SkString SkVMBlitter::DebugName(const Key& key) {
                           key.coverage);
 }
 
-void SkVMBlitter::ReleaseProgramCache() {}
-
-skvm::Program SkVMBlitter::buildProgram(Coverage coverage) {
+sk_sp<SkVMBlitter::SharedProgram> SkVMBlitter::buildProgram(Coverage coverage) {
     Key key = fKey.withCoverage(coverage);
-    {
-        skvm::Program p;
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            if (skvm::Program* found = cache->find(key)) {
-                p = std::move(*found);
-            }
-            ReleaseProgramCache();
-        }
-        if (!p.empty()) {
-            return p;
-        }
+    ProgramCache* cache = fCache;
+    if (sk_sp<SharedProgram> found = cache->find(key)) {
+        return found;
     }
+
+    const double start = SkTime::GetNSecs();
+    skvm::Program program;
+    if (cache->loadPersistent(key, &program)) {
+        auto shared = sk_make_sp<SharedProgram>(std::move(program));
+        cache->insert(key, shared, SkTime::GetNSecs() - start);
+        return shared;
+    }
+
     // We don't really _need_ to rebuild fUniforms here.
     // It's just more natural to have effects unconditionally emit them,
     // and more natural to rebuild fUniforms than to emit them into a temporary buffer.
@@ -629,7 +785,7 @@ skvm::Program SkVMBlitter::buildProgram(Coverage coverage) {
     SkASSERTF(fUniforms.buf.size() == prev,
               "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-    skvm::Program program = builder.done(DebugName(key).c_str());
+    program = builder.done(DebugName(key).c_str());
     if (false) {
         static std::atomic<int> missed{0},
                 total{0};
@@ -645,7 +801,10 @@ skvm::Program SkVMBlitter::buildProgram(Coverage coverage) {
                                 total.load(), missed.load()); });
         }
     }
-    return program;
+    cache->storePersistent(key, program);
+    auto shared = sk_make_sp<SharedProgram>(std::move(program));
+    cache->insert(key, shared, SkTime::GetNSecs() - start);
+    return shared;
 }
 
 void SkVMBlitter::updateUniforms(int right, int y) {
@@ -662,28 +821,30 @@ const void* SkVMBlitter::isSprite(int x, int y) const {
 }
 
 void SkVMBlitter::blitH(int x, int y, int w) {
-    if (fBlitH.empty()) {
+    if (!fBlitH) {
         fBlitH = this->buildProgram(Coverage::Full);
     }
+    const skvm::Program& program = fBlitH->program;
     this->updateUniforms(x+w, y);
     if (const void* sprite = this->isSprite(x,y)) {
-        fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
+        program.eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
     } else {
-        fBlitH.eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
+        program.eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
     }
 }
 
 void SkVMBlitter::blitAntiH(int x, int y, const SkAlpha cov[], const int16_t runs[]) {
-    if (fBlitAntiH.empty()) {
+    if (!fBlitAntiH) {
         fBlitAntiH = this->buildProgram(Coverage::UniformF);
     }
+    const skvm::Program& program = fBlitAntiH->program;
     for (int16_t run = *runs; run > 0; run = *runs) {
         this->updateUniforms(x+run, y);
         const float covF = *cov * (1/255.0f);
         if (const void* sprite = this->isSprite(x,y)) {
-            fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
+            program.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
         } else {
-            fBlitAntiH.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
+            program.eval(run, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
         }
         x    += run;
         runs += run;
@@ -701,24 +862,24 @@ void SkVMBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
         default: SkUNREACHABLE;     // ARGB and SDF masks shouldn't make it here.
 
         case SkMask::k3D_Format:
-            if (fBlitMask3D.empty()) {
+            if (!fBlitMask3D) {
                 fBlitMask3D = this->buildProgram(Coverage::Mask3D);
             }
-            program = &fBlitMask3D;
+            program = &fBlitMask3D->program;
             break;
 
         case SkMask::kA8_Format:
-            if (fBlitMaskA8.empty()) {
+            if (!fBlitMaskA8) {
                 fBlitMaskA8 = this->buildProgram(Coverage::MaskA8);
             }
-            program = &fBlitMaskA8;
+            program = &fBlitMaskA8->program;
             break;
 
         case SkMask::kLCD16_Format:
-            if (fBlitMaskLCD16.empty()) {
+            if (!fBlitMaskLCD16) {
                 fBlitMaskLCD16 = this->buildProgram(Coverage::MaskLCD16);
             }
-            program = &fBlitMaskLCD16;
+            program = &fBlitMaskLCD16->program;
             break;
     }
 
@@ -731,7 +892,7 @@ void SkVMBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
             auto  mptr = (const uint8_t*)mask.getAddr(x,y);
             this->updateUniforms(x+w,y);
 
-            if (program == &fBlitMask3D) {
+            if (mask.fFormat == SkMask::k3D_Format) {
                 size_t plane = mask.computeImageSize();
                 if (const void* sprite = this->isSprite(x,y)) {
                     program->eval(w, fUniforms.buf.data(), dptr, sprite, mptr + 1*plane
@@ -757,10 +918,12 @@ SkVMBlitter* SkVMBlitter::Make(const SkPixmap& device,
                                const SkPaint& paint,
                                const SkMatrixProvider& matrices,
                                SkArenaAlloc* alloc,
-                               sk_sp<SkShader> clip) {
+                               sk_sp<SkShader> clip,
+                               ProgramCache* cache) {
     bool ok = true;
     SkVMBlitter* blitter = alloc->make<SkVMBlitter>(
-            device, paint, /*sprite=*/nullptr, SkIPoint{0,0}, matrices, std::move(clip), &ok);
+            device, paint, /*sprite=*/nullptr, SkIPoint{0,0}, matrices, std::move(clip), cache,
+            &ok);
     return ok ? blitter : nullptr;
 }
 
@@ -769,7 +932,8 @@ SkVMBlitter* SkVMBlitter::Make(const SkPixmap& device,
                                const SkPixmap& sprite,
                                int left, int top,
                                SkArenaAlloc* alloc,
-                               sk_sp<SkShader> clip) {
+                               sk_sp<SkShader> clip,
+                               ProgramCache* cache) {
     if (paint.getMaskFilter()) {
         // TODO: SkVM support for mask filters?  definitely possible!
         return nullptr;
@@ -777,6 +941,6 @@ SkVMBlitter* SkVMBlitter::Make(const SkPixmap& device,
     bool ok = true;
     auto blitter = alloc->make<SkVMBlitter>(
             device, paint, &sprite, SkIPoint{left,top},
-            SkSimpleMatrixProvider{SkMatrix{}}, std::move(clip), &ok);
+            SkSimpleMatrixProvider{SkMatrix{}}, std::move(clip), cache, &ok);
     return ok ? blitter : nullptr;
 }
@@ -8,23 +8,35 @@
 #ifndef SkVMBlitter_DEFINED
 #define SkVMBlitter_DEFINED
 
+#include "include/core/SkGraphics.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkLRUCache.h"
 #include "src/core/SkVM.h"
 
+#include <atomic>
+
+class SkTraceMemoryDump;
+
 class SkVMBlitter final : public SkBlitter {
 public:
+    class ProgramCache;
+
+    // If cache is null, compiled programs are kept in the process-wide ProgramCache::Get().
     static SkVMBlitter* Make(const SkPixmap& dst,
                              const SkPaint&,
                              const SkMatrixProvider&,
                              SkArenaAlloc*,
-                             sk_sp<SkShader> clipShader);
+                             sk_sp<SkShader> clipShader,
+                             ProgramCache* cache = nullptr);
 
     static SkVMBlitter* Make(const SkPixmap& dst,
                              const SkPaint&,
                              const SkPixmap& sprite,
                              int left, int top,
                              SkArenaAlloc*,
-                             sk_sp<SkShader> clipShader);
+                             sk_sp<SkShader> clipShader,
+                             ProgramCache* cache = nullptr);
 
     SkVMBlitter(const SkPixmap& device,
                 const SkPaint& paint,
@@ -32,10 +44,21 @@ public:
                 SkIPoint spriteOffset,
                 const SkMatrixProvider& matrices,
                 sk_sp<SkShader> clip,
+                ProgramCache* cache,
                 bool* ok);
 
     ~SkVMBlitter() override;
 
+    // These act on the process-wide ProgramCache.
+    static int  GetProgramCacheCountLimit();
+    static int  SetProgramCacheCountLimit(int count);
+    static int  GetProgramCacheCountUsed();
+    static void PurgeProgramCache();
+    static void DumpProgramCacheStatistics(SkTraceMemoryDump*);
+
+    static SkGraphics::VMProgramPersistentCache* SetProgramPersistentCache(
+            SkGraphics::VMProgramPersistentCache*);
+
 private:
     enum class Coverage { Full, UniformF, MaskA8, MaskLCD16, Mask3D };
     struct Key {
@@ -56,6 +79,13 @@ private:
         Key withCoverage(Coverage c) const;
     };
 
+    // skvm::Program::eval() is const and thread-safe, so one compiled program
+    // can be used by any number of blitters on any number of threads at once.
+    struct SharedProgram : public SkNVRefCnt<SharedProgram> {
+        explicit SharedProgram(skvm::Program&& p) : program(std::move(p)) {}
+        const skvm::Program program;
+    };
+
     struct Params {
         sk_sp<SkShader>         shader;
         sk_sp<SkShader>         clip;
@@ -78,11 +108,9 @@ private:
                              skvm::Uniforms* uniforms, SkArenaAlloc* alloc);
     static Key CacheKey(const Params& params,
                         skvm::Uniforms* uniforms, SkArenaAlloc* alloc, bool* ok);
-    static SkLRUCache<Key, skvm::Program>* TryAcquireProgramCache();
     static SkString DebugName(const Key& key);
-    static void ReleaseProgramCache();
 
-    skvm::Program buildProgram(Coverage coverage);
+    sk_sp<SharedProgram> buildProgram(Coverage coverage);
     void updateUniforms(int right, int y);
     const void* isSprite(int x, int y) const;
 
@@ -97,10 +125,60 @@ private:
     SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
     const Params    fParams;
     const Key       fKey;
-    skvm::Program   fBlitH,
-                    fBlitAntiH,
-                    fBlitMaskA8,
-                    fBlitMask3D,
-                    fBlitMaskLCD16;
+    ProgramCache*   fCache;
+    sk_sp<SharedProgram> fBlitH,
+                         fBlitAntiH,
+                         fBlitMaskA8,
+                         fBlitMask3D,
+                         fBlitMaskLCD16;
 };
+
+// An LRU of compiled programs, shared by all threads.  Get() returns the process-wide cache that
+// draws use.  Tests can make their own to exercise a cache that nothing else touches.
+class SkVMBlitter::ProgramCache {
+public:
+    static constexpr int kDefaultCountLimit = 256;
+
+    static ProgramCache* Get();
+
+    explicit ProgramCache(int countLimit = kDefaultCountLimit);
+
+    int  countLimit() const;
+    int  setCountLimit(int count);  // Returns the previous limit.
+    int  countUsed() const;
+    void purge();
+    void dumpStatistics(SkTraceMemoryDump*) const;
+
+    // Programs missing from this cache are next looked for in this optional persistent cache.
+    // Returns the previous persistent cache.
+    SkGraphics::VMProgramPersistentCache* setPersistentCache(
+            SkGraphics::VMProgramPersistentCache*);
+
+private:
+    friend class SkVMBlitter;
+
+    struct Lookaside;
+
+    ProgramCache(int countLimit, bool useLookaside);
+
+    sk_sp<SharedProgram> find(const Key&);
+    void insert(const Key&, sk_sp<SharedProgram>, double compileNanos);
+    // Look for a program serialized by this or an earlier process.
+    bool loadPersistent(const Key&, skvm::Program*);
+    void storePersistent(const Key&, const skvm::Program&);
+    Lookaside* lookaside();
+
+    // Only the process-wide cache uses the per-thread lookasides, which hold its programs.
+    const bool                            fUseLookaside;
+    mutable SkMutex                       fMutex;
+    SkLRUCache<Key, sk_sp<SharedProgram>> fPrograms SK_GUARDED_BY(fMutex);
+    std::atomic<uint32_t>                 fGeneration{0};
+    std::atomic<SkGraphics::VMProgramPersistentCache*> fPersistent{nullptr};
+    std::atomic<uint64_t>                 fHits{0},
+                                          fLookasideHits{0},
+                                          fMisses{0},
+                                          fPersistentHits{0},
+                                          fCompileNanos{0};
+};
+
 #endif  // SkVMBlitter_DEFINED
@@ -96,6 +96,9 @@ public:
 
     size_t bytesWritten() const { return fWriter.bytesWritten(); }
 
+    // Fills in a uint32_t written earlier as a placeholder, at offset bytes into the buffer.
+    void overwriteUIntAt(size_t offset, uint32_t value) { fWriter.overwriteTAt(offset, value); }
+
     // Returns true iff all of the bytes written so far are stored in the initial storage
     // buffer provided in the constructor or the most recent call to reset.
     bool usingInitialStorage() const;
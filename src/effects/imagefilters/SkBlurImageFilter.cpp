@@ -8,20 +8,24 @@
 #include <algorithm>
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkTileMode.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkTFitsIn.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
 #include "include/private/SkVx.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkMathPriv.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/effects/imagefilters/SkImageFiltersPriv.h"
 
 #if SK_SUPPORT_GPU
 #include "src/gpu/GrTextureProxy.h"
@@ -787,63 +791,31 @@ sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, ctx.surfaceProps());
 }
 
-// TODO: Implement CPU backend for different fTileMode.
-sk_sp<SkSpecialImage> cpu_blur(
-        const SkImageFilter_Base::Context& ctx,
-        SkVector sigma, const sk_sp<SkSpecialImage> &input,
-        SkIRect srcBounds, SkIRect dstBounds) {
-    SkVector limitedSigma = {SkTPin(sigma.x(), 0.0f, 2183.0f), SkTPin(sigma.y(), 0.0f, 2183.0f)};
-
-    SkSTArenaAlloc<1024> alloc;
-    auto makeMaker = [&](double sigma) -> PassMaker* {
-        SkASSERT(0 <= sigma && sigma <= 2183);
-        if (PassMaker* maker = GaussPass::MakeMaker(sigma, &alloc)) {
-            return maker;
-        }
-        if (PassMaker* maker = TentPass::MakeMaker(sigma, &alloc)) {
-            return maker;
-        }
-        SK_ABORT("Sigma is out of range.");
-    };
-
-    PassMaker* makerX = makeMaker(limitedSigma.x());
-    PassMaker* makerY = makeMaker(limitedSigma.y());
-
-    if (makerX->window() <= 1 && makerY->window() <= 1) {
-        return copy_image_with_bounds(ctx, input, srcBounds, dstBounds);
-    }
-
-    SkBitmap inputBM;
-
-    if (!input->getROPixels(&inputBM)) {
-        return nullptr;
+PassMaker* make_maker(double sigma, SkArenaAlloc* alloc) {
+    SkASSERT(0 <= sigma && sigma <= 2183);
+    if (PassMaker* maker = GaussPass::MakeMaker(sigma, alloc)) {
+        return maker;
     }
-
-    if (inputBM.colorType() != kN32_SkColorType) {
-        return nullptr;
+    if (PassMaker* maker = TentPass::MakeMaker(sigma, alloc)) {
+        return maker;
     }
+    SK_ABORT("Sigma is out of range.");
+}
 
-    SkBitmap src;
-    inputBM.extractSubset(&src, srcBounds);
-
-    // Make everything relative to the destination bounds.
-    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
-    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
-
-    auto srcW = srcBounds.width(),
-         srcH = srcBounds.height(),
+// Blurs src, which covers srcBounds, into dst, which covers dstBounds.  Both are relative to
+// the top-left of dstBounds.
+bool blur_pixels(PassMaker* makerX, PassMaker* makerY, SkArenaAlloc* alloc,
+                 const SkBitmap& src, SkIRect srcBounds, SkIRect dstBounds, SkBitmap* dst) {
+    auto srcH = srcBounds.height(),
          dstW = dstBounds.width(),
          dstH = dstBounds.height();
 
-    SkImageInfo dstInfo = inputBM.info().makeWH(dstW, dstH);
-
-    SkBitmap dst;
-    if (!dst.tryAllocPixels(dstInfo)) {
-        return nullptr;
+    if (!dst->tryAllocPixels(src.info().makeWH(dstW, dstH))) {
+        return false;
     }
 
     size_t bufferSizeBytes = std::max(makerX->bufferSizeBytes(), makerY->bufferSizeBytes());
-    auto buffer = alloc.makeBytesAlignedTo(bufferSizeBytes, alignof(skvx::Vec<4, uint32_t>));
+    auto buffer = alloc->makeBytesAlignedTo(bufferSizeBytes, alignof(skvx::Vec<4, uint32_t>));
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -855,36 +827,36 @@ sk_sp<SkSpecialImage> cpu_blur(
     // will be adjusted while doing the horizontal blur.
     auto intermediateSrc = static_cast<uint32_t *>(src.getPixels());
     auto intermediateRowBytesAsPixels = src.rowBytesAsPixels();
-    auto intermediateWidth = srcW;
+    auto intermediateWidth = srcBounds.width();
 
     // Because the border is calculated before the fork of the GPU/CPU path. The border is
     // the maximum of the two rendering methods. In the case where sigma is zero, then the
     // src and dst left values are the same. If sigma is small resulting in a window size of
     // 1, then border calculations add some pixels which will always be zero. Inset the
     // destination by those zero pixels. This case is very rare.
-    auto intermediateDst = dst.getAddr32(srcBounds.left(), 0);
+    auto intermediateDst = dst->getAddr32(srcBounds.left(), 0);
 
     // The following code is executed very rarely, I have never seen it in a real web
     // page. If sigma is small but not zero then shared GPU/CPU border calculation
     // code adds extra pixels for the border. Just clear everything to clear those pixels.
     // This solution is overkill, but very simple.
     if (makerX->window() == 1 || makerY->window() == 1) {
-        dst.eraseColor(0);
+        dst->eraseColor(0);
     }
 
     if (makerX->window() > 1) {
-        Pass* pass = makerX->makePass(buffer, &alloc);
+        Pass* pass = makerX->makePass(buffer, alloc);
         // Make int64 to avoid overflow in multiplication below.
         int64_t shift = srcBounds.top() - dstBounds.top();
 
         // For the horizontal blur, starts part way down in anticipation of the vertical blur.
         // For a vertical sigma of zero shift should be zero. But, for small sigma,
         // shift may be > 0 but the vertical window could be 1.
-        intermediateSrc = static_cast<uint32_t *>(dst.getPixels())
-                          + (shift > 0 ? shift * dst.rowBytesAsPixels() : 0);
-        intermediateRowBytesAsPixels = dst.rowBytesAsPixels();
+        intermediateSrc = static_cast<uint32_t *>(dst->getPixels())
+                          + (shift > 0 ? shift * dst->rowBytesAsPixels() : 0);
+        intermediateRowBytesAsPixels = dst->rowBytesAsPixels();
         intermediateWidth = dstW;
-        intermediateDst = static_cast<uint32_t *>(dst.getPixels());
+        intermediateDst = static_cast<uint32_t *>(dst->getPixels());
 
         const uint32_t* srcCursor = static_cast<uint32_t*>(src.getPixels());
         uint32_t* dstCursor = intermediateSrc;
@@ -897,17 +869,149 @@ sk_sp<SkSpecialImage> cpu_blur(
     }
 
     if (makerY->window() > 1) {
-        Pass* pass = makerY->makePass(buffer, &alloc);
+        Pass* pass = makerY->makePass(buffer, alloc);
         const uint32_t* srcCursor = intermediateSrc;
         uint32_t* dstCursor = intermediateDst;
         for (auto x = 0; x < intermediateWidth; x++) {
             pass->blur(srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
                        srcCursor, intermediateRowBytesAsPixels,
-                       dstCursor, dst.rowBytesAsPixels());
+                       dstCursor, dst->rowBytesAsPixels());
             srcCursor += 1;
             dstCursor += 1;
         }
     }
+    return true;
+}
+
+// Large blurs are smooth enough to compute at a fraction of the resolution, like the GPU does.
+// We downsample by a power of two in each direction that keeps the blur's sigma at least
+// kMinDownsampledSigma, blur, and scale back up with a bicubic filter.  Downsampled blurs
+// differ from full resolution ones by at most a few units per channel.
+constexpr float kMinDownsampledSigma = 24;
+constexpr int   kMaxDownsample       = 16;
+
+int downsample_factor(float sigma) {
+    int scale = 1;
+    while (scale < kMaxDownsample && sigma >= 2 * scale * kMinDownsampledSigma) {
+        scale *= 2;
+    }
+    return scale;
+}
+
+// Averages each scaleX x scaleY block of src (transparent outside srcBounds) into one pixel of
+// dst, which must cover all of dstBounds once scaled up.
+void downsample(const SkBitmap& src, SkIRect srcBounds, int scaleX, int scaleY, SkBitmap* dst) {
+    using U32x4 = skvx::Vec<4, uint32_t>;
+    const int shift = SkPrevLog2(scaleX) + SkPrevLog2(scaleY);
+    const uint32_t round = (1 << shift) >> 1;
+
+    SkAutoTMalloc<U32x4> sums(dst->width());
+    for (int y = 0; y < dst->height(); y++) {
+        sk_bzero(sums.get(), sizeof(U32x4) * dst->width());
+
+        const int top    = std::max(y * scaleY, srcBounds.top()),
+                  bottom = std::min(y * scaleY + scaleY, srcBounds.bottom());
+        for (int sy = top; sy < bottom; sy++) {
+            const uint32_t* row = src.getAddr32(0, sy - srcBounds.top());
+            for (int sx = srcBounds.left(); sx < srcBounds.right(); sx++) {
+                sums[sx / scaleX] += skvx::cast<uint32_t>(
+                        skvx::Vec<4, uint8_t>::Load(row + (sx - srcBounds.left())));
+            }
+        }
+
+        uint32_t* out = dst->getAddr32(0, y);
+        for (int x = 0; x < dst->width(); x++) {
+            skvx::cast<uint8_t>((sums[x] + round) >> shift).store(out + x);
+        }
+    }
+}
+
+bool downsampled_blur(SkVector sigma, const SkBitmap& src, SkIRect srcBounds, SkIRect dstBounds,
+                      SkBitmap* dst) {
+    const int scaleX = downsample_factor(sigma.x()),
+              scaleY = downsample_factor(sigma.y()),
+              lowW   = (dstBounds.width()  + scaleX - 1) / scaleX,
+              lowH   = (dstBounds.height() + scaleY - 1) / scaleY;
+
+    SkBitmap low;
+    if (!low.tryAllocPixels(src.info().makeWH(lowW, lowH))) {
+        return false;
+    }
+    downsample(src, srcBounds, scaleX, scaleY, &low);
+
+    // The box filter we downsampled with has already blurred a little (variance (s^2-1)/12).
+    auto low_sigma = [](float sigma, int scale) {
+        return std::sqrt(std::max(sigma * sigma - (scale * scale - 1) / 12.0f, 0.0f)) / scale;
+    };
+    SkSTArenaAlloc<1024> alloc;
+    PassMaker* makerX = make_maker(low_sigma(sigma.x(), scaleX), &alloc);
+    PassMaker* makerY = make_maker(low_sigma(sigma.y(), scaleY), &alloc);
+
+    SkBitmap blurred;
+    const SkIRect lowBounds = SkIRect::MakeWH(lowW, lowH);
+    if (!blur_pixels(makerX, makerY, &alloc, low, lowBounds, lowBounds, &blurred)) {
+        return false;
+    }
+
+    if (!dst->tryAllocPixels(src.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return false;
+    }
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    SkCanvas(*dst).drawImageRect(blurred.asImage(),
+                                 SkRect::MakeWH(lowW * scaleX, lowH * scaleY),
+                                 SkSamplingOptions(SkCubicResampler::Mitchell()), &paint);
+    return true;
+}
+
+// Blurs src into dst as blur_pixels() does, but at reduced resolution if downsample is set and
+// sigma is large enough to allow it.
+bool cpu_blur_pixels(SkVector sigma, PassMaker* makerX, PassMaker* makerY, SkArenaAlloc* alloc,
+                     const SkBitmap& src, SkIRect srcBounds, SkIRect dstBounds, bool downsample,
+                     SkBitmap* dst) {
+    if (downsample && (downsample_factor(sigma.x()) > 1 || downsample_factor(sigma.y()) > 1)) {
+        return downsampled_blur(sigma, src, srcBounds, dstBounds, dst);
+    }
+    return blur_pixels(makerX, makerY, alloc, src, srcBounds, dstBounds, dst);
+}
+
+// TODO: Implement CPU backend for different fTileMode.
+sk_sp<SkSpecialImage> cpu_blur(
+        const SkImageFilter_Base::Context& ctx,
+        SkVector sigma, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds) {
+    SkVector limitedSigma = {SkTPin(sigma.x(), 0.0f, 2183.0f), SkTPin(sigma.y(), 0.0f, 2183.0f)};
+
+    SkSTArenaAlloc<1024> alloc;
+    PassMaker* makerX = make_maker(limitedSigma.x(), &alloc);
+    PassMaker* makerY = make_maker(limitedSigma.y(), &alloc);
+
+    if (makerX->window() <= 1 && makerY->window() <= 1) {
+        return copy_image_with_bounds(ctx, input, srcBounds, dstBounds);
+    }
+
+    SkBitmap inputBM;
+
+    if (!input->getROPixels(&inputBM)) {
+        return nullptr;
+    }
+
+    if (inputBM.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+
+    SkBitmap src;
+    inputBM.extractSubset(&src, srcBounds);
+
+    // Make everything relative to the destination bounds.
+    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
+    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
+
+    SkBitmap dst;
+    if (!cpu_blur_pixels(limitedSigma, makerX, makerY, &alloc, src, srcBounds, dstBounds,
+                         /*downsample=*/true, &dst)) {
+        return nullptr;
+    }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
                                                           dstBounds.height()),
@@ -915,6 +1019,15 @@ sk_sp<SkSpecialImage> cpu_blur(
 }
 }  // namespace
 
+bool SkImageFiltersPriv::BlurForTesting(SkVector sigma, const SkBitmap& src, SkIRect srcBounds,
+                                        SkIRect dstBounds, bool downsample, SkBitmap* dst) {
+    SkSTArenaAlloc<1024> alloc;
+    PassMaker* makerX = make_maker(sigma.x(), &alloc);
+    PassMaker* makerY = make_maker(sigma.y(), &alloc);
+    return cpu_blur_pixels(sigma, makerX, makerY, &alloc, src, srcBounds, dstBounds, downsample,
+                           dst);
+}
+
 // This rather arbitrary-looking value results in a maximum box blur kernel size
 // of 1000 pixels on the raster path, which matches the WebKit and Firefox
 // implementations. Since the GPU path does not compute a box blur, putting
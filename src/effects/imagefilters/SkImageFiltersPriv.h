@@ -0,0 +1,42 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFiltersPriv_DEFINED
+#define SkImageFiltersPriv_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+
+class SkBitmap;
+class SkImageFilter;
+
+// Entry points into the raster image filters' pixel loops, so tests and benches can compare
+// their fast paths against the reference implementations directly.
+class SkImageFiltersPriv {
+public:
+    // Blurs src (N32), which covers srcBounds, into dst, which covers dstBounds; both are relative
+    // to the top-left of dstBounds. If downsample is true, large sigmas are blurred at reduced
+    // resolution as SkImageFilters::Blur() does; otherwise always at full resolution.
+    static bool BlurForTesting(SkVector sigma, const SkBitmap& src, SkIRect srcBounds,
+                               SkIRect dstBounds, bool downsample, SkBitmap* dst);
+
+    // Applies filter, which must come from SkImageFilters::MatrixConvolution(), to all of src (N32)
+    // in raster, ignoring its input and crop rect. If fastInterior is true the interior takes the
+    // unchecked, banded and separable paths the filter normally uses; otherwise the general
+    // per-tap path.
+    static bool MatrixConvolutionForTesting(const SkImageFilter& filter, const SkBitmap& src,
+                                            bool fastInterior, SkBitmap* dst);
+
+    // Applies filter, which must come from one of the SkImageFilters lighting factories, to src
+    // (N32) in raster, with an identity CTM and ignoring its input and crop rect; dst covers
+    // bounds, in src's coordinates, which may extend past src. If batched is true the light is
+    // computed several pixels at a time as the filter normally does; otherwise one pixel at a time.
+    static bool LightingForTesting(const SkImageFilter& filter, const SkBitmap& src,
+                                   SkIRect bounds, bool batched, SkBitmap* dst);
+};
+
+#endif
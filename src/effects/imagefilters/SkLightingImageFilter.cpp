@@ -11,10 +11,13 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/effects/imagefilters/SkImageFiltersPriv.h"
 
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrRecordingContext.h"
@@ -63,18 +66,22 @@ static inline void shiftMatrixLeft(int m[9]) {
     m[7] = m[8];
 }
 
-static inline void fast_normalize(SkPoint3* vector) {
-    // add a tiny bit so we don't have to worry about divide-by-zero
-    SkScalar magSq = vector->dot(*vector) + SK_ScalarNearlyZero;
+static inline SkScalar fast_rsqrt(SkScalar magSq) {
 #if defined(_MSC_VER) && _MSC_VER >= 1920
     // Visual Studio 2019 has some kind of code-generation bug in release builds involving the
     // lighting math in this file. Using the portable rsqrt avoids the issue. This issue appears
     // to be specific to the collection of (inline) functions in this file that call into this
     // function, not with sk_float_rsqrt itself.
-    SkScalar scale = sk_float_rsqrt_portable(magSq);
+    return sk_float_rsqrt_portable(magSq);
 #else
-    SkScalar scale = sk_float_rsqrt(magSq);
+    return sk_float_rsqrt(magSq);
 #endif
+}
+
+static inline void fast_normalize(SkPoint3* vector) {
+    // add a tiny bit so we don't have to worry about divide-by-zero
+    SkScalar magSq = vector->dot(*vector) + SK_ScalarNearlyZero;
+    SkScalar scale = fast_rsqrt(magSq);
     vector->fX *= scale;
     vector->fY *= scale;
     vector->fZ *= scale;
@@ -165,6 +172,7 @@ public:
                             SkTPin(SkScalarRoundToInt(color.fY), 0, 255),
                             SkTPin(SkScalarRoundToInt(color.fZ), 0, 255));
     }
+    SkScalar kd() const { return fKD; }
 private:
     SkScalar fKD;
 };
@@ -189,6 +197,8 @@ public:
                             SkTPin(SkScalarRoundToInt(color.fY), 0, 255),
                             SkTPin(SkScalarRoundToInt(color.fZ), 0, 255));
     }
+    SkScalar ks() const { return fKS; }
+    SkScalar shininess() const { return fShininess; }
 private:
     SkScalar fKS;
     SkScalar fShininess;
@@ -372,21 +382,6 @@ static void lightBitmap(const BaseLightingType& lightingType,
     }
 }
 
-static void lightBitmap(const BaseLightingType& lightingType,
-                 const SkImageFilterLight* light,
-                 const SkBitmap& src,
-                 SkBitmap* dst,
-                 SkScalar surfaceScale,
-                 const SkIRect& bounds) {
-    if (src.bounds().contains(bounds)) {
-        lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    } else {
-        lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    }
-}
-
 namespace {
 enum BoundaryMode {
     kTopLeft_BoundaryMode,
@@ -420,6 +415,8 @@ protected:
 
     bool onAffectsTransparentBlack() const override { return true; }
 
+    friend class ::SkImageFiltersPriv;
+
     const SkImageFilterLight* light() const { return fLight.get(); }
     inline sk_sp<const SkImageFilterLight> refLight() const { return fLight; }
     SkScalar surfaceScale() const { return fSurfaceScale; }
@@ -1124,6 +1121,303 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// The raster filter works a row at a time: first the surface normals of the whole row, then the
+// light, kLanes pixels at once.  This follows the per-pixel math above exactly, without virtual
+// calls for every pixel.
+namespace {
+    static constexpr int kLanes = 4;
+    using F = skvx::Vec<kLanes, float>;
+    using I = skvx::Vec<kLanes, int>;
+
+    struct F3 {
+        F x, y, z;
+
+        F dot(const F3& o) const { return x * o.x + y * o.y + z * o.z; }
+    };
+
+    SK_ALWAYS_INLINE static F3 splat(const SkPoint3& p) { return {p.fX, p.fY, p.fZ}; }
+
+    SK_ALWAYS_INLINE static void fast_normalize(F3* v) {
+        F magSq = v->dot(*v) + SK_ScalarNearlyZero,
+          scale;
+        for (int i = 0; i < kLanes; i++) {
+            scale[i] = fast_rsqrt(magSq[i]);
+        }
+        v->x *= scale;
+        v->y *= scale;
+        v->z *= scale;
+    }
+
+    SK_ALWAYS_INLINE static F pow_lanes(const F& x, SkScalar y) {
+        F r;
+        for (int i = 0; i < kLanes; i++) {
+            r[i] = SkScalarPow(x[i], y);
+        }
+        return r;
+    }
+
+    // SkTPin(SkScalarRoundToInt(v), 0, hi), where hi <= 255.  Pinning v first makes truncating it
+    // the same as flooring it, and like sk_float_saturate2int(), NaN goes to the top.
+    SK_ALWAYS_INLINE static I round_pin(const F& v, const I& hi) {
+        F r = v + 0.5f;
+        r = skvx::if_then_else(r < 256.0f, r, F(256.0f));
+        r = skvx::if_then_else(r >   0.0f, r, F(  0.0f));
+        return skvx::min(skvx::cast<int>(r), hi);
+    }
+
+    SK_ALWAYS_INLINE static F3 to_light(const SkDistantLight& light, const F&, const F&,
+                                        const F&) {
+        return splat(light.direction());
+    }
+    SK_ALWAYS_INLINE static F3 to_light(const SkPointLight& light, const F& x, const F& y,
+                                        const F& z) {
+        const SkPoint3& loc = light.location();
+        F3 direction = {loc.fX - x, loc.fY - y, loc.fZ - z};
+        fast_normalize(&direction);
+        return direction;
+    }
+    SK_ALWAYS_INLINE static F3 to_light(const SkSpotLight& light, const F& x, const F& y,
+                                        const F& z) {
+        const SkPoint3& loc = light.location();
+        F3 direction = {loc.fX - x, loc.fY - y, loc.fZ - z};
+        fast_normalize(&direction);
+        return direction;
+    }
+
+    SK_ALWAYS_INLINE static F3 light_color(const SkDistantLight& light, const F3&) {
+        return splat(light.color());
+    }
+    SK_ALWAYS_INLINE static F3 light_color(const SkPointLight& light, const F3&) {
+        return splat(light.color());
+    }
+    SK_ALWAYS_INLINE static F3 light_color(const SkSpotLight& light, const F3& toLight) {
+        F cosAngle = -toLight.dot(splat(light.s())),
+          scale    = 0;
+        for (int i = 0; i < kLanes; i++) {
+            if (cosAngle[i] >= light.cosOuterConeAngle()) {
+                scale[i] = SkScalarPow(cosAngle[i], light.specularExponent());
+                if (cosAngle[i] < light.cosInnerConeAngle()) {
+                    scale[i] *= (cosAngle[i] - light.cosOuterConeAngle()) * light.coneScale();
+                }
+            }
+        }
+        const SkPoint3& color = light.color();
+        return {color.fX * scale, color.fY * scale, color.fZ * scale};
+    }
+
+    SK_ALWAYS_INLINE static skvx::Vec<kLanes, uint32_t> pack(const I& a, const I& r, const I& g,
+                                                             const I& b) {
+        return skvx::cast<uint32_t>(a) << SK_A32_SHIFT | skvx::cast<uint32_t>(r) << SK_R32_SHIFT |
+               skvx::cast<uint32_t>(g) << SK_G32_SHIFT | skvx::cast<uint32_t>(b) << SK_B32_SHIFT;
+    }
+
+    SK_ALWAYS_INLINE static skvx::Vec<kLanes, uint32_t> shade(const DiffuseLightingType& type,
+                                                              const F3& normal,
+                                                              const F3& toLight,
+                                                              const F3& lightColor) {
+        F colorScale = type.kd() * normal.dot(toLight);
+        return pack(I(255), round_pin(lightColor.x * colorScale, I(255)),
+                            round_pin(lightColor.y * colorScale, I(255)),
+                            round_pin(lightColor.z * colorScale, I(255)));
+    }
+
+    SK_ALWAYS_INLINE static skvx::Vec<kLanes, uint32_t> shade(const SpecularLightingType& type,
+                                                              const F3& normal,
+                                                              const F3& toLight,
+                                                              const F3& lightColor) {
+        F3 halfDir = {toLight.x, toLight.y, toLight.z + SK_Scalar1};
+        fast_normalize(&halfDir);
+        F colorScale = type.ks() * pow_lanes(normal.dot(halfDir), type.shininess());
+        F3 color = {lightColor.x * colorScale, lightColor.y * colorScale,
+                    lightColor.z * colorScale};
+        F maxComponent = skvx::if_then_else(color.x > color.y,
+                                            skvx::if_then_else(color.x > color.z, color.x,
+                                                                                  color.z),
+                                            skvx::if_then_else(color.y > color.z, color.y,
+                                                                                  color.z));
+        return pack(round_pin(maxComponent, I(255)), round_pin(color.x, I(255)),
+                                                     round_pin(color.y, I(255)),
+                                                     round_pin(color.z, I(255)));
+    }
+
+    // The alpha of src along row y of bounds, or 0 outside src.
+    static void fetch_alpha_row(const SkBitmap& src, int y, const SkIRect& bounds, int* row) {
+        for (int x = bounds.fLeft; x < bounds.fRight; x++) {
+            *row++ = src.bounds().contains(x, y) ? SkGetPackedA32(*src.getAddr32(x, y)) : 0;
+        }
+    }
+
+    // The Sobel filters of the *Normal() functions above, which each weight the center row or
+    // column twice its neighbors, leave out neighbors outside bounds, and scale the sum to match.
+    static SkScalar sobel_scale(int weights, bool bothSides) {
+        switch (weights) {
+            case 4:  return bothSides ? gOneQuarter : gOneHalf;
+            case 3:  return bothSides ? gOneThird   : gTwoThirds;
+            default: return bothSides ? gOneHalf    : SK_Scalar1;
+        }
+    }
+
+    template <class Light, class LightingType>
+    static void light_bitmap_batched(const LightingType& lightingType,
+                                     const Light& light,
+                                     const SkBitmap& src,
+                                     SkBitmap* dst,
+                                     SkScalar surfaceScale,
+                                     const SkIRect& bounds) {
+        const int width  = bounds.width(),
+                  height = bounds.height(),
+                  padded = SkAlign4(width);  // Room for the partial last vector.
+        static_assert(kLanes == 4, "padded assumes kLanes is 4");
+
+        // Three rows of alpha, and the x and y surface gradients and the normal of a row.
+        SkAutoTMalloc<int>   alpha(3 * width);
+        SkAutoTMalloc<float> scratch(5 * padded);
+        int* up   = alpha.get();
+        int* mid  = up  + width;
+        int* down = mid + width;
+        float* gx = scratch.get();
+        float* gy = gx + padded;
+        float* nx = gy + padded;
+        float* ny = nx + padded;
+        float* nz = ny + padded;
+        sk_bzero(scratch.get(), 5 * padded * sizeof(float));
+
+        fetch_alpha_row(src, bounds.fTop, bounds, mid);
+        for (int y = bounds.fTop; y < bounds.fBottom; y++) {
+            const bool hasUp   = y > bounds.fTop,
+                       hasDown = y + 1 < bounds.fBottom;
+            if (hasDown) {
+                fetch_alpha_row(src, y + 1, bounds, down);
+            }
+            const int* above = hasUp   ? up   : mid;
+            const int* below = hasDown ? down : mid;
+            const int rowWeights = 2 + hasUp + hasDown;
+
+            // Each gradient is a difference across x (or y) of up to three rows (or columns),
+            // weighted 1-2-1.  Only the first and last columns are missing a side.
+            auto gradient = [&](int x) {
+                const int l = std::max(x - 1, 0),
+                          r = std::min(x + 1, width - 1);
+                int dx = 2 * (mid[r] - mid[l]),
+                    dy = 2 * (below[x] - above[x]);
+                if (hasUp)   { dx += up[r]   - up[l];   }
+                if (hasDown) { dx += down[r] - down[l]; }
+                if (x > 0)         { dy += below[l] - above[l]; }
+                if (x < width - 1) { dy += below[r] - above[r]; }
+                const int columnWeights = 2 + (x > 0) + (x < width - 1);
+                gx[x] = dx * sobel_scale(rowWeights, l < x && x < r);
+                gy[x] = dy * sobel_scale(columnWeights, hasUp && hasDown);
+            };
+            gradient(0);
+            const SkScalar scaleX = sobel_scale(rowWeights, true),
+                           scaleY = sobel_scale(4, hasUp && hasDown);
+            int x = 1;
+            for (; x + kLanes < width; x += kLanes) {
+                I dx = 2 * (I::Load(mid + x + 1) - I::Load(mid + x - 1)),
+                  dy = (I::Load(below + x - 1) - I::Load(above + x - 1)) +
+                       (I::Load(below + x    ) - I::Load(above + x    )) * 2 +
+                       (I::Load(below + x + 1) - I::Load(above + x + 1));
+                if (hasUp)   { dx += I::Load(up   + x + 1) - I::Load(up   + x - 1); }
+                if (hasDown) { dx += I::Load(down + x + 1) - I::Load(down + x - 1); }
+                (skvx::cast<float>(dx) * scaleX).store(gx + x);
+                (skvx::cast<float>(dy) * scaleY).store(gy + x);
+            }
+            for (; x < width; x++) {
+                gradient(x);
+            }
+
+            // pointToNormal(), kLanes at a time.
+            for (x = 0; x < width; x += kLanes) {
+                F3 normal = {-F::Load(gx + x) * surfaceScale,
+                             -F::Load(gy + x) * surfaceScale,
+                             1};
+                fast_normalize(&normal);
+                normal.x.store(nx + x);
+                normal.y.store(ny + x);
+                normal.z.store(nz + x);
+            }
+
+            SkPMColor* dptr = dst->getAddr32(0, y - bounds.fTop);
+            for (x = 0; x < width; x += kLanes) {
+                F3 normal = {F::Load(nx + x), F::Load(ny + x), F::Load(nz + x)};
+                I z = 0;
+                for (int i = 0; i < kLanes && x + i < width; i++) {
+                    z[i] = mid[x + i];
+                }
+                F px = F(SkIntToScalar(bounds.fLeft + x)) + F{0, 1, 2, 3};
+                F3 toLight = to_light(light, px, F(SkIntToScalar(y)),
+                                      skvx::cast<float>(z) * surfaceScale);
+                auto colors = shade(lightingType, normal, toLight, light_color(light, toLight));
+                if (x + kLanes <= width) {
+                    colors.store(dptr + x);
+                } else {
+                    memcpy(dptr + x, &colors, (width - x) * sizeof(SkPMColor));
+                }
+            }
+
+            std::swap(up, mid);
+            std::swap(mid, down);
+        }
+    }
+}  // anonymous namespace
+
+template <class LightingType>
+static void lightBitmap(const LightingType& lightingType,
+                 const SkImageFilterLight* light,
+                 const SkBitmap& src,
+                 SkBitmap* dst,
+                 SkScalar surfaceScale,
+                 const SkIRect& bounds,
+                 bool batched = true) {
+    if (batched) {
+        switch (light->type()) {
+            case SkImageFilterLight::kDistant_LightType:
+                light_bitmap_batched(lightingType, static_cast<const SkDistantLight&>(*light),
+                                     src, dst, surfaceScale, bounds);
+                return;
+            case SkImageFilterLight::kPoint_LightType:
+                light_bitmap_batched(lightingType, static_cast<const SkPointLight&>(*light),
+                                     src, dst, surfaceScale, bounds);
+                return;
+            case SkImageFilterLight::kSpot_LightType:
+                light_bitmap_batched(lightingType, static_cast<const SkSpotLight&>(*light),
+                                     src, dst, surfaceScale, bounds);
+                return;
+        }
+    }
+    if (src.bounds().contains(bounds)) {
+        lightBitmap<UncheckedPixelFetcher>(
+            lightingType, light, src, dst, surfaceScale, bounds);
+    } else {
+        lightBitmap<DecalPixelFetcher>(
+            lightingType, light, src, dst, surfaceScale, bounds);
+    }
+}
+
+bool SkImageFiltersPriv::LightingForTesting(const SkImageFilter& filter, const SkBitmap& src,
+                                            SkIRect bounds, bool batched, SkBitmap* dst) {
+    const bool diffuse  = !strcmp(filter.getTypeName(), "SkDiffuseLightingImageFilter"),
+               specular = !strcmp(filter.getTypeName(), "SkSpecularLightingImageFilter");
+    if ((!diffuse && !specular) || src.colorType() != kN32_SkColorType || !src.getPixels() ||
+        bounds.width() < 2 || bounds.height() < 2 ||
+        !dst->tryAllocPixels(SkImageInfo::MakeN32Premul(bounds.width(), bounds.height()))) {
+        return false;
+    }
+    const auto& lighting = static_cast<const SkLightingImageFilterInternal&>(filter);
+    if (diffuse) {
+        const auto& d = static_cast<const SkDiffuseLightingImageFilter&>(filter);
+        lightBitmap(DiffuseLightingType(d.kd()), lighting.light(), src, dst,
+                    lighting.surfaceScale(), bounds, batched);
+    } else {
+        const auto& s = static_cast<const SkSpecularLightingImageFilter&>(filter);
+        lightBitmap(SpecularLightingType(s.ks(), s.shininess()), lighting.light(), src, dst,
+                    lighting.surfaceScale(), bounds, batched);
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SkImageFilterLight::flattenLight(SkWriteBuffer& buffer) const {
     // Write type first, then baseclass, then subclass.
     buffer.writeInt(this->type());
@@ -11,11 +11,15 @@
 #include "include/core/SkUnPreMultiply.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkNx.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/effects/imagefilters/SkImageFiltersPriv.h"
 
 #if SK_SUPPORT_GPU
 #include "src/gpu/GrRecordingContextPriv.h"
@@ -26,6 +30,37 @@
 
 namespace {
 
+// Finds x and y with kernel[cy * width + cx] == y[cy] * x[cx], if the kernel has rank one.
+static bool factor_kernel(const SkScalar* kernel, const SkISize& size, SkScalar* x, SkScalar* y) {
+    const int w = size.width(),
+              h = size.height();
+    int pivot = 0;
+    for (int i = 1; i < w * h; i++) {
+        if (SkScalarAbs(kernel[i]) > SkScalarAbs(kernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const SkScalar k = kernel[pivot];
+    if (k == 0) {
+        return false;
+    }
+    for (int cx = 0; cx < w; cx++) {
+        x[cx] = kernel[(pivot / w) * w + cx];
+    }
+    for (int cy = 0; cy < h; cy++) {
+        y[cy] = kernel[cy * w + pivot % w] / k;
+    }
+    const SkScalar tolerance = SkScalarAbs(k) * 1e-6f;
+    for (int cy = 0; cy < h; cy++) {
+        for (int cx = 0; cx < w; cx++) {
+            if (SkScalarAbs(y[cy] * x[cx] - kernel[cy * w + cx]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -42,6 +77,19 @@ public:
         size_t size = (size_t) sk_64_mul(fKernelSize.width(), fKernelSize.height());
         fKernel = new SkScalar[size];
         memcpy(fKernel, kernel, size * sizeof(SkScalar));
+
+        // Two 1D passes read w + h pixels per result rather than w * h, but pay to store and
+        // reload the intermediate, so only split kernels where that's a clear win.
+        const int w = fKernelSize.width(),
+                  h = fKernelSize.height();
+        if (w > 1 && h > 1 && w * h >= 2 * (w + h)) {
+            fKernelX.reset(w);
+            fKernelY.reset(h);
+            if (!factor_kernel(fKernel, fKernelSize, fKernelX.get(), fKernelY.get())) {
+                fKernelX.reset(0);
+                fKernelY.reset(0);
+            }
+        }
         SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
         SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
         SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
@@ -62,6 +110,7 @@ protected:
 
 private:
     friend void ::SkRegisterMatrixConvolutionImageFilterFlattenable();
+    friend class ::SkImageFiltersPriv;
     SK_FLATTENABLE_HOOKS(SkMatrixConvolutionImageFilter)
 
     SkISize     fKernelSize;
@@ -72,6 +121,10 @@ private:
     SkTileMode  fTileMode;
     bool        fConvolveAlpha;
 
+    // The row and column whose outer product is fKernel, when it has rank one, or else empty.
+    SkAutoTMalloc<SkScalar> fKernelX,
+                            fKernelY;
+
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
@@ -84,11 +137,29 @@ private:
                       SkIVector& offset,
                       const SkIRect& rect,
                       const SkIRect& bounds) const;
+    template <bool convolveAlpha>
+    void filterInteriorRows(const SkBitmap& src,
+                            SkBitmap* result,
+                            const SkIVector& offset,
+                            const SkIRect& rect) const;
+    template <bool convolveAlpha>
+    void filterSeparableRows(const SkBitmap& src,
+                             SkBitmap* result,
+                             const SkIVector& offset,
+                             const SkIRect& rect) const;
     void filterInteriorPixels(const SkBitmap& src,
                               SkBitmap* result,
                               SkIVector& offset,
                               const SkIRect& rect,
-                              const SkIRect& bounds) const;
+                              const SkIRect& bounds,
+                              bool fastInterior) const;
+    // Filters src, whose readable pixels are srcBounds, into dst, which it allocates to cover
+    // dstBounds; both are in src's coordinates. src must already be unpremultiplied when
+    // !fConvolveAlpha. fastInterior filters clamp and decal interiors without per-tap bounds
+    // checks, in bands of rows on the default SkExecutor, and as two 1D passes when the kernel
+    // separates; otherwise they take the general path.
+    bool filterBitmap(const SkBitmap& src, const SkIRect& srcBounds, const SkIRect& dstBounds,
+                      bool fastInterior, SkBitmap* dst) const;
     void filterBorderPixels(const SkBitmap& src,
                             SkBitmap* result,
                             SkIVector& offset,
@@ -140,6 +211,25 @@ public:
     }
 };
 
+// The SkPMColor from per-channel sums of the kernel times the source, as filterPixels() does.
+template <bool convolveAlpha>
+static inline SkPMColor finish_pixel(const Sk4f& sum, SkScalar gain, SkScalar bias,
+                                     SkPMColor src) {
+    const Sk4f v = sum * gain + bias;
+    int a = convolveAlpha ? SkTPin(SkScalarFloorToInt(v[SK_A32_SHIFT / 8]), 0, 255) : 255;
+    int r = SkTPin(SkScalarFloorToInt(v[SK_R32_SHIFT / 8]), 0, a);
+    int g = SkTPin(SkScalarFloorToInt(v[SK_G32_SHIFT / 8]), 0, a);
+    int b = SkTPin(SkScalarFloorToInt(v[SK_B32_SHIFT / 8]), 0, a);
+    if (!convolveAlpha) {
+        return SkPreMultiplyARGB(SkGetPackedA32(src), r, g, b);
+    }
+    return SkPackARGB32(a, r, g, b);
+}
+
+SK_ALWAYS_INLINE static Sk4f to_float4(SkPMColor px) {
+    return SkNx_cast<float>(Sk4b::Load(&px));
+}
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -288,11 +378,74 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     }
 }
 
+// Like filterPixels<UncheckedPixelFetcher>(), but summing all four channels at once.
+template <bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterInteriorRows(const SkBitmap& src,
+                                                        SkBitmap* result,
+                                                        const SkIVector& offset,
+                                                        const SkIRect& rect) const {
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            Sk4f sum = 0;
+            const SkScalar* k = fKernel;
+            for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+                const SkPMColor* sptr = src.getAddr32(x - fKernelOffset.fX,
+                                                      y + cy - fKernelOffset.fY);
+                for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                    sum += to_float4(sptr[cx]) * *k++;
+                }
+            }
+            *dptr++ = finish_pixel<convolveAlpha>(sum, fGain, fBias, *src.getAddr32(x, y));
+        }
+    }
+}
+
+// As filterInteriorRows(), for a rank one kernel: first convolve each source row the rect reads
+// with fKernelX, then convolve those results down each column with fKernelY.
+template <bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterSeparableRows(const SkBitmap& src,
+                                                         SkBitmap* result,
+                                                         const SkIVector& offset,
+                                                         const SkIRect& rect) const {
+    const int width = rect.width(),
+              rows  = rect.height() + fKernelSize.fHeight - 1;
+    SkAutoTMalloc<float> storage(4 * width * rows);
+    float* tmp = storage.get();
+
+    for (int i = 0; i < rows; ++i) {
+        const SkPMColor* sptr = src.getAddr32(rect.fLeft - fKernelOffset.fX,
+                                              rect.fTop - fKernelOffset.fY + i);
+        float* row = tmp + 4 * width * i;
+        for (int x = 0; x < width; ++x) {
+            Sk4f sum = 0;
+            for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                sum += to_float4(sptr[x + cx]) * fKernelX[cx];
+            }
+            sum.store(row + 4 * x);
+        }
+    }
+
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+        const float* column = tmp + 4 * width * (y - rect.fTop);
+        for (int x = 0; x < width; ++x) {
+            Sk4f sum = 0;
+            for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+                sum += Sk4f::Load(column + 4 * (width * cy + x)) * fKernelY[cy];
+            }
+            *dptr++ = finish_pixel<convolveAlpha>(sum, fGain, fBias,
+                                                  *src.getAddr32(rect.fLeft + x, y));
+        }
+    }
+}
+
 void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
                                                           SkBitmap* result,
                                                           SkIVector& offset,
                                                           const SkIRect& rect,
-                                                          const SkIRect& bounds) const {
+                                                          const SkIRect& bounds,
+                                                          bool fastInterior) const {
     switch (fTileMode) {
         case SkTileMode::kMirror:
             // TODO (michaelludwig) - Implement mirror tiling, treat as repeat for now.
@@ -302,9 +455,34 @@ void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
             break;
         case SkTileMode::kClamp:
             // Fall through
-        case SkTileMode::kDecal:
-            filterPixels<UncheckedPixelFetcher>(src, result, offset, rect, bounds);
+        case SkTileMode::kDecal: {
+            if (!fastInterior) {
+                filterPixels<UncheckedPixelFetcher>(src, result, offset, rect, bounds);
+                break;
+            }
+            SkIRect interior = rect;
+            if (!interior.intersect(bounds)) {
+                break;
+            }
+            // Each band writes its own rows of result, so they can run concurrently.
+            static constexpr int kBandRows = 32;
+            const bool separable = fKernelX.get() != nullptr;
+            SkTaskGroup bands;
+            bands.batch((interior.height() + kBandRows - 1) / kBandRows, [&](int i) {
+                SkIRect band = interior;
+                band.fTop    = interior.fTop + i * kBandRows;
+                band.fBottom = std::min(band.fTop + kBandRows, interior.fBottom);
+                if (separable) {
+                    fConvolveAlpha ? this->filterSeparableRows<true >(src, result, offset, band)
+                                   : this->filterSeparableRows<false>(src, result, offset, band);
+                } else {
+                    fConvolveAlpha ? this->filterInteriorRows<true >(src, result, offset, band)
+                                   : this->filterInteriorRows<false>(src, result, offset, band);
+                }
+            });
+            bands.wait();
             break;
+        }
     }
 }
 
@@ -427,18 +605,28 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(const Contex
         return nullptr;
     }
 
-    const SkImageInfo info = SkImageInfo::MakeN32(dstBounds.width(), dstBounds.height(),
-                                                  inputBM.alphaType());
+    offset->fX = dstBounds.fLeft;
+    offset->fY = dstBounds.fTop;
+    dstBounds.offset(-inputOffset);
+    srcBounds.offset(-inputOffset);
 
     SkBitmap dst;
-    if (!dst.tryAllocPixels(info)) {
+    if (!this->filterBitmap(inputBM, srcBounds, dstBounds, /*fastInterior=*/true, &dst)) {
         return nullptr;
     }
 
-    offset->fX = dstBounds.fLeft;
-    offset->fY = dstBounds.fTop;
-    dstBounds.offset(-inputOffset);
-    srcBounds.offset(-inputOffset);
+    return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(), dstBounds.height()),
+                                          dst, ctx.surfaceProps());
+}
+
+bool SkMatrixConvolutionImageFilter::filterBitmap(const SkBitmap& src, const SkIRect& srcBounds,
+                                                  const SkIRect& dstBounds, bool fastInterior,
+                                                  SkBitmap* dst) const {
+    const SkImageInfo info = SkImageInfo::MakeN32(dstBounds.width(), dstBounds.height(),
+                                                  src.alphaType());
+    if (!dst->tryAllocPixels(info)) {
+        return false;
+    }
 
     SkIRect interior;
     if (SkTileMode::kRepeat == fTileMode || SkTileMode::kMirror == fTileMode) {
@@ -461,16 +649,35 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(const Contex
     SkIRect right = SkIRect::MakeLTRB(interior.right(), interior.top(),
                                       dstBounds.right(), interior.bottom());
 
-    SkIVector dstContentOffset = { offset->fX - inputOffset.fX, offset->fY - inputOffset.fY };
+    SkIVector dstContentOffset = { dstBounds.fLeft, dstBounds.fTop };
 
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, top, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, left, srcBounds);
-    this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, right, srcBounds);
-    this->filterBorderPixels(inputBM, &dst, dstContentOffset, bottom, srcBounds);
+    this->filterBorderPixels(src, dst, dstContentOffset, top, srcBounds);
+    this->filterBorderPixels(src, dst, dstContentOffset, left, srcBounds);
+    this->filterInteriorPixels(src, dst, dstContentOffset, interior, srcBounds, fastInterior);
+    this->filterBorderPixels(src, dst, dstContentOffset, right, srcBounds);
+    this->filterBorderPixels(src, dst, dstContentOffset, bottom, srcBounds);
+    return true;
+}
 
-    return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(), dstBounds.height()),
-                                          dst, ctx.surfaceProps());
+bool SkImageFiltersPriv::MatrixConvolutionForTesting(const SkImageFilter& filter,
+                                                     const SkBitmap& src, bool fastInterior,
+                                                     SkBitmap* dst) {
+    if (strcmp(filter.getTypeName(), "SkMatrixConvolutionImageFilter") != 0 ||
+        src.colorType() != kN32_SkColorType || !src.getPixels()) {
+        return false;
+    }
+    const auto& conv = static_cast<const SkMatrixConvolutionImageFilter&>(filter);
+
+    SkBitmap input = src;
+    if (!conv.fConvolveAlpha && !src.isOpaque()) {
+        // Unpremultiply a copy, as onFilterImage() does to its input in place.
+        if (!input.tryAllocPixels(src.info()) ||
+            !src.readPixels(src.info().makeAlphaType(kUnpremul_SkAlphaType),
+                            input.getPixels(), input.rowBytes(), 0, 0)) {
+            return false;
+        }
+    }
+    return conv.filterBitmap(input, src.bounds(), src.bounds(), fastInterior, dst);
 }
 
 SkIRect SkMatrixConvolutionImageFilter::onFilterNodeBounds(
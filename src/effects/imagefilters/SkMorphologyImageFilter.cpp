@@ -9,6 +9,7 @@
 #include "include/core/SkRect.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkTemplates.h"
 #include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -501,72 +502,73 @@ static sk_sp<SkSpecialImage> apply_morphology(
 
 namespace {
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                __m128i extreme = (type == MorphType::kDilate) ? _mm_setzero_si128()
-                                                               : _mm_set1_epi32(0xFFFFFFFF);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    __m128i src_pixel = _mm_cvtsi32_si128(*p);
-                    extreme = (type == MorphType::kDilate) ? _mm_max_epu8(src_pixel, extreme)
-                                                           : _mm_min_epu8(src_pixel, extreme);
-                }
-                *dptr = _mm_cvtsi128_si32(extreme);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
+    // Dilate and erode take the per-channel max or min of the pixels within radius of each
+    // pixel along a line, clamped to the line.  We use the van Herk/Gil-Werman algorithm, which
+    // costs the same per pixel at any radius: pad the line with radius identity pixels on each
+    // side, split it into blocks the size of the window, and find the running extremes forward
+    // from the start of each block (g) and backward from its end (h).  Every window then spans at
+    // most two blocks, and its extreme is that of h at its start and g at its end.
+    //
+    // We filter kLines lines at once, one per pixel of a vector.  For the Y pass these are
+    // adjacent columns, so each step loads and stores kLines contiguous pixels, and we work
+    // through kYGroups of them side by side rather than transposing the image.
+    static constexpr int kLines = 8;
+    using Px = skvx::Vec<4 * kLines, uint8_t>;
+    static constexpr int kYGroups = 8;
+
+    // skvx::max() and min() of bytes can compile to compares and blends; say what we mean.
+    template <MorphType type>
+    SK_ALWAYS_INLINE static Px extreme(const Px& a, const Px& b) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        __m256i x = skvx::bit_pun<__m256i>(a),
+                y = skvx::bit_pun<__m256i>(b);
+        return skvx::bit_pun<Px>(type == MorphType::kDilate ? _mm256_max_epu8(x, y)
+                                                            : _mm256_min_epu8(x, y));
+    #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        auto half = [](const skvx::Vec<16, uint8_t>& l, const skvx::Vec<16, uint8_t>& r) {
+            __m128i x = skvx::bit_pun<__m128i>(l),
+                    y = skvx::bit_pun<__m128i>(r);
+            return skvx::bit_pun<skvx::Vec<16, uint8_t>>(
+                    type == MorphType::kDilate ? _mm_max_epu8(x, y) : _mm_min_epu8(x, y));
+        };
+        return skvx::join(half(a.lo, b.lo), half(a.hi, b.hi));
+    #elif defined(SK_ARM_HAS_NEON)
+        auto half = [](const skvx::Vec<16, uint8_t>& l, const skvx::Vec<16, uint8_t>& r) {
+            uint8x16_t x = skvx::bit_pun<uint8x16_t>(l),
+                       y = skvx::bit_pun<uint8x16_t>(r);
+            return skvx::bit_pun<skvx::Vec<16, uint8_t>>(
+                    type == MorphType::kDilate ? vmaxq_u8(x, y) : vminq_u8(x, y));
+        };
+        return skvx::join(half(a.lo, b.lo), half(a.hi, b.hi));
+    #else
+        return type == MorphType::kDilate ? skvx::max(a, b) : skvx::min(a, b);
+    #endif
+    }
+
+    SK_ALWAYS_INLINE static Px load_lines(const SkPMColor* src, int strideAcross, int lines) {
+        if (lines == kLines && strideAcross == 1) {
+            return Px::Load(src);
         }
+        SkPMColor px[kLines] = {};
+        for (int i = 0; i < lines; ++i) {
+            px[i] = src[i * strideAcross];
+        }
+        return Px::Load(px);
     }
 
-#elif defined(SK_ARM_HAS_NEON)
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                uint8x8_t extreme = vdup_n_u8(type == MorphType::kDilate ? 0 : 255);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    uint8x8_t src_pixel = vreinterpret_u8_u32(vdup_n_u32(*p));
-                    extreme = (type == MorphType::kDilate) ? vmax_u8(src_pixel, extreme)
-                                                           : vmin_u8(src_pixel, extreme);
-                }
-                *dptr = vget_lane_u32(vreinterpret_u32_u8(extreme), 0);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) src += srcStrideX;
-            if (x + radius < width - 1) upperSrc += srcStrideX;
-            dst += dstStrideX;
+    SK_ALWAYS_INLINE static void store_lines(const Px& v, SkPMColor* dst, int strideAcross,
+                                             int lines) {
+        if (lines == kLines && strideAcross == 1) {
+            v.store(dst);
+            return;
+        }
+        SkPMColor px[kLines];
+        v.store(px);
+        for (int i = 0; i < lines; ++i) {
+            dst[i * strideAcross] = px[i];
         }
     }
 
-#else
     template<MorphType type, MorphDirection direction>
     static void morph(const SkPMColor* src, SkPMColor* dst,
                       int radius, int width, int height, int srcStride, int dstStride) {
@@ -575,43 +577,62 @@ namespace {
         const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
         const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
         radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                // If we're maxing (dilate), start from 0; if minning (erode), start from 255.
-                const int start = (type == MorphType::kDilate) ? 0 : 255;
-                int B = start, G = start, R = start, A = start;
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    int b = SkGetPackedB32(*p),
-                        g = SkGetPackedG32(*p),
-                        r = SkGetPackedR32(*p),
-                        a = SkGetPackedA32(*p);
-                    if (type == MorphType::kDilate) {
-                        B = std::max(b, B);
-                        G = std::max(g, G);
-                        R = std::max(r, R);
-                        A = std::max(a, A);
-                    } else {
-                        B = std::min(b, B);
-                        G = std::min(g, G);
-                        R = std::min(r, R);
-                        A = std::min(a, A);
+
+        // The Y pass walks a strip of several groups of columns down the image together, so each
+        // step reads and writes whole cache lines of every row.
+        const int groups = direction == MorphDirection::kX ? 1 : kYGroups;
+
+        const int window = 2 * radius + 1,
+                  padded = width + 2 * radius;
+        const Px identity = type == MorphType::kDilate ? 0x00 : 0xff;
+
+        // The padded lines, and g, kLines pixels of each group at each position.
+        const int step = groups * kLines;
+        SkAutoTMalloc<SkPMColor> storage(2 * padded * step);
+        SkPMColor* p = storage.get();
+        SkPMColor* g = p + padded * step;
+
+        for (int y = 0; y < height; y += step) {
+            const int strip = std::min(step, height - y),
+                      n     = (strip + kLines - 1) / kLines;
+            const SkPMColor* lineSrc = src + y * srcStrideY;
+            SkPMColor*       lineDst = dst + y * dstStrideY;
+
+            // Forward along the lines finding g, each group's running extreme in acc.
+            Px acc[kYGroups];
+            for (int i = 0, k = 0; i < padded; ++i) {
+                const bool inside = radius <= i && i < radius + width;
+                for (int j = 0; j < n; ++j) {
+                    Px px = identity;
+                    if (inside) {
+                        px = load_lines(lineSrc + (i - radius) * srcStrideX
+                                                + j * kLines * srcStrideY,
+                                        srcStrideY, std::min(kLines, strip - j * kLines));
                     }
+                    acc[j] = k == 0 ? px : extreme<type>(acc[j], px);
+                    px    .store(p + (i * groups + j) * kLines);
+                    acc[j].store(g + (i * groups + j) * kLines);
                 }
-                *dptr = SkPackARGB32(A, R, G, B);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
+                k = k + 1 == window ? 0 : k + 1;
+            }
+
+            // Walk back finding h, writing each window as we pass its start.
+            for (int i = padded - 1, k = (padded - 1) % window; i >= 0; --i) {
+                for (int j = 0; j < n; ++j) {
+                    Px px = Px::Load(p + (i * groups + j) * kLines);
+                    acc[j] = k == window - 1 ? px : extreme<type>(acc[j], px);
+                    if (i < width) {
+                        Px end = Px::Load(g + ((i + 2 * radius) * groups + j) * kLines);
+                        store_lines(extreme<type>(acc[j], end),
+                                    lineDst + i * dstStrideX + j * kLines * dstStrideY,
+                                    dstStrideY, std::min(kLines, strip - j * kLines));
+                    }
+                }
+                k = k == 0 ? window - 1 : k - 1;
             }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
         }
     }
-#endif
+
 }  // namespace
 
 sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
@@ -634,8 +655,9 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
 
     // Width (or height) must fit in a signed 32-bit int to avoid UBSAN issues (crbug.com/1018190)
     // Further, we limit the radius to something much smaller, to avoid extremely slow draw calls:
-    // (crbug.com/1123035):
-    constexpr int kMaxRadius = 100; // (std::numeric_limits<int>::max() - 1) / 2;
+    // (crbug.com/1123035).  The raster path is constant time per pixel at any radius, but the GPU
+    // path still reads 2 * radius + 1 texels per pixel in each direction.
+    constexpr int kMaxRadius = 256; // (std::numeric_limits<int>::max() - 1) / 2;
 
     if (width < 0 || height < 0 || width > kMaxRadius || height > kMaxRadius) {
         return nullptr;
@@ -13,6 +13,9 @@
 
 #ifndef SK_ENCODE_JPEG
 bool SkJpegEncoder::Encode(SkWStream*, const SkPixmap&, const Options&) { return false; }
+bool SkJpegEncoder::Encode(SkWStream*, const SkYUVAPixmaps&, const SkColorSpace*, const Options&) {
+    return false;
+}
 std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream*, const SkPixmap&, const Options&) {
     return nullptr;
 }
@@ -10,6 +10,7 @@
 #ifdef SK_ENCODE_JPEG
 
 #include "include/core/SkStream.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
@@ -164,6 +165,24 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     return true;
 }
 
+static void write_icc_marker(jpeg_compress_struct* cinfo, SkColorSpace* colorSpace) {
+    sk_sp<SkData> icc = icc_from_color_space(SkImageInfo::MakeUnknown().makeColorSpace(
+            sk_ref_sp(colorSpace)));
+    if (icc) {
+        // Create a contiguous block of memory with the icc signature followed by the profile.
+        sk_sp<SkData> markerData =
+                SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
+        uint8_t* ptr = (uint8_t*) markerData->writable_data();
+        memcpy(ptr, kICCSig, sizeof(kICCSig));
+        ptr += sizeof(kICCSig);
+        *ptr++ = 1; // This is the first marker.
+        *ptr++ = 1; // Out of one total markers.
+        memcpy(ptr, icc->data(), icc->size());
+
+        jpeg_write_marker(cinfo, kICCMarker, markerData->bytes(), markerData->size());
+    }
+}
+
 std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                                const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -184,20 +203,7 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
-    sk_sp<SkData> icc = icc_from_color_space(src.info());
-    if (icc) {
-        // Create a contiguous block of memory with the icc signature followed by the profile.
-        sk_sp<SkData> markerData =
-                SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
-        uint8_t* ptr = (uint8_t*) markerData->writable_data();
-        memcpy(ptr, kICCSig, sizeof(kICCSig));
-        ptr += sizeof(kICCSig);
-        *ptr++ = 1; // This is the first marker.
-        *ptr++ = 1; // Out of one total markers.
-        memcpy(ptr, icc->data(), icc->size());
-
-        jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
-    }
+    write_icc_marker(encoderMgr->cinfo(), src.info().colorSpace());
 
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
 }
@@ -254,4 +260,91 @@ bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& o
     return encoder.get() && encoder->encodeRows(src.height());
 }
 
+bool SkJpegEncoder::Encode(SkWStream* dst, const SkYUVAPixmaps& src,
+                           const SkColorSpace* srcColorSpace, const Options& options) {
+    if (!src.isValid() ||
+        src.yuvaInfo().planeConfig() != SkYUVAInfo::PlaneConfig::kY_U_V ||
+        src.yuvaInfo().yuvColorSpace() != kJPEG_Full_SkYUVColorSpace ||
+        src.dataType() != SkYUVAPixmaps::DataType::kUnorm8) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (!SkPixmapIsValid(src.plane(i)) || src.plane(i).info().bytesPerPixel() != 1) {
+            return false;
+        }
+    }
+    auto [ssx, ssy] = SkYUVAInfo::SubsamplingFactors(src.yuvaInfo().subsampling());
+    const SkPixmap& yPlane = src.plane(0);
+
+    // jpeg_write_raw_data() consumes one iMCU row at a time: DCTSIZE * v_samp_factor rows
+    // of each component, each padded out to a whole number of DCT blocks.  The planes are
+    // copied into such buffers, replicating the last column and row into the padding.
+    // Allocate them before setjmp() so that a libjpeg error can not leak them.
+    static_assert(DCTSIZE == 8, "");
+    const int rowsPerIMCU[3] = {DCTSIZE * ssy, DCTSIZE, DCTSIZE};
+    int paddedWidths[3];
+    size_t storageSize = 0;
+    for (int i = 0; i < 3; ++i) {
+        paddedWidths[i] = SkAlign8(src.plane(i).width());
+        storageSize += (size_t)paddedWidths[i] * rowsPerIMCU[i];
+    }
+    SkAutoTMalloc<JSAMPLE> storage(storageSize);
+    SkAutoTMalloc<JSAMPROW> rowPtrs(DCTSIZE * (ssy + 2));
+    JSAMPARRAY planeRows[3] = {rowPtrs.get(),
+                               rowPtrs.get() + rowsPerIMCU[0],
+                               rowPtrs.get() + rowsPerIMCU[0] + rowsPerIMCU[1]};
+    JSAMPLE* rowStorage = storage.get();
+    for (int i = 0; i < 3; ++i) {
+        for (int r = 0; r < rowsPerIMCU[i]; ++r) {
+            planeRows[i][r] = rowStorage;
+            rowStorage += paddedWidths[i];
+        }
+    }
+
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    jpeg_compress_struct* cinfo = encoderMgr->cinfo();
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+
+    cinfo->image_width = yPlane.width();
+    cinfo->image_height = yPlane.height();
+    cinfo->in_color_space = JCS_YCbCr;
+    cinfo->input_components = 3;
+    jpeg_set_defaults(cinfo);
+    // The chroma planes are already downsampled; libjpeg only needs to know by how much.
+    cinfo->comp_info[0].h_samp_factor = ssx;
+    cinfo->comp_info[0].v_samp_factor = ssy;
+    for (int i = 1; i < 3; ++i) {
+        cinfo->comp_info[i].h_samp_factor = 1;
+        cinfo->comp_info[i].v_samp_factor = 1;
+    }
+    cinfo->raw_data_in = TRUE;
+    cinfo->optimize_coding = TRUE;
+    jpeg_set_quality(cinfo, options.fQuality, TRUE);
+    jpeg_start_compress(cinfo, TRUE);
+    write_icc_marker(cinfo, const_cast<SkColorSpace*>(srcColorSpace));
+
+    for (int iMCURow = 0; cinfo->next_scanline < cinfo->image_height; ++iMCURow) {
+        for (int i = 0; i < 3; ++i) {
+            const SkPixmap& plane = src.plane(i);
+            for (int r = 0; r < rowsPerIMCU[i]; ++r) {
+                int y = std::min(iMCURow * rowsPerIMCU[i] + r, plane.height() - 1);
+                const uint8_t* srcRow = static_cast<const uint8_t*>(plane.addr(0, y));
+                JSAMPLE* dstRow = planeRows[i][r];
+                memcpy(dstRow, srcRow, plane.width());
+                memset(dstRow + plane.width(), srcRow[plane.width() - 1],
+                       paddedWidths[i] - plane.width());
+            }
+        }
+        if (0 == jpeg_write_raw_data(cinfo, planeRows, rowsPerIMCU[0])) {
+            return false;
+        }
+    }
+    jpeg_finish_compress(cinfo);
+    return true;
+}
+
 #endif
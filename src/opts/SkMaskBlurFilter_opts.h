@@ -0,0 +1,141 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMaskBlurFilter_opts_DEFINED
+#define SkMaskBlurFilter_opts_DEFINED
+
+#include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
+#include "include/private/SkVx.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SK_OPTS_NS {
+
+// One lane per row: 16 fills a 512-bit register with uint32_t sums, 8 fills AVX2's 256 bits,
+// and on NEON or SSE 8 is two registers, which still hides most of the latency of the sums.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    static constexpr int kMaskBlurLanes = 16;
+#else
+    static constexpr int kMaskBlurLanes = 8;
+#endif
+
+// (weight * sum + 1/2) >> 32, as PlanGauss::Scan::finalScale().  The weight is less than 2^32, so
+// this is a widening 32x32-bit multiply.
+template <int N>
+SK_ALWAYS_INLINE static skvx::Vec<N, uint8_t> mask_blur_scale(const skvx::Vec<N, uint32_t>& sum,
+                                                              uint32_t weight) {
+    static constexpr uint64_t kHalf = static_cast<uint64_t>(1) << 31;
+    auto scaled = skvx::cast<uint64_t>(sum) * skvx::cast<uint64_t>(skvx::Vec<N, uint32_t>(weight));
+    return skvx::cast<uint8_t>((scaled + kHalf) >> 32);
+}
+
+// This is PlanGauss::Scan::blur() run on N rows at once.  The output for each x is N adjacent
+// bytes of dst, so transposing the result is a short contiguous store rather than N single-byte
+// stores dstRB apart.  Rows past the last real row re-read it; their lanes are never stored.
+template <int N>
+static void mask_blur_lanes(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                            uint8_t* dst, size_t dstRB, int dstW,
+                            const int passes[3], uint64_t weight, int noChangeCount,
+                            uint32_t* buffer) {
+    using U32 = skvx::Vec<N, uint32_t>;
+
+    const uint8_t* row[N];
+    for (int i = 0; i < N; i++) {
+        row[i] = src + std::min(i, rows - 1) * srcRB;
+    }
+    auto load = [&](int x) {
+        uint32_t lanes[N];
+        for (int i = 0; i < N; i++) {
+            lanes[i] = row[i][x];
+        }
+        return U32::Load(lanes);
+    };
+
+    const uint32_t weight32 = SkTo<uint32_t>(weight);
+    auto store = [&](int x, const U32& sum) {
+        auto alpha = mask_blur_scale(sum, weight32);
+        if (rows == N) {
+            alpha.store(dst + x * dstRB);
+        } else {
+            memcpy(dst + x * dstRB, &alpha, rows);
+        }
+    };
+
+    uint32_t* buffer0    = buffer;
+    uint32_t* buffer0End = buffer0 + passes[0] * N;
+    uint32_t* buffer1    = buffer0End;
+    uint32_t* buffer1End = buffer1 + passes[1] * N;
+    uint32_t* buffer2    = buffer1End;
+    uint32_t* buffer2End = buffer2 + passes[2] * N;
+
+    uint32_t* buffer0Cursor = buffer0;
+    uint32_t* buffer1Cursor = buffer1;
+    uint32_t* buffer2Cursor = buffer2;
+
+    U32 sum0 = 0,
+        sum1 = 0,
+        sum2 = 0;
+
+    // First consume the source generating pixels, then let the leading edge run off the right
+    // side of the mask, and then restart from the right to fill in the rest.  This is one loop
+    // rather than three so the sums stay in registers.
+    const int forward = srcW + noChangeCount;
+    for (int i = 0; i < dstW; i++) {
+        if (i == 0 || i == forward) {
+            std::fill(buffer0, buffer2End, 0);
+            sum0 = sum1 = sum2 = 0;
+        }
+
+        int x = i;
+        U32 leadingEdge = 0;
+        if (i < srcW) {
+            leadingEdge = load(i);
+        } else if (i >= forward) {
+            x = dstW - 1 - (i - forward);
+            leadingEdge = load(srcW - 1 - (i - forward));
+        }
+
+        sum0 += leadingEdge;
+        sum1 += sum0;
+        sum2 += sum1;
+
+        store(x, sum2);
+
+        sum2 -= U32::Load(buffer2Cursor);
+        sum1.store(buffer2Cursor);
+        buffer2Cursor = (buffer2Cursor + N) < buffer2End ? buffer2Cursor + N : buffer2;
+
+        sum1 -= U32::Load(buffer1Cursor);
+        sum0.store(buffer1Cursor);
+        buffer1Cursor = (buffer1Cursor + N) < buffer1End ? buffer1Cursor + N : buffer1;
+
+        sum0 -= U32::Load(buffer0Cursor);
+        leadingEdge.store(buffer0Cursor);
+        buffer0Cursor = (buffer0Cursor + N) < buffer0End ? buffer0Cursor + N : buffer0;
+    }
+}
+
+/*not static*/ inline void mask_blur_rows(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                                          uint8_t* dst, size_t dstRB, int dstW,
+                                          const int passes[3], uint64_t weight,
+                                          int noChangeCount) {
+    constexpr int N = kMaskBlurLanes;
+    SkASSERT(passes[0] > 0 && passes[1] > 0 && passes[2] > 0);
+
+    SkAutoTMalloc<uint32_t> buffer((passes[0] + passes[1] + passes[2]) * N);
+    for (int y = 0; y < rows; y += N) {
+        mask_blur_lanes<N>(src + y * srcRB, srcRB, srcW, std::min(N, rows - y),
+                           dst + y, dstRB, dstW,
+                           passes, weight, noChangeCount, buffer.get());
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif  // SkMaskBlurFilter_opts_DEFINED
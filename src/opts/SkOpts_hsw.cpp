@@ -11,6 +11,7 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkMaskBlurFilter_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -25,6 +26,8 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        mask_blur_rows = SK_OPTS_NS::mask_blur_rows;
+
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
         RGBA_to_rgbA          = SK_OPTS_NS::RGBA_to_rgbA;
         RGBA_to_bgrA          = SK_OPTS_NS::RGBA_to_bgrA;
@@ -46,6 +49,13 @@ namespace SkOpts {
         start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
     #undef M
 
+    #define M(name, ...) fused_highp[i++] = SK_OPTS_NS::fused::name;
+        { int i = 0; SK_RASTER_PIPELINE_FUSED_HIGHP(M) }
+    #undef M
+    #define M(name, ...) fused_lowp[i++] = SK_OPTS_NS::lowp::fused::name;
+        { int i = 0; SK_RASTER_PIPELINE_FUSED_LOWP(M) }
+    #undef M
+
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     }
 }  // namespace SkOpts
@@ -8,10 +8,33 @@
 #include "src/core/SkOpts.h"
 
 #define SK_OPTS_NS skx
+#include "src/opts/SkMaskBlurFilter_opts.h"
+#include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkVM_opts.h"
 
 namespace SkOpts {
     void Init_skx() {
+        mask_blur_rows = SK_OPTS_NS::mask_blur_rows;
+
+    #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
+        SK_RASTER_PIPELINE_STAGES(M)
+        just_return_highp = (StageFn)SK_OPTS_NS::just_return;
+        start_pipeline_highp = SK_OPTS_NS::start_pipeline;
+    #undef M
+
+    #define M(st) stages_lowp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::lowp::st;
+        SK_RASTER_PIPELINE_STAGES(M)
+        just_return_lowp = (StageFn)SK_OPTS_NS::lowp::just_return;
+        start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
+    #undef M
+
+    #define M(name, ...) fused_highp[i++] = SK_OPTS_NS::fused::name;
+        { int i = 0; SK_RASTER_PIPELINE_FUSED_HIGHP(M) }
+    #undef M
+    #define M(name, ...) fused_lowp[i++] = SK_OPTS_NS::lowp::fused::name;
+        { int i = 0; SK_RASTER_PIPELINE_FUSED_LOWP(M) }
+    #undef M
+
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     }
 }  // namespace SkOpts
@@ -332,7 +332,228 @@ namespace SK_OPTS_NS {
         }
     }
 
-#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    // 32 uint16_t lanes, used only to build shuffle indices for 16-bit channels.
+    using U16x32 = uint16_t __attribute__((ext_vector_type(32)));
+
+    SI F   mad(F f, F m, F a)   { return _mm512_fmadd_ps(f,m,a); }
+    SI F   min(F a, F b)        { return _mm512_min_ps(a,b);     }
+    SI F   max(F a, F b)        { return _mm512_max_ps(a,b);     }
+    SI F   abs_  (F v)          { return _mm512_and_ps(v, 0-v);  }
+    SI F   floor_(F v)          { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF); }
+    SI F   rcp   (F v)          { return _mm512_rcp14_ps  (v);   }
+    SI F   rsqrt (F v)          { return _mm512_rsqrt14_ps(v);   }
+    SI F    sqrt_(F v)          { return _mm512_sqrt_ps   (v);   }
+    SI U32 round (F v, F scale) { return _mm512_cvtps_epi32(v*scale); }
+
+    // Clamping negative lanes to zero first makes these saturate just like _mm_packus_epi32()
+    // and _mm_packus_epi16() do on HSW.
+    SI U16 pack(U32 v) {
+        return _mm512_cvtusepi32_epi16(_mm512_max_epi32(v, _mm512_setzero_si512()));
+    }
+    SI U8 pack(U16 v) {
+        return _mm256_cvtusepi16_epi8(_mm256_max_epi16(v, _mm256_setzero_si256()));
+    }
+
+    SI F if_then_else(I32 c, F t, F e) {
+        return _mm512_mask_blend_ps(_mm512_movepi32_mask(c), e,t);
+    }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps   (ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) { return _mm512_i32gather_epi32(ix, p, 4); }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256     (ix   ), p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti32x8_epi32(ix, 1), p, 8),
+        };
+        return sk_bit_cast<U64>(parts);
+    }
+
+    // AVX-512 loads and stores take a mask of which lanes to touch, so rather than handle the
+    // tail a pixel at a time we just mask off the lanes past it.  Masked-off lanes never fault.
+    // first_lanes(n) is a mask of the first n lanes, with n clamped to [0,64].
+    SI uint64_t first_lanes(int n) {
+        return n <= 0  ? 0
+             : n >= 64 ? ~0ull
+             : (1ull << n) - 1;
+    }
+
+    // Load or store the first n lanes of a V of T.  Loads zero the rest.
+    template <typename V, typename T>
+    SI V load_first(const T* ptr, size_t n) {
+        const char* p = (const char*)ptr;
+        const int bytes = (int)(n * sizeof(T));
+        if constexpr (sizeof(V) == 16) {
+            return sk_bit_cast<V>(_mm_maskz_loadu_epi8   ((__mmask16)first_lanes(bytes), p));
+        } else if constexpr (sizeof(V) == 32) {
+            return sk_bit_cast<V>(_mm256_maskz_loadu_epi8((__mmask32)first_lanes(bytes), p));
+        } else if constexpr (sizeof(V) == 64) {
+            return sk_bit_cast<V>(_mm512_maskz_loadu_epi8(first_lanes(bytes), p));
+        } else {
+            static_assert(sizeof(V) == 128, "");
+            __m512i parts[] = {
+                _mm512_maskz_loadu_epi8(first_lanes(bytes -  0), p +  0),
+                _mm512_maskz_loadu_epi8(first_lanes(bytes - 64), p + 64),
+            };
+            return sk_bit_cast<V>(parts);
+        }
+    }
+    template <typename V, typename T>
+    SI void store_first(T* ptr, size_t n, V v) {
+        char* p = (char*)ptr;
+        const int bytes = (int)(n * sizeof(T));
+        if constexpr (sizeof(V) == 16) {
+            _mm_mask_storeu_epi8   (p, (__mmask16)first_lanes(bytes), sk_bit_cast<__m128i>(v));
+        } else if constexpr (sizeof(V) == 32) {
+            _mm256_mask_storeu_epi8(p, (__mmask32)first_lanes(bytes), sk_bit_cast<__m256i>(v));
+        } else if constexpr (sizeof(V) == 64) {
+            _mm512_mask_storeu_epi8(p, first_lanes(bytes), sk_bit_cast<__m512i>(v));
+        } else {
+            static_assert(sizeof(V) == 128, "");
+            __m512i parts[2];
+            memcpy(parts, &v, sizeof(parts));
+            _mm512_mask_storeu_epi8(p +  0, first_lanes(bytes -  0), parts[0]);
+            _mm512_mask_storeu_epi8(p + 64, first_lanes(bytes - 64), parts[1]);
+        }
+    }
+
+    // Lane numbers (of 32- and 16-bit lanes), to build the indices for the two-register shuffles
+    // that (de)interleave channels below.  In _mm512_permutex2var_*(a, ix, b), ix counts a's
+    // lanes then b's.
+    SI U32    iota32() { return U32   {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15}; }
+    SI U16x32 iota16() {
+        return U16x32{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,15,
+                      16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31};
+    }
+
+    SI void load2(const uint16_t* ptr, size_t tail, U16* r, U16* g) {
+        const int n = tail ? (int)tail : 16;
+        // Each pixel is one 32-bit rg pair, so a 16x32-bit register holds all 16 of them.
+        __m512i rg = _mm512_maskz_loadu_epi16((__mmask32)first_lanes(2*n), ptr);
+        *r = _mm512_cvtepi32_epi16(rg);
+        *g = _mm512_cvtepi32_epi16(_mm512_srli_epi32(rg, 16));
+    }
+    SI void store2(uint16_t* ptr, size_t tail, U16 r, U16 g) {
+        const int n = tail ? (int)tail : 16;
+        __m512i rg = _mm512_or_si512(_mm512_cvtepu16_epi32(r),
+                                     _mm512_slli_epi32(_mm512_cvtepu16_epi32(g), 16));
+        _mm512_mask_storeu_epi16(ptr, (__mmask32)first_lanes(2*n), rg);
+    }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        const int n = tail ? (int)tail : 16;
+        __m512i _0 = _mm512_maskz_loadu_epi16((__mmask32)first_lanes(3*n -  0), ptr +  0),
+                _1 = _mm512_maskz_loadu_epi16((__mmask32)first_lanes(3*n - 32), ptr + 32);
+
+        const U16x32 ix = iota16() * 3;
+        *r = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 0, _1));
+        *g = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 1, _1));
+        *b = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 2, _1));
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        const int n = tail ? (int)tail : 16;
+        __m512i _0 = _mm512_maskz_loadu_epi16((__mmask32)first_lanes(4*n -  0), ptr +  0),
+                _1 = _mm512_maskz_loadu_epi16((__mmask32)first_lanes(4*n - 32), ptr + 32);
+
+        const U16x32 ix = iota16() * 4;
+        *r = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 0, _1));
+        *g = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 1, _1));
+        *b = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 2, _1));
+        *a = _mm512_castsi512_si256(_mm512_permutex2var_epi16(_0, ix + 3, _1));
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        const int n = tail ? (int)tail : 16;
+        __m512i rg = _mm512_inserti64x4(_mm512_castsi256_si512(r), g, 1),  // r0..r15 g0..g15
+                ba = _mm512_inserti64x4(_mm512_castsi256_si512(b), a, 1);  // b0..b15 a0..a15
+
+        // Lane i of the output is channel i%4 of pixel i/4.
+        const U16x32 ix = (iota16() & 3) * 16 + (iota16() >> 2);
+        __m512i _0 = _mm512_permutex2var_epi16(rg, ix + 0, ba),  // pixels 0-7
+                _1 = _mm512_permutex2var_epi16(rg, ix + 8, ba);  // pixels 8-15
+        _mm512_mask_storeu_epi16(ptr +  0, (__mmask32)first_lanes(4*n -  0), _0);
+        _mm512_mask_storeu_epi16(ptr + 32, (__mmask32)first_lanes(4*n - 32), _1);
+    }
+
+    SI void load2(const float* ptr, size_t tail, F* r, F* g) {
+        const int n = tail ? (int)tail : 16;
+        __m512 _0 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(2*n -  0), ptr +  0),
+               _1 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(2*n - 16), ptr + 16);
+
+        const U32 ix = iota32() * 2;
+        *r = _mm512_permutex2var_ps(_0, ix + 0, _1);
+        *g = _mm512_permutex2var_ps(_0, ix + 1, _1);
+    }
+    SI void store2(float* ptr, size_t tail, F r, F g) {
+        const int n = tail ? (int)tail : 16;
+
+        // Lane i of the output is channel i%2 of pixel i/2.
+        const U32 ix = (iota32() & 1) * 16 + (iota32() >> 1);
+        __m512 _0 = _mm512_permutex2var_ps(r, ix + 0, g),  // pixels 0-7
+               _1 = _mm512_permutex2var_ps(r, ix + 8, g);  // pixels 8-15
+        _mm512_mask_storeu_ps(ptr +  0, (__mmask16)first_lanes(2*n -  0), _0);
+        _mm512_mask_storeu_ps(ptr + 16, (__mmask16)first_lanes(2*n - 16), _1);
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        const int n = tail ? (int)tail : 16;
+        __m512 _0 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(4*n -  0), ptr +  0),
+               _1 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(4*n - 16), ptr + 16),
+               _2 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(4*n - 32), ptr + 32),
+               _3 = _mm512_maskz_loadu_ps((__mmask16)first_lanes(4*n - 48), ptr + 48);
+
+        // First gather r,g and b,a for each group of 8 pixels...
+        const U32 ix = (iota32() & 7) * 4 + (iota32() >> 3);
+        __m512 rg01 = _mm512_permutex2var_ps(_0, ix + 0, _1),  // r0..r7  g0..g7
+               ba01 = _mm512_permutex2var_ps(_0, ix + 2, _1),  // b0..b7  a0..a7
+               rg23 = _mm512_permutex2var_ps(_2, ix + 0, _3),  // r8..r15 g8..g15
+               ba23 = _mm512_permutex2var_ps(_2, ix + 2, _3);  // b8..b15 a8..a15
+
+        // ... then join up those halves.
+        const U32 jx = (iota32() & 7) + (iota32() >> 3) * 16;
+        *r = _mm512_permutex2var_ps(rg01, jx + 0, rg23);
+        *g = _mm512_permutex2var_ps(rg01, jx + 8, rg23);
+        *b = _mm512_permutex2var_ps(ba01, jx + 0, ba23);
+        *a = _mm512_permutex2var_ps(ba01, jx + 8, ba23);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        const int n = tail ? (int)tail : 16;
+
+        // The reverse of load4(): first split r,g and b,a into groups of 8 pixels...
+        const U32 jx = (iota32() & 7) + (iota32() >> 3) * 16;
+        __m512 rg01 = _mm512_permutex2var_ps(r, jx + 0, g),  // r0..r7  g0..g7
+               rg23 = _mm512_permutex2var_ps(r, jx + 8, g),  // r8..r15 g8..g15
+               ba01 = _mm512_permutex2var_ps(b, jx + 0, a),  // b0..b7  a0..a7
+               ba23 = _mm512_permutex2var_ps(b, jx + 8, a);  // b8..b15 a8..a15
+
+        // ... then interleave them so lane i is channel i%4 of pixel i/4.
+        const U32 ix = (iota32() & 3) * 8 + (iota32() >> 2);
+        __m512 _0 = _mm512_permutex2var_ps(rg01, ix + 0, ba01),  // pixels  0-3
+               _1 = _mm512_permutex2var_ps(rg01, ix + 4, ba01),  // pixels  4-7
+               _2 = _mm512_permutex2var_ps(rg23, ix + 0, ba23),  // pixels  8-11
+               _3 = _mm512_permutex2var_ps(rg23, ix + 4, ba23);  // pixels 12-15
+        _mm512_mask_storeu_ps(ptr +  0, (__mmask16)first_lanes(4*n -  0), _0);
+        _mm512_mask_storeu_ps(ptr + 16, (__mmask16)first_lanes(4*n - 16), _1);
+        _mm512_mask_storeu_ps(ptr + 32, (__mmask16)first_lanes(4*n - 32), _2);
+        _mm512_mask_storeu_ps(ptr + 48, (__mmask16)first_lanes(4*n - 48), _3);
+    }
+
+#elif defined(JUMPER_IS_AVX) || defined(JUMPER_IS_HSW)
     // These are __m256 and __m256i, but friendlier and strongly-typed.
     template <typename T> using V = T __attribute__((ext_vector_type(8)));
     using F   = V<float   >;
@@ -343,7 +564,7 @@ namespace SK_OPTS_NS {
     using U8  = V<uint8_t >;
 
     SI F mad(F f, F m, F a)  {
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         return _mm256_fmadd_ps(f,m,a);
     #else
         return f*m+a;
@@ -375,7 +596,7 @@ namespace SK_OPTS_NS {
         return { p[ix[0]], p[ix[1]], p[ix[2]], p[ix[3]],
                  p[ix[4]], p[ix[5]], p[ix[6]], p[ix[7]], };
     }
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         SI F   gather(const float*    p, U32 ix) { return _mm256_i32gather_ps   (p, ix, 4); }
         SI U32 gather(const uint32_t* p, U32 ix) { return _mm256_i32gather_epi32(p, ix, 4); }
         SI U64 gather(const uint64_t* p, U32 ix) {
@@ -980,7 +1201,10 @@ SI F from_half(U16 h) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtph_ps(h);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
 #else
@@ -1001,7 +1225,10 @@ SI U16 to_half(F f) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
 #else
@@ -1087,6 +1314,17 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
     }
 }
 
+// Each stage also gets a wrapper in namespace fused, so fused pipelines can call its body inline.
+#define FUSED_STAGE(name)                                                               \
+    namespace fused {                                                                   \
+        struct name {                                                                   \
+            SI void run(void**& program, size_t dx, size_t dy, size_t tail,             \
+                        F& r, F& g, F& b, F& a, F& dr, F& dg, F& db, F& da) {           \
+                name##_k(Ctx{program},dx,dy,tail, r,g,b,a, dr,dg,db,da);                \
+            }                                                                           \
+        };                                                                              \
+    }
+
 #if JUMPER_NARROW_STAGES
     #define STAGE(name, ...)                                                    \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail,        \
@@ -1098,6 +1336,7 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
             auto next = (Stage)load_and_inc(program);                           \
             next(params,program, r,g,b,a);                                      \
         }                                                                       \
+        FUSED_STAGE(name)                                                       \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail,        \
                          F& r, F& g, F& b, F& a, F& dr, F& dg, F& db, F& da)
 #else
@@ -1110,6 +1349,7 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
             auto next = (Stage)load_and_inc(program);                                \
             next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);                          \
         }                                                                            \
+        FUSED_STAGE(name)                                                            \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail,             \
                          F& r, F& g, F& b, F& a, F& dr, F& dg, F& db, F& da)
 #endif
@@ -1131,7 +1371,12 @@ static void start_pipeline(size_t dx, size_t dy, size_t xlimit, size_t ylimit, v
 
 template <typename V, typename T>
 SI V load(const T* src, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        return load_first<V>(src, tail);  // Any inactive lanes are zeroed.
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
@@ -1152,7 +1397,13 @@ SI V load(const T* src, size_t tail) {
 
 template <typename V, typename T>
 SI void store(T* dst, V v, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        store_first(dst, tail, v);
+        return;
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         switch (tail) {
@@ -1272,7 +1523,7 @@ STAGE(seed_shader, Ctx::None) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     U32 X = dx + sk_unaligned_load<U32>(iota),
         Y = dy;
 
@@ -2404,7 +2655,23 @@ STAGE(matrix_perspective, const float* m) {
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        // The stops are only padded out to 8, so mask off any past stopCount.
+        auto lookup = [&](const float* stops) -> F {
+            __m512 v = _mm512_maskz_loadu_ps((__mmask16)first_lanes((int)c->stopCount), stops);
+            return _mm512_permutexvar_ps(idx, v);
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -2451,6 +2718,21 @@ STAGE(gradient, const SkRasterPipeline_GradientCtx* c) {
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
 }
 
+STAGE(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    // Entry 1 is t=0, and clamping sends t < 0 and t >= 1 to the entries on either end.
+    F ix = min(max(0, mad(r, c->scale, 1.0f)), c->limit);
+    U32 i = trunc_(ix);
+    F t = ix - cast(i);
+
+    F r1, g1, b1, a1;
+    from_8888(gather(c->colors, i    ), &r ,&g ,&b ,&a );
+    from_8888(gather(c->colors, i + 1), &r1,&g1,&b1,&a1);
+    r = lerp(r, r1, t);
+    g = lerp(g, g1, t);
+    b = lerp(b, b1, t);
+    a = lerp(a, a1, t);
+}
+
 STAGE(evenly_spaced_2_stop_gradient, const void* ctx) {
     struct Ctx { float f[4], b[4]; };
     auto c = (const Ctx*)ctx;
@@ -2868,6 +3150,34 @@ STAGE(swizzle, void* ctx) {
     }
 }
 
+// ~~~~~~ Fused pipelines ~~~~~~ //
+
+// A fused pipeline runs its stages one after another for each N pixels, calling their bodies
+// directly rather than chaining from stage to stage.  Its program holds just the contexts.
+template <typename... Stages>
+static void run_fused(size_t x0, size_t y0, size_t xlimit, size_t ylimit, void** ctxs) {
+    for (size_t dy = y0; dy < ylimit; dy++) {
+        for (size_t dx = x0; dx < xlimit; dx += N) {
+            const size_t tail = xlimit - dx < N ? xlimit - dx : 0;
+            void** program = ctxs;
+            F r = 0, g = 0, b = 0, a = 0,
+              dr = 0, dg = 0, db = 0, da = 0;
+            (Stages::run(program, dx,dy,tail, r,g,b,a, dr,dg,db,da), ...);
+        }
+    }
+}
+
+namespace fused {
+#define M(name, ...)                                                                    \
+    static void name(size_t x0, size_t y0, size_t xlimit, size_t ylimit, void** ctxs) { \
+        run_fused<__VA_ARGS__>(x0,y0,xlimit,ylimit, ctxs);                              \
+    }
+    SK_RASTER_PIPELINE_FUSED_HIGHP(M)
+#undef M
+}  // namespace fused
+
+#undef FUSED_STAGE
+
 namespace lowp {
 #if defined(JUMPER_IS_SCALAR) || defined(SK_DISABLE_LOWP_RASTER_PIPELINE)
     // If we're not compiled by Clang, or otherwise switched into scalar mode (old Clang, manually),
@@ -2880,9 +3190,22 @@ namespace lowp {
 
     static void start_pipeline(size_t,size_t,size_t,size_t, void**) {}
 
+    namespace fused {
+    #define M(name, ...) static void (*name)(size_t,size_t,size_t,size_t, void**) = nullptr;
+        SK_RASTER_PIPELINE_FUSED_LOWP(M)
+    #undef M
+    }  // namespace fused
+
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    using U8  = uint8_t  __attribute__((ext_vector_type(32)));
+    using U16 = uint16_t __attribute__((ext_vector_type(32)));
+    using I16 =  int16_t __attribute__((ext_vector_type(32)));
+    using I32 =  int32_t __attribute__((ext_vector_type(32)));
+    using U32 = uint32_t __attribute__((ext_vector_type(32)));
+    using F   = float    __attribute__((ext_vector_type(32)));
+#elif defined(JUMPER_IS_HSW)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -2957,6 +3280,23 @@ static void start_pipeline(const size_t x0,     const size_t y0,
 // These three STAGE_ macros let you define each type of stage,
 // and will have (x,y) geometry and/or (r,g,b,a, dr,dg,db,da) pixel arguments as appropriate.
 
+// As in highp, each stage gets a wrapper in namespace fused for fused pipelines to call.
+// All three kinds of wrapper take both geometry and pixels, using whichever the stage needs.
+#define FUSED_STAGE(name, ...)                                                          \
+    namespace fused {                                                                   \
+        struct name {                                                                   \
+            SI void run(void**& program, size_t dx, size_t dy, size_t tail,             \
+                        F& x, F& y,                                                     \
+                        U16&  r, U16&  g, U16&  b, U16&  a,                             \
+                        U16& dr, U16& dg, U16& db, U16& da) {                           \
+                name##_k(Ctx{program},dx,dy,tail, __VA_ARGS__);                         \
+            }                                                                           \
+        };                                                                              \
+    }
+#define FUSED_STAGE_GG(name) FUSED_STAGE(name, x,y)
+#define FUSED_STAGE_GP(name) FUSED_STAGE(name, x,y, r,g,b,a, dr,dg,db,da)
+#define FUSED_STAGE_PP(name) FUSED_STAGE(name,      r,g,b,a, dr,dg,db,da)
+
 #if JUMPER_NARROW_STAGES
     #define STAGE_GG(name, ...)                                                                \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail, F& x, F& y);          \
@@ -2969,6 +3309,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                          \
             next(params,program, r,g,b,a);                                                     \
         }                                                                                      \
+        FUSED_STAGE_GG(name)                                                                   \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail, F& x, F& y)
 
     #define STAGE_GP(name, ...)                                                            \
@@ -2983,6 +3324,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                      \
             next(params,program, r,g,b,a);                                                 \
         }                                                                                  \
+        FUSED_STAGE_GP(name)                                                               \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail, F x, F y,         \
                          U16&  r, U16&  g, U16&  b, U16&  a,                               \
                          U16& dr, U16& dg, U16& db, U16& da)
@@ -2997,6 +3339,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                      \
             next(params,program, r,g,b,a);                                                 \
         }                                                                                  \
+        FUSED_STAGE_PP(name)                                                               \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail,                   \
                          U16&  r, U16&  g, U16&  b, U16&  a,                               \
                          U16& dr, U16& dg, U16& db, U16& da)
@@ -3014,6 +3357,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                      \
             next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);                                \
         }                                                                                  \
+        FUSED_STAGE_GG(name)                                                               \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail, F& x, F& y)
 
     #define STAGE_GP(name, ...)                                                            \
@@ -3029,6 +3373,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                      \
             next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);                                \
         }                                                                                  \
+        FUSED_STAGE_GP(name)                                                               \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail, F x, F y,         \
                          U16&  r, U16&  g, U16&  b, U16&  a,                               \
                          U16& dr, U16& dg, U16& db, U16& da)
@@ -3044,6 +3389,7 @@ static void start_pipeline(const size_t x0,     const size_t y0,
             auto next = (Stage)load_and_inc(program);                                      \
             next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);                                \
         }                                                                                  \
+        FUSED_STAGE_PP(name)                                                               \
         SI void name##_k(__VA_ARGS__, size_t dx, size_t dy, size_t tail,                   \
                          U16&  r, U16&  g, U16&  b, U16&  a,                               \
                          U16& dr, U16& dg, U16& db, U16& da)
@@ -3107,7 +3453,11 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 SI F rcp(F x) {
 #if defined(SK_RASTER_PIPELINE_LEGACY_RCP_RSQRT)
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_SKX)
+        __m512 lo,hi;
+        split(x, &lo,&hi);
+        return join<F>(_mm512_rcp14_ps(lo), _mm512_rcp14_ps(hi));
+    #elif defined(JUMPER_IS_HSW)
         __m256 lo,hi;
         split(x, &lo,&hi);
         return join<F>(_mm256_rcp_ps(lo), _mm256_rcp_ps(hi));
@@ -3135,7 +3485,11 @@ SI F rcp(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_sqrt_ps(lo), _mm512_sqrt_ps(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -3170,7 +3524,12 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_roundscale_ps(lo, _MM_FROUND_TO_NEG_INF),
+                   _mm512_roundscale_ps(hi, _MM_FROUND_TO_NEG_INF));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_floor_ps(lo), _mm256_floor_ps(hi));
@@ -3190,8 +3549,10 @@ SI F abs_(F x) { return sk_bit_cast<F>( sk_bit_cast<I32>(x) & 0x7fffffff ); }
 
 STAGE_GG(seed_shader, Ctx::None) {
     static const float iota[] = {
-        0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
-        8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+         0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+         8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+        16.5f,17.5f,18.5f,19.5f,20.5f,21.5f,22.5f,23.5f,
+        24.5f,25.5f,26.5f,27.5f,28.5f,29.5f,30.5f,31.5f,
     };
     x = cast<F>(I32(dx)) + sk_unaligned_load<F>(iota);
     y = cast<F>(I32(dy)) + 0.5f;
@@ -3378,10 +3739,16 @@ SI U32 ix_and_ptr(T** ptr, const SkRasterPipeline_GatherCtx* ctx, F x, F y) {
 
 template <typename V, typename T>
 SI V load(const T* ptr, size_t tail) {
+#if defined(JUMPER_IS_SKX)
+    if (size_t n = tail & (N-1)) {
+        return load_first<V>(ptr, n);
+    }
+    return sk_unaligned_load<V>(ptr);
+#else
     V v = 0;
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         case 15: v[14] = ptr[14]; [[fallthrough]];
         case 14: v[13] = ptr[13]; [[fallthrough]];
         case 13: v[12] = ptr[12]; [[fallthrough]];
@@ -3400,12 +3767,20 @@ SI V load(const T* ptr, size_t tail) {
         case  1: v[ 0] = ptr[ 0];
     }
     return v;
+#endif
 }
 template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
+#if defined(JUMPER_IS_SKX)
+    if (size_t n = tail & (N-1)) {
+        store_first(ptr, n, v);
+        return;
+    }
+    sk_unaligned_store(ptr, v);
+#else
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         case 15: ptr[14] = v[14]; [[fallthrough]];
         case 14: ptr[13] = v[13]; [[fallthrough]];
         case 13: ptr[12] = v[12]; [[fallthrough]];
@@ -3423,9 +3798,40 @@ SI void store(T* ptr, size_t tail, V v) {
         case  2: memcpy(ptr, &v,  2*sizeof(T)); break;
         case  1: ptr[ 0] = v[ 0];
     }
+#endif
 }
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    template <typename V, typename T>
+    SI V gather(const T* ptr, U32 ix) {
+        return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
+                  ptr[ix[ 4]], ptr[ix[ 5]], ptr[ix[ 6]], ptr[ix[ 7]],
+                  ptr[ix[ 8]], ptr[ix[ 9]], ptr[ix[10]], ptr[ix[11]],
+                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]],
+                  ptr[ix[16]], ptr[ix[17]], ptr[ix[18]], ptr[ix[19]],
+                  ptr[ix[20]], ptr[ix[21]], ptr[ix[22]], ptr[ix[23]],
+                  ptr[ix[24]], ptr[ix[25]], ptr[ix[26]], ptr[ix[27]],
+                  ptr[ix[28]], ptr[ix[29]], ptr[ix[30]], ptr[ix[31]], };
+    }
+
+    template<>
+    F gather(const float* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<F>(_mm512_i32gather_ps(lo, ptr, 4),
+                       _mm512_i32gather_ps(hi, ptr, 4));
+    }
+
+    template<>
+    U32 gather(const uint32_t* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<U32>(_mm512_i32gather_epi32(lo, ptr, 4),
+                         _mm512_i32gather_epi32(hi, ptr, 4));
+    }
+#elif defined(JUMPER_IS_HSW)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -3463,7 +3869,7 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if 1 && defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if 1 && defined(JUMPER_IS_HSW)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -3913,7 +4319,27 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        __m512i lo, hi;
+        split(idx, &lo, &hi);
+
+        // The stops are only padded out to 8, so mask off any past stopCount.
+        auto lookup = [&](const float* stops) -> F {
+            __m512 v = _mm512_maskz_loadu_ps((__mmask16)first_lanes((int)c->stopCount), stops);
+            return join<F>(_mm512_permutexvar_ps(lo, v),
+                           _mm512_permutexvar_ps(hi, v));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
@@ -3972,6 +4398,20 @@ STAGE_GP(evenly_spaced_gradient, const SkRasterPipeline_GradientCtx* c) {
     gradient_lookup(c, idx, t, &r, &g, &b, &a);
 }
 
+STAGE_GP(gradient_lut, const SkRasterPipeline_GradientLUTCtx* c) {
+    F ix = min(max(0, mad(x, c->scale, 1.0f)), c->limit);
+    U32 i = trunc_(ix);
+    U16 t = cast<U16>((ix - cast<F>(i)) * 255.0f + 0.5f);
+
+    U16 r1, g1, b1, a1;
+    from_8888(gather<U32>(c->colors, i    ), &r ,&g ,&b ,&a );
+    from_8888(gather<U32>(c->colors, i + 1), &r1,&g1,&b1,&a1);
+    r = lerp(r, r1, t);
+    g = lerp(g, g1, t);
+    b = lerp(b, b1, t);
+    a = lerp(a, a1, t);
+}
+
 STAGE_GP(evenly_spaced_2_stop_gradient, const SkRasterPipeline_EvenlySpaced2StopGradientCtx* c) {
     auto t = x;
     round_F_to_U16(mad(t, c->f[0], c->b[0]),
@@ -4141,6 +4581,37 @@ STAGE_PP(swizzle, void* ctx) {
     NOT_IMPLEMENTED(apply_vector_mask)
 #undef NOT_IMPLEMENTED
 
+// ~~~~~~ Fused pipelines ~~~~~~ //
+
+// Just like highp fused pipelines, but carrying geometry x,y alongside the pixels.
+template <typename... Stages>
+static void run_fused(size_t x0, size_t y0, size_t xlimit, size_t ylimit, void** ctxs) {
+    for (size_t dy = y0; dy < ylimit; dy++) {
+        for (size_t dx = x0; dx < xlimit; dx += N) {
+            const size_t tail = xlimit - dx < N ? xlimit - dx : 0;
+            void** program = ctxs;
+            F x = 0, y = 0;
+            U16 r = 0, g = 0, b = 0, a = 0,
+                dr = 0, dg = 0, db = 0, da = 0;
+            (Stages::run(program, dx,dy,tail, x,y, r,g,b,a, dr,dg,db,da), ...);
+        }
+    }
+}
+
+namespace fused {
+#define M(name, ...)                                                                    \
+    static void name(size_t x0, size_t y0, size_t xlimit, size_t ylimit, void** ctxs) { \
+        run_fused<__VA_ARGS__>(x0,y0,xlimit,ylimit, ctxs);                              \
+    }
+    SK_RASTER_PIPELINE_FUSED_LOWP(M)
+#undef M
+}  // namespace fused
+
+#undef FUSED_STAGE
+#undef FUSED_STAGE_GG
+#undef FUSED_STAGE_GP
+#undef FUSED_STAGE_PP
+
 #endif//defined(JUMPER_IS_SCALAR) controlling whether we build lowp stages
 }  // namespace lowp
 
@@ -18,5 +18,31 @@ struct SkBitmapKey {
     bool operator!=(const SkBitmapKey& rhs) const { return !(*this == rhs); }
 };
 
+/**
+ *  Identifies an image by its contents rather than by its uniqueID: a hash of its encoded
+ *  data if it has any, otherwise of its pixels.  Distinct SkImages decoded or copied from
+ *  the same source share a content key, so they can share a single serialized XObject.
+ *
+ *  A default-constructed key (kNone) means the contents could not be cheaply hashed.
+ */
+struct SkImageContentKey {
+    enum class Source : uint32_t {
+        kNone,
+        kEncoded,
+        kPixels,
+    };
+    Source fSource = Source::kNone;
+    uint32_t fInfo = 0;  // SkColorType and SkAlphaType of hashed pixels.
+    SkISize fDimensions = {0, 0};
+    uint32_t fHash[2] = {0, 0};
+
+    explicit operator bool() const { return fSource != Source::kNone; }
+    bool operator==(const SkImageContentKey& rhs) const {
+        return fSource == rhs.fSource && fInfo == rhs.fInfo && fDimensions == rhs.fDimensions &&
+               fHash[0] == rhs.fHash[0] && fHash[1] == rhs.fHash[1];
+    }
+    bool operator!=(const SkImageContentKey& rhs) const { return !(*this == rhs); }
+};
+
 
 #endif  // SkBitmapKey_DEFINED
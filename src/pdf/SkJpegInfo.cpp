@@ -8,6 +8,7 @@
 #include "src/pdf/SkJpegInfo.h"
 
 #include "include/private/SkTo.h"
+#include "src/codec/SkParseEncodedOrigin.h"
 
 #ifndef SK_CODEC_DECODES_JPEG
 
@@ -84,44 +85,80 @@ bool SkGetJpegInfo(const void* data, size_t len,
                    SkEncodedOrigin* orientation) {
     static const uint16_t kSOI = 0xFFD8;
     static const uint16_t kAPP0 = 0xFFE0;
+    static const uint16_t kAPP1 = 0xFFE1;
+    static const uint16_t kAPP14 = 0xFFEE;
     JpegSegment segment(data, len);
     if (!segment.read() || segment.marker() != kSOI) {
         return false;  // not a JPEG
     }
-    if (!segment.read() || segment.marker() != kAPP0) {
-        return false;  // not an APP0 segment
-    }
-    static const char kJfif[] = {'J', 'F', 'I', 'F', '\0'};
-    SkASSERT(segment.data());
-    if (SkToSizeT(segment.length()) < sizeof(kJfif) ||
-        0 != memcmp(segment.data(), kJfif, sizeof(kJfif))) {
-        return false;  // Not JFIF JPEG
+    if (!segment.read() || (segment.marker() & 0xFFF0) != kAPP0) {
+        return false;  // not an APPn segment
     }
+    // Without one of these we can not tell how to interpret the color channels.
+    bool sawColorMarker = false;
+    int adobeTransform = -1;
+    SkEncodedOrigin exifOrientation = kTopLeft_SkEncodedOrigin;
     do {
-        if (!segment.read()) {
+        static const char kJfif[] = {'J', 'F', 'I', 'F', '\0'};
+        static const char kAdobe[] = {'A', 'd', 'o', 'b', 'e'};
+        static const char kExif[] = {'E', 'x', 'i', 'f', '\0', '\0'};
+        const char* segmentData = segment.data();
+        size_t segmentLength = SkToSizeT(segment.length());
+        if (segment.marker() == kAPP0 && segmentLength >= sizeof(kJfif) &&
+            0 == memcmp(segmentData, kJfif, sizeof(kJfif))) {
+            sawColorMarker = true;
+        } else if (segment.marker() == kAPP14 && segmentLength >= 12 &&
+                   0 == memcmp(segmentData, kAdobe, sizeof(kAdobe))) {
+            sawColorMarker = true;
+            adobeTransform = static_cast<uint8_t>(segmentData[11]);
+        } else if (segment.marker() == kAPP1 && segmentLength > sizeof(kExif) &&
+                   0 == memcmp(segmentData, kExif, sizeof(kExif))) {
+            sawColorMarker = true;
+            SkEncodedOrigin origin;
+            if (SkParseEncodedOrigin((const uint8_t*)segmentData + sizeof(kExif),
+                                     segmentLength - sizeof(kExif), &origin)) {
+                exifOrientation = origin;
+            }
+        }
+        if (!segment.read() || (segment.marker() & 0xFF00) != 0xFF00) {
             return false;  // malformed JPEG
         }
     } while (!segment.isSOF());
+    if (!sawColorMarker) {
+        return false;  // Not JFIF, Adobe, or Exif JPEG
+    }
     if (segment.length() < 6) {
         return false;  // SOF segment is short
     }
     if (8 != segment.data()[0]) {
         return false;  // Only support 8-bit precision
     }
-    int numberOfComponents = segment.data()[5];
-    if (numberOfComponents != 1 && numberOfComponents != 3) {
-        return false;  // Invalid JFIF
+    SkEncodedInfo::Color encodedColorType;
+    switch (segment.data()[5]) {  // number of components
+        case 1:
+            encodedColorType = SkEncodedInfo::kGray_Color;
+            break;
+        case 3:
+            encodedColorType = adobeTransform == 0 ? SkEncodedInfo::kRGB_Color
+                                                   : SkEncodedInfo::kYUV_Color;
+            break;
+        case 4:
+            // Like SkJpegCodec, assume Adobe-style inverted CMYK.
+            encodedColorType = adobeTransform == 2 ? SkEncodedInfo::kYCCK_Color
+                                                   : SkEncodedInfo::kInvertedCMYK_Color;
+            break;
+        default:
+            return false;  // Invalid JPEG
     }
     if (size) {
         *size = {JpegSegment::GetBigendianUint16(&segment.data()[3]),
                  JpegSegment::GetBigendianUint16(&segment.data()[1])};
     }
     if (colorType) {
-        *colorType = numberOfComponents == 3 ? SkEncodedInfo::kYUV_Color
-                                             : SkEncodedInfo::kGray_Color;
+        *colorType = encodedColorType;
     }
     if (orientation) {
-        *orientation = kTopLeft_SkEncodedOrigin;
+        *orientation = exifOrientation;
     }
     return true;
 }
@@ -7,6 +7,8 @@
 
 #include "src/pdf/SkKeyedImage.h"
 
+#include "include/core/SkData.h"
+#include "src/core/SkOpts.h"
 #include "src/image/SkImage_Base.h"
 
 SkBitmapKey SkBitmapKeyFromImage(const SkImage* image) {
@@ -20,6 +22,74 @@ SkBitmapKey SkBitmapKeyFromImage(const SkImage* image) {
     return {image->bounds(), image->uniqueID()};
 }
 
+// Seeds for the two independent 32-bit hashes that make up an SkImageContentKey.
+static constexpr uint32_t kContentHashSeeds[2] = {0x5EEDC0DE, 0x0DDBA115};
+
+SkImageContentKey SkImageContentKeyFromImage(const SkImage* image) {
+    SkImageContentKey key;
+    if (!image) {
+        return key;
+    }
+    // Subsets and other derived lazy images report no encoded data, so the
+    // encoded bytes alone describe the whole image.
+    if (sk_sp<SkData> encoded = image->refEncodedData()) {
+        key.fSource = SkImageContentKey::Source::kEncoded;
+        key.fDimensions = image->dimensions();
+        for (int i = 0; i < 2; ++i) {
+            key.fHash[i] = SkOpts::hash(encoded->data(), encoded->size(), kContentHashSeeds[i]);
+        }
+        return key;
+    }
+    SkPixmap pm;
+    if (image->peekPixels(&pm) && pm.addr()) {
+        key.fSource = SkImageContentKey::Source::kPixels;
+        key.fInfo = ((uint32_t)pm.colorType() << 8) | (uint32_t)pm.alphaType();
+        key.fDimensions = pm.dimensions();
+        // Hash row by row so that padding past the last pixel of each row is ignored.
+        size_t rowBytes = pm.info().minRowBytes();
+        uint32_t hash[2] = {kContentHashSeeds[0], kContentHashSeeds[1]};
+        for (int y = 0; y < pm.height(); ++y) {
+            for (int i = 0; i < 2; ++i) {
+                hash[i] = SkOpts::hash(pm.addr(0, y), rowBytes, hash[i]);
+            }
+        }
+        key.fHash[0] = hash[0];
+        key.fHash[1] = hash[1];
+    }
+    return key;
+}
+
+bool SkImageContentsEqual(const SkImage* a, const SkImage* b, const SkImageContentKey& key) {
+    if (!a || !b) {
+        return false;
+    }
+    switch (key.fSource) {
+        case SkImageContentKey::Source::kNone:
+            return false;
+        case SkImageContentKey::Source::kEncoded: {
+            sk_sp<SkData> encodedA = a->refEncodedData(),
+                          encodedB = b->refEncodedData();
+            return encodedA && encodedB && encodedA->equals(encodedB.get());
+        }
+        case SkImageContentKey::Source::kPixels: {
+            SkPixmap pmA, pmB;
+            if (!a->peekPixels(&pmA) || !pmA.addr() || !b->peekPixels(&pmB) || !pmB.addr() ||
+                pmA.info() != pmB.info()) {
+                return false;
+            }
+            // As when hashing, ignore any padding past the last pixel of each row.
+            size_t rowBytes = pmA.info().minRowBytes();
+            for (int y = 0; y < pmA.height(); ++y) {
+                if (0 != memcmp(pmA.addr(0, y), pmB.addr(0, y), rowBytes)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    SkUNREACHABLE;
+}
+
 SkKeyedImage::SkKeyedImage(sk_sp<SkImage> i) : fImage(std::move(i)) {
     fKey = SkBitmapKeyFromImage(fImage.get());
 }
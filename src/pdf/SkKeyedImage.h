@@ -43,4 +43,18 @@ private:
  *  wraps a Bitmap, use that Bitmap's key.
  */
 SkBitmapKey SkBitmapKeyFromImage(const SkImage*);
+
+/**
+ *  Given an Image, hash its encoded data or, if it has none but its pixels are
+ *  directly accessible, its pixels.  Returns an empty key for images whose
+ *  contents would have to be generated to be hashed (e.g. picture-backed).
+ */
+SkImageContentKey SkImageContentKeyFromImage(const SkImage*);
+
+/**
+ *  Given two Images whose content keys both equal key, return true only if the
+ *  encoded data or pixels that key hashed are in fact the same.  Content keys
+ *  are hashes, so equal keys alone don't prove equal contents.
+ */
+bool SkImageContentsEqual(const SkImage*, const SkImage*, const SkImageContentKey& key);
 #endif  // SkKeyedImage_DEFINED
@@ -11,13 +11,17 @@
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkImageGenerator.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkYUVAPixmaps.h"
+#include "include/encode/SkJpegEncoder.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkTo.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkJpegInfo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
+#include "src/pdf/SkPDFResourceDict.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUtils.h"
 
@@ -66,20 +70,52 @@ static SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig)
                  : SK_ColorTRANSPARENT;
 }
 
-template <typename T>
+namespace {
+// The compressed contents of one image XObject stream.  Kept apart from the
+// document (which assigns object numbers) so that it can be cached across
+// documents in an SkPDF::ImageCache.
+struct EncodedStream {
+    enum class ColorSpace : uint8_t {
+        kGray,
+        kRGB,
+        kCMYK,  // Adobe-style inverted CMYK, as SkJpegCodec assumes.
+        kYCCK,  // DCT-encoded as YCCK, decodes to inverted CMYK.
+    };
+    sk_sp<SkData> fData;
+    SkISize fSize = {0, 0};
+    ColorSpace fColorSpace = ColorSpace::kGray;
+    bool fIsJpeg = false;
+};
+
+struct EncodedImage {
+    EncodedStream fImage;
+    EncodedStream fAlpha;  // Empty if the image is opaque.
+    // How fImage's pixels must be transformed to be displayed, e.g. from an EXIF tag.
+    SkEncodedOrigin fOrigin = kTopLeft_SkEncodedOrigin;
+};
+}  // namespace
+
 static void emit_image_stream(SkPDFDocument* doc,
                               SkPDFIndirectReference ref,
-                              T writeStream,
-                              SkISize size,
-                              const char* colorSpace,
-                              SkPDFIndirectReference sMask,
-                              int length,
-                              bool isJpeg) {
+                              const EncodedStream& encoded,
+                              SkPDFIndirectReference sMask) {
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
-    pdfDict.insertInt("Width", size.width());
-    pdfDict.insertInt("Height", size.height());
-    pdfDict.insertName("ColorSpace", colorSpace);
+    pdfDict.insertInt("Width", encoded.fSize.width());
+    pdfDict.insertInt("Height", encoded.fSize.height());
+    switch (encoded.fColorSpace) {
+        case EncodedStream::ColorSpace::kGray:
+            pdfDict.insertName("ColorSpace", "DeviceGray");
+            break;
+        case EncodedStream::ColorSpace::kRGB:
+            pdfDict.insertName("ColorSpace", "DeviceRGB");
+            break;
+        case EncodedStream::ColorSpace::kCMYK:
+        case EncodedStream::ColorSpace::kYCCK:
+            pdfDict.insertName("ColorSpace", "DeviceCMYK");
+            pdfDict.insertObject("Decode", SkPDFMakeArray(1, 0, 1, 0, 1, 0, 1, 0));
+            break;
+    }
     if (sMask) {
         pdfDict.insertRef("SMask", sMask);
     }
@@ -87,19 +123,73 @@ static void emit_image_stream(SkPDFDocument* doc,
     #ifdef SK_PDF_BASE85_BINARY
     auto filters = SkPDFMakeArray();
     filters->appendName("ASCII85Decode");
-    filters->appendName(isJpeg ? "DCTDecode" : "FlateDecode");
+    filters->appendName(encoded.fIsJpeg ? "DCTDecode" : "FlateDecode");
     pdfDict.insertObject("Filter", std::move(filters));
     #else
-    pdfDict.insertName("Filter", isJpeg ? "DCTDecode" : "FlateDecode");
+    pdfDict.insertName("Filter", encoded.fIsJpeg ? "DCTDecode" : "FlateDecode");
     #endif
-    if (isJpeg) {
-        pdfDict.insertInt("ColorTransform", 0);
+    if (encoded.fIsJpeg) {
+        pdfDict.insertInt("ColorTransform",
+                          encoded.fColorSpace == EncodedStream::ColorSpace::kYCCK ? 1 : 0);
     }
-    pdfDict.insertInt("Length", length);
-    doc->emitStream(pdfDict, std::move(writeStream), ref);
+    const SkData* data = encoded.fData.get();
+    pdfDict.insertInt("Length", SkToInt(data->size()));
+    doc->emitStream(pdfDict,
+                    [data](SkWStream* dst) { dst->write(data->data(), data->size()); },
+                    ref);
 }
 
-static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
+// Emits a Form XObject at ref that draws image, stored with the given origin, upright.
+static void emit_oriented_form(SkPDFDocument* doc,
+                               SkPDFIndirectReference ref,
+                               SkPDFIndirectReference image,
+                               SkEncodedOrigin origin) {
+    // Both the image and the form fill the unit square.  SkEncodedOrigin is
+    // expressed in y-down coordinates, so flip into and out of PDF's y-up space.
+    SkMatrix flip = SkMatrix::MakeAll(1, 0, 0, 0, -1, 1, 0, 0, 1);
+    SkMatrix transform = SkMatrix::Concat(SkMatrix::Concat(flip,
+                                                           SkEncodedOriginToMatrix(origin, 1, 1)),
+                                          flip);
+    SkDynamicMemoryWStream content;
+    SkPDFUtils::AppendTransform(transform, &content);
+    SkPDFWriteResourceName(&content, SkPDFResourceType::kXObject, image.fValue);
+    content.writeText(" Do\n");
+
+    SkPDFDict pdfDict("XObject");
+    pdfDict.insertName("Subtype", "Form");
+    pdfDict.insertObject("BBox", SkPDFMakeArray(0, 0, 1, 1));
+    pdfDict.insertObject("Resources", SkPDFMakeResourceDict({}, {}, {image}, {}));
+    pdfDict.insertInt("Length", SkToInt(content.bytesWritten()));
+    doc->emitStream(pdfDict,
+                    [&content](SkWStream* dst) { content.writeToAndReset(dst); },
+                    ref);
+}
+
+static void emit_image(const EncodedImage& encoded, SkPDFDocument* doc,
+                       SkPDFIndirectReference ref) {
+    SkPDFIndirectReference imageRef = ref;
+    if (encoded.fOrigin != kTopLeft_SkEncodedOrigin) {
+        imageRef = doc->reserveRef();
+        emit_oriented_form(doc, ref, imageRef, encoded.fOrigin);
+    }
+    SkPDFIndirectReference sMask;
+    if (encoded.fAlpha.fData) {
+        sMask = doc->reserveRef();
+    }
+    emit_image_stream(doc, imageRef, encoded.fImage, sMask);
+    if (sMask) {
+        emit_image_stream(doc, sMask, encoded.fAlpha, SkPDFIndirectReference());
+    }
+}
+
+static sk_sp<SkData> finish_deflated(SkDynamicMemoryWStream* buffer) {
+    #ifdef SK_PDF_BASE85_BINARY
+    SkPDFUtils::Base85Encode(buffer->detachAsStream(), buffer);
+    #endif
+    return buffer->detachAsData();
+}
+
+static EncodedStream do_deflated_alpha(const SkPixmap& pm) {
     SkDynamicMemoryWStream buffer;
     SkDeflateWStream deflateWStream(&buffer);
     if (kAlpha_8_SkColorType == pm.colorType()) {
@@ -126,37 +216,28 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
     }
     deflateWStream.finalize();
 
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), "DeviceGray", SkPDFIndirectReference(),
-                      length, false);
+    EncodedStream alpha;
+    alpha.fData = finish_deflated(&buffer);
+    alpha.fSize = pm.info().dimensions();
+    alpha.fColorSpace = EncodedStream::ColorSpace::kGray;
+    return alpha;
 }
 
-static void do_deflated_image(const SkPixmap& pm,
-                              SkPDFDocument* doc,
-                              bool isOpaque,
-                              SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
+static EncodedImage do_deflated_image(const SkPixmap& pm, bool isOpaque) {
     SkDynamicMemoryWStream buffer;
     SkDeflateWStream deflateWStream(&buffer);
-    const char* colorSpace = "DeviceGray";
+    auto colorSpace = EncodedStream::ColorSpace::kGray;
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
             fill_stream(&deflateWStream, '\x00', pm.width() * pm.height());
             break;
         case kGray_8_SkColorType:
-            SkASSERT(sMask.fValue = -1);
+            SkASSERT(isOpaque);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
             deflateWStream.write(pm.addr8(), pm.width() * pm.height());
             break;
         default:
-            colorSpace = "DeviceRGB";
+            colorSpace = EncodedStream::ColorSpace::kRGB;
             SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
             SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
             SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
@@ -183,19 +264,22 @@ static void do_deflated_image(const SkPixmap& pm,
             deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), colorSpace, sMask, length, false);
+
+    EncodedImage encoded;
+    encoded.fImage.fData = finish_deflated(&buffer);
+    encoded.fImage.fSize = pm.info().dimensions();
+    encoded.fImage.fColorSpace = colorSpace;
     if (!isOpaque) {
-        do_deflated_alpha(pm, doc, sMask);
+        encoded.fAlpha = do_deflated_alpha(pm);
     }
+    return encoded;
 }
 
-static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference ref) {
+// If the JPEG in data can be embedded directly, sets encoded to it and returns true.
+// size is the image's size as displayed.  If origin is not set, the JPEG's EXIF
+// orientation is used.
+static bool do_jpeg(sk_sp<SkData> data, SkISize size, EncodedImage* encoded,
+                    const SkEncodedOrigin* origin = nullptr) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -203,11 +287,27 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
                        &jpegColorType, &exifOrientation)) {
         return false;
     }
-    bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-    bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-    if (jpegSize != size  // Safety check.
-            || !goodColorType
-            || kTopLeft_SkEncodedOrigin != exifOrientation) {
+    EncodedStream::ColorSpace colorSpace;
+    switch (jpegColorType) {
+        case SkEncodedInfo::kGray_Color:         colorSpace = EncodedStream::ColorSpace::kGray;
+                                                 break;
+        case SkEncodedInfo::kYUV_Color:
+        case SkEncodedInfo::kRGB_Color:          colorSpace = EncodedStream::ColorSpace::kRGB;
+                                                 break;
+        case SkEncodedInfo::kInvertedCMYK_Color: colorSpace = EncodedStream::ColorSpace::kCMYK;
+                                                 break;
+        case SkEncodedInfo::kYCCK_Color:         colorSpace = EncodedStream::ColorSpace::kYCCK;
+                                                 break;
+        default:
+            return false;
+    }
+    if (origin) {
+        exifOrientation = *origin;
+    }
+    if (SkEncodedOriginSwapsWidthHeight(exifOrientation)) {
+        jpegSize = {jpegSize.height(), jpegSize.width()};
+    }
+    if (jpegSize != size) {  // Safety check.
         return false;
     }
     #ifdef SK_PDF_BASE85_BINARY
@@ -216,13 +316,134 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
     data = buffer.detachAsData();
     #endif
 
-    emit_image_stream(doc, ref,
-                      [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, yuv ? "DeviceRGB" : "DeviceGray",
-                      SkPDFIndirectReference(), SkToInt(data->size()), true);
+    encoded->fImage.fData = std::move(data);
+    encoded->fImage.fSize = SkEncodedOriginSwapsWidthHeight(exifOrientation)
+                          ? SkISize{size.height(), size.width()}
+                          : size;
+    encoded->fImage.fColorSpace = colorSpace;
+    encoded->fImage.fIsJpeg = true;
+    encoded->fAlpha = EncodedStream();
+    encoded->fOrigin = exifOrientation;
     return true;
 }
 
+// Re-encodes a YUV-decodable image (i.e. a JPEG that could not be embedded as is)
+// straight from its decoded planes, skipping the conversion to and from RGB.
+static bool do_yuv_jpeg(sk_sp<SkData> data, SkISize size, int encodingQuality,
+                        EncodedImage* encoded) {
+    std::unique_ptr<SkImageGenerator> generator =
+            SkImageGenerator::MakeFromEncoded(std::move(data));
+    if (!generator) {
+        return false;
+    }
+    SkYUVAPixmapInfo::SupportedDataTypes supportedDataTypes;
+    supportedDataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+    SkYUVAPixmapInfo yuvaPixmapInfo;
+    if (!generator->queryYUVAInfo(supportedDataTypes, &yuvaPixmapInfo) ||
+        yuvaPixmapInfo.yuvaInfo().dimensions() != size ||
+        yuvaPixmapInfo.yuvaInfo().planeConfig() != SkYUVAInfo::PlaneConfig::kY_U_V ||
+        yuvaPixmapInfo.yuvaInfo().yuvColorSpace() != kJPEG_Full_SkYUVColorSpace) {
+        return false;
+    }
+    SkYUVAPixmaps yuvaPixmaps = SkYUVAPixmaps::Allocate(yuvaPixmapInfo);
+    if (!generator->getYUVAPlanes(yuvaPixmaps)) {
+        return false;
+    }
+    SkDynamicMemoryWStream buffer;
+    SkJpegEncoder::Options options;
+    options.fQuality = encodingQuality;
+    if (!SkJpegEncoder::Encode(&buffer, yuvaPixmaps, nullptr, options)) {
+        return false;
+    }
+    SkEncodedOrigin origin = yuvaPixmapInfo.yuvaInfo().origin();
+    return do_jpeg(buffer.detachAsData(), size, encoded, &origin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr uint32_t kImageCacheVersion = 2;
+
+static sk_sp<SkData> make_image_cache_key(const SkImageContentKey& contentKey,
+                                          int encodingQuality) {
+    SkDynamicMemoryWStream key;
+    key.write("SkPDFImage", 10);
+    key.write32(kImageCacheVersion);
+    #ifdef SK_PDF_BASE85_BINARY
+    key.writeBool(true);
+    #else
+    key.writeBool(false);
+    #endif
+    key.write32(SkToU32(std::min(encodingQuality, 101)));
+    key.write(&contentKey, sizeof(contentKey));
+    return key.detachAsData();
+}
+
+static void write_encoded_stream(const EncodedStream& encoded, SkWStream* dst) {
+    dst->write32(SkToU32(encoded.fSize.width()));
+    dst->write32(SkToU32(encoded.fSize.height()));
+    dst->write8(static_cast<uint8_t>(encoded.fColorSpace));
+    dst->writeBool(encoded.fIsJpeg);
+    dst->write32(SkToU32(encoded.fData->size()));
+    dst->write(encoded.fData->data(), encoded.fData->size());
+}
+
+static bool read_encoded_stream(SkStream* src, EncodedStream* encoded) {
+    uint32_t width, height, size;
+    uint8_t colorSpace;
+    bool isJpeg;
+    if (!src->readU32(&width) || !src->readU32(&height) ||
+        !src->readU8(&colorSpace) || !src->readBool(&isJpeg) ||
+        !src->readU32(&size) || size > src->getLength() - src->getPosition() ||
+        colorSpace > static_cast<uint8_t>(EncodedStream::ColorSpace::kYCCK)) {
+        return false;
+    }
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    if (src->read(data->writable_data(), size) != size) {
+        return false;
+    }
+    encoded->fData = std::move(data);
+    encoded->fSize = SkISize::Make(SkToInt(width), SkToInt(height));
+    encoded->fColorSpace = static_cast<EncodedStream::ColorSpace>(colorSpace);
+    encoded->fIsJpeg = isJpeg;
+    return true;
+}
+
+static sk_sp<SkData> write_encoded_image(const EncodedImage& encoded) {
+    SkDynamicMemoryWStream dst;
+    dst.write8(SkToU8(encoded.fOrigin));
+    write_encoded_stream(encoded.fImage, &dst);
+    dst.writeBool(encoded.fAlpha.fData != nullptr);
+    if (encoded.fAlpha.fData) {
+        write_encoded_stream(encoded.fAlpha, &dst);
+    }
+    return dst.detachAsData();
+}
+
+static bool read_encoded_image(const SkData& data, SkISize size, EncodedImage* encoded) {
+    SkMemoryStream src(data.data(), data.size(), false);
+    uint8_t origin;
+    bool hasAlpha;
+    if (!src.readU8(&origin) || origin < kTopLeft_SkEncodedOrigin ||
+        origin > kLast_SkEncodedOrigin) {
+        return false;
+    }
+    if (!read_encoded_stream(&src, &encoded->fImage) || !src.readBool(&hasAlpha)) {
+        return false;
+    }
+    if (hasAlpha && !read_encoded_stream(&src, &encoded->fAlpha)) {
+        return false;
+    }
+    encoded->fOrigin = static_cast<SkEncodedOrigin>(origin);
+    // Safety check against a mismatched or corrupt cache.
+    SkISize storedSize = SkEncodedOriginSwapsWidthHeight(encoded->fOrigin)
+                       ? SkISize{size.height(), size.width()}
+                       : size;
+    return encoded->fImage.fSize == storedSize &&
+           (!hasAlpha || encoded->fAlpha.fSize == storedSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 static SkBitmap to_pixels(const SkImage* image) {
     SkBitmap bm;
     int w = image->width(),
@@ -247,17 +468,19 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
-    SkASSERT(img);
-    SkASSERT(doc);
-    SkASSERT(encodingQuality >= 0);
+static EncodedImage encode_image(const SkImage* img, int encodingQuality) {
     SkISize dimensions = img->dimensions();
+    EncodedImage encoded;
     if (sk_sp<SkData> data = img->refEncodedData()) {
-        if (do_jpeg(std::move(data), doc, dimensions, ref)) {
-            return;
+        if (do_jpeg(std::move(data), dimensions, &encoded)) {
+            return encoded;
+        }
+    }
+    if (encodingQuality <= 100) {
+        if (sk_sp<SkData> data = img->refEncodedData()) {
+            if (do_yuv_jpeg(std::move(data), dimensions, encodingQuality, &encoded)) {
+                return encoded;
+            }
         }
     }
     SkBitmap bm = to_pixels(img);
@@ -265,30 +488,58 @@ void serialize_image(const SkImage* img,
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
     if (encodingQuality <= 100 && isOpaque) {
         if (sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality)) {
-            if (do_jpeg(std::move(data), doc, dimensions, ref)) {
+            if (do_jpeg(std::move(data), dimensions, &encoded)) {
+                return encoded;
+            }
+        }
+    }
+    return do_deflated_image(pm, isOpaque);
+}
+
+static void serialize_image(const SkImage* img,
+                            int encodingQuality,
+                            const SkImageContentKey& contentKey,
+                            SkPDFDocument* doc,
+                            SkPDFIndirectReference ref) {
+    SkASSERT(img);
+    SkASSERT(doc);
+    SkASSERT(encodingQuality >= 0);
+    SkPDF::ImageCache* cache = doc->metadata().fImageCache;
+    sk_sp<SkData> cacheKey;
+    if (cache && contentKey) {
+        cacheKey = make_image_cache_key(contentKey, encodingQuality);
+        if (sk_sp<SkData> cached = cache->load(*cacheKey)) {
+            EncodedImage encoded;
+            if (read_encoded_image(*cached, img->dimensions(), &encoded)) {
+                emit_image(encoded, doc, ref);
                 return;
             }
         }
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+    EncodedImage encoded = encode_image(img, encodingQuality);
+    if (cacheKey) {
+        cache->store(*cacheKey, *write_encoded_image(encoded));
+    }
+    emit_image(encoded, doc, ref);
 }
 
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
-                                           int encodingQuality) {
+                                           int encodingQuality,
+                                           const SkImageContentKey& contentKey) {
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
     if (SkExecutor* executor = doc->executor()) {
         SkRef(img);
         doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
-            serialize_image(img, encodingQuality, doc, ref);
+        executor->add([img, encodingQuality, contentKey, doc, ref]() {
+            serialize_image(img, encodingQuality, contentKey, doc, ref);
             SkSafeUnref(img);
             doc->signalJobComplete();
         });
         return ref;
     }
-    serialize_image(img, encodingQuality, doc, ref);
+    serialize_image(img, encodingQuality, contentKey, doc, ref);
     return ref;
 }
@@ -7,6 +7,8 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "src/pdf/SkBitmapKey.h"
+
 class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
@@ -14,9 +16,12 @@ struct SkPDFIndirectReference;
 /**
  * Serialize a SkImage as an Image Xobject.
  *  quality > 100 means lossless
+ *  If contentKey is set, the encoded XObject is looked up in and stored to the
+ *  document's SkPDF::ImageCache, if any.
  */
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
-                                           int encodingQuality = 101);
+                                           int encodingQuality = 101,
+                                           const SkImageContentKey& contentKey = {});
 
 #endif  // SkPDFBitmap_DEFINED
@@ -1670,8 +1670,22 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
     if (!pdfimagePtr) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
+        // Different SkImages with the same contents (e.g. the same logo decoded
+        // twice) share one XObject.  The key is only a hash, so compare the contents too.
+        SkImageContentKey contentKey = SkImageContentKeyFromImage(imageSubset.image().get());
+        auto* contentPtr = contentKey ? fDocument->fPDFImageContentMap.find(contentKey) : nullptr;
+        if (contentPtr && SkImageContentsEqual(contentPtr->fImage.get(),
+                                               imageSubset.image().get(), contentKey)) {
+            pdfimage = contentPtr->fRef;
+        } else {
+            // On a collision, don't let the image cache mix up the two images either.
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality,
+                                           contentPtr ? SkImageContentKey() : contentKey);
+            if (contentKey && !contentPtr) {
+                fDocument->fPDFImageContentMap.set(contentKey, {imageSubset.image(), pdfimage});
+            }
+        }
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
         fDocument->fPDFBitmapMap.set(key, pdfimage);
     }
@@ -8,6 +8,7 @@
 #define SkPDFDocumentPriv_DEFINED
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkMutex.h"
@@ -24,6 +25,7 @@ class SkPDFDevice;
 class SkPDFFont;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
+struct SkImageContentKey;
 struct SkPDFFillGraphicState;
 struct SkPDFImageShaderKey;
 struct SkPDFStrokeGraphicState;
@@ -142,6 +144,13 @@ public:
     SkTHashMap<SkPDFGradientShader::Key, SkPDFIndirectReference, SkPDFGradientShader::KeyHash>
         fGradientPatternMap;
     SkTHashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
+    // The first image seen with each content key, kept to check that later images with the
+    // same key really have the same contents before sharing its XObject.
+    struct ImageContent {
+        sk_sp<SkImage> fImage;
+        SkPDFIndirectReference fRef;
+    };
+    SkTHashMap<SkImageContentKey, ImageContent> fPDFImageContentMap;
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
     SkTHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
@@ -12,12 +12,19 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/core/SkUnPreMultiply.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkMatrixProvider.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkResourceCache.h"
 #include "src/core/SkVM.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/shaders/SkPerlinNoiseShaderPriv.h"
+
+#include <atomic>
 
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrRecordingContext.h"
@@ -36,6 +43,97 @@ static const int kBlockMask = kBlockSize - 1;
 static const int kPerlinNoise = 4096;
 static const int kRandMaximum = SK_MaxS32; // 2**31 - 1
 
+// The CPU shades this many pixels at once: one SSE or NEON register of floats.  Wider vectors
+// measured slower, as the lattice lookups are gathers done a lane at a time either way.
+static constexpr int kNoiseLanes = 4;
+
+// The most pixels of a stitch tile we'll keep shaded in the resource cache.
+static constexpr int kMaxTileCachePixels = 512 * 512;
+
+// Opt-in: keep shaded stitch tiles in the resource cache.  See
+// SkGraphics::SetPerlinNoiseTileCacheEnabled().
+static std::atomic<bool> gCachePerlinNoiseTiles{false};
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gPerlinNoiseTileKeyNamespaceLabel;
+
+// Everything the shaded pixels of a stitch tile depend on.
+struct PerlinNoiseTileKey : public SkResourceCache::Key {
+public:
+    PerlinNoiseTileKey(int type, SkScalar baseFrequencyX, SkScalar baseFrequencyY,
+                       int numOctaves, SkScalar seed, const SkISize& tileSize,
+                       const SkMatrix& matrix, U8CPU alpha)
+        : fType(type)
+        , fBaseFrequencyX(baseFrequencyX)
+        , fBaseFrequencyY(baseFrequencyY)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fTileWidth(tileSize.width())
+        , fTileHeight(tileSize.height())
+        , fAlpha(alpha)
+    {
+        matrix.get9(fMatrix);
+        this->init(&gPerlinNoiseTileKeyNamespaceLabel, 0,
+                   sizeof(fType) + sizeof(fBaseFrequencyX) + sizeof(fBaseFrequencyY) +
+                   sizeof(fNumOctaves) + sizeof(fSeed) + sizeof(fTileWidth) +
+                   sizeof(fTileHeight) + sizeof(fAlpha) + sizeof(fMatrix));
+    }
+
+    int32_t  fType;
+    SkScalar fBaseFrequencyX;
+    SkScalar fBaseFrequencyY;
+    int32_t  fNumOctaves;
+    SkScalar fSeed;
+    int32_t  fTileWidth;
+    int32_t  fTileHeight;
+    int32_t  fAlpha;
+    SkScalar fMatrix[9];
+};
+
+struct PerlinNoiseTileRec : public SkResourceCache::Rec {
+    PerlinNoiseTileRec(const PerlinNoiseTileKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~PerlinNoiseTileRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    PerlinNoiseTileKey fKey;
+    SkCachedData*      fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "perlin-noise-tile"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PerlinNoiseTileRec& rec = static_cast<const PerlinNoiseTileRec&>(baseRec);
+        SkCachedData** result = (SkCachedData**)contextData;
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+}  // namespace
+
+bool SkPerlinNoiseShaderPriv::SetTileCacheEnabled(bool enabled) {
+    return gCachePerlinNoiseTiles.exchange(enabled);
+}
+
 class SkPerlinNoiseShaderImpl : public SkShaderBase {
 public:
     struct StitchData {
@@ -279,12 +377,19 @@ public:
 
     class PerlinNoiseShaderContext : public Context {
     public:
-        PerlinNoiseShaderContext(const SkPerlinNoiseShaderImpl& shader, const ContextRec&);
+        // Shades several pixels at a time if vectorized, and then keeps stitch tiles in
+        // localCache, or the global resource cache if it's null, when useTileCache is set.
+        PerlinNoiseShaderContext(const SkPerlinNoiseShaderImpl& shader, const ContextRec&,
+                                 bool vectorized, bool useTileCache,
+                                 SkResourceCache* localCache);
 
         void shadeSpan(int x, int y, SkPMColor[], int count) override;
 
     private:
+        SkPoint noisePoint(const SkPoint& point) const;
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
+        // Shades kNoiseLanes noise points (as returned by noisePoint()) at once.
+        void shadeLanes(const float pointX[], const float pointY[], SkPMColor result[]) const;
         SkScalar calculateTurbulenceValueForPoint(
                                                   int channel,
                                                   StitchData& stitchData, const SkPoint& point) const;
@@ -293,6 +398,11 @@ public:
 
         SkMatrix     fMatrix;
         PaintingData fPaintingData;
+        bool         fVectorized;
+
+        // The shaded noise points in [1,width]x[1,height] of the stitch tile, if we have them.
+        sk_sp<SkCachedData> fTileCache;
+        SkISize             fTileCacheSize = {0, 0};
 
         using INHERITED = Context;
     };
@@ -326,7 +436,15 @@ private:
     const SkISize                   fTileSize;
     const bool                      fStitchTiles;
 
+    // The last matrix and paint alpha a stitched shader was drawn with.  Its tile is only shaded
+    // into the resource cache once it has been drawn with them twice in a row.
+    mutable SkMutex                 fTileCacheMutex;
+    mutable SkMatrix                fTileCacheMatrix;
+    mutable U8CPU                   fTileCacheAlpha = 0;
+    mutable bool                    fTileCacheKeyed = false;
+
     friend class ::SkPerlinNoiseShader;
+    friend class ::SkPerlinNoiseShaderPriv;
 
     using INHERITED = SkShaderBase;
 };
@@ -508,12 +626,18 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceV
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
+SkPoint SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noisePoint(
+        const SkPoint& point) const {
     SkPoint newPoint;
     fMatrix.mapPoints(&newPoint, &point, 1);
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
     newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
+    return newPoint;
+}
+
+SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
+        const SkPoint& point, StitchData& stitchData) const {
+    SkPoint newPoint = this->noisePoint(point);
 
     U8CPU rgba[4];
     for (int channel = 3; channel >= 0; --channel) {
@@ -524,11 +648,120 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
 
+// This is calculateTurbulenceValueForPoint() and noise2D() for kNoiseLanes points at once.  The
+// lattice cell and interpolation weights don't depend on the channel, so each octave finds them
+// once and then shades all four channels.
+void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeLanes(
+        const float pointX[], const float pointY[], SkPMColor result[]) const {
+    using F = skvx::Vec<kNoiseLanes, float>;
+    using I = skvx::Vec<kNoiseLanes, int32_t>;
+
+    const SkPerlinNoiseShaderImpl& perlinNoiseShader =
+            static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
+    const bool fractal = perlinNoiseShader.fType == kFractalNoise_Type;
+
+    auto floor_to_int = [](const F& v) {
+        I i = skvx::cast<int32_t>(v);
+        return skvx::if_then_else(skvx::cast<float>(i) > v, i - 1, i);
+    };
+    auto stitch = [](const I& v, int limitValue, int newValue) {
+        return skvx::if_then_else(v >= limitValue, v - newValue, v);
+    };
+
+    F turbulence[4] = {0, 0, 0, 0};
+    F noiseX = F::Load(pointX) * fPaintingData.fBaseFrequency.fX,
+      noiseY = F::Load(pointY) * fPaintingData.fBaseFrequency.fY;
+    StitchData stitchData = fPaintingData.fStitchDataInit;
+    SkScalar ratio = SK_Scalar1;
+    for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
+        F positionX = noiseX + kPerlinNoise,
+          positionY = noiseY + kPerlinNoise;
+        I x0 = floor_to_int(positionX),
+          y0 = floor_to_int(positionY);
+        F fx = positionX - skvx::cast<float>(x0),
+          fy = positionY - skvx::cast<float>(y0);
+        I x1 = x0 + 1,
+          y1 = y0 + 1;
+        if (perlinNoiseShader.fStitchTiles) {
+            x0 = stitch(x0, stitchData.fWrapX, stitchData.fWidth);
+            y0 = stitch(y0, stitchData.fWrapY, stitchData.fHeight);
+            x1 = stitch(x1, stitchData.fWrapX, stitchData.fWidth);
+            y1 = stitch(y1, stitchData.fWrapY, stitchData.fHeight);
+        }
+        x0 &= kBlockMask;
+        y0 &= kBlockMask;
+        x1 &= kBlockMask;
+        y1 &= kBlockMask;
+
+        I i, j;
+        for (int k = 0; k < kNoiseLanes; ++k) {
+            i[k] = fPaintingData.fLatticeSelector[x0[k]];
+            j[k] = fPaintingData.fLatticeSelector[x1[k]];
+        }
+        const I b00 = (i + y0) & kBlockMask,
+                b10 = (j + y0) & kBlockMask,
+                b01 = (i + y1) & kBlockMask,
+                b11 = (j + y1) & kBlockMask;
+        const F sx = fx * fx * (3 - 2 * fx),
+                sy = fy * fy * (3 - 2 * fy);
+        const auto pathological = (sx < 0) | (sy < 0) | (sx > 1) | (sy > 1);
+        const F fx1 = fx - SK_Scalar1,
+                fy1 = fy - SK_Scalar1;
+
+        for (int channel = 0; channel < 4; ++channel) {
+            const SkPoint* gradient = fPaintingData.fGradient[channel];
+            auto dot = [gradient](const I& b, const F& x, const F& y) {
+                F gx, gy;
+                for (int k = 0; k < kNoiseLanes; ++k) {
+                    gx[k] = gradient[b[k]].fX;
+                    gy[k] = gradient[b[k]].fY;
+                }
+                return gx * x + gy * y;
+            };
+            F u = dot(b00, fx , fy ),
+              v = dot(b10, fx1, fy );
+            F a = u + (v - u) * sx;
+            v = dot(b11, fx1, fy1);
+            u = dot(b01, fx , fy1);
+            F b = u + (v - u) * sx;
+            F noise = skvx::if_then_else(pathological, F(0), a + (b - a) * sy);
+            turbulence[channel] += (fractal ? noise : skvx::abs(noise)) / ratio;
+        }
+
+        noiseX *= 2;
+        noiseY *= 2;
+        ratio *= 2;
+        if (perlinNoiseShader.fStitchTiles) {
+            stitchData = StitchData(SkIntToScalar(stitchData.fWidth) * 2,
+                                    SkIntToScalar(stitchData.fHeight) * 2);
+        }
+    }
+
+    I rgba[4];
+    for (int channel = 0; channel < 4; ++channel) {
+        F value = turbulence[channel];
+        if (fractal) {
+            value = (value + 1) * SK_ScalarHalf;
+        }
+        if (channel == 3) {
+            value *= SkIntToScalar(getPaintAlpha()) / 255;
+        }
+        // As SkTPin(), sending NaN to 0.
+        value = skvx::if_then_else(value > 1, F(1), value);
+        value = skvx::if_then_else(value > 0, value, F(0));
+        rgba[channel] = floor_to_int(255 * value);
+    }
+    for (int k = 0; k < kNoiseLanes; ++k) {
+        result[k] = SkPreMultiplyARGB(rgba[3][k], rgba[0][k], rgba[1][k], rgba[2][k]);
+    }
+}
+
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
 SkShaderBase::Context* SkPerlinNoiseShaderImpl::onMakeContext(const ContextRec& rec,
                                                               SkArenaAlloc* alloc) const {
     // should we pay attention to rec's device-colorspace?
-    return alloc->make<PerlinNoiseShaderContext>(*this, rec);
+    return alloc->make<PerlinNoiseShaderContext>(*this, rec, /*vectorized=*/true,
+                                                 gCachePerlinNoiseTiles.load(), nullptr);
 }
 #endif
 
@@ -543,26 +776,138 @@ static inline SkMatrix total_matrix(const SkShaderBase::ContextRec& rec,
 }
 
 SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
-        const SkPerlinNoiseShaderImpl& shader, const ContextRec& rec)
+        const SkPerlinNoiseShaderImpl& shader, const ContextRec& rec, bool vectorized,
+        bool useTileCache, SkResourceCache* localCache)
     : INHERITED(shader, rec)
     , fMatrix(total_matrix(rec, shader)) // used for temp storage, adjusted below
     , fPaintingData(shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX,
                     shader.fBaseFrequencyY, fMatrix)
+    , fVectorized(vectorized)
 {
+    const SkMatrix totalMatrix = fMatrix;
     // This (1,1) translation is due to WebKit's 1 based coordinates for the noise
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
     fMatrix.setTranslate(-fMatrix.getTranslateX() + SK_Scalar1,
                          -fMatrix.getTranslateY() + SK_Scalar1);
+
+    // A stitched shader is usually drawn over its tile, often again and again with nothing
+    // changed, e.g. an feTurbulence under animated content.  Once we see the same matrix and paint
+    // alpha twice in a row, shade the whole tile into the resource cache, and copy from it for as
+    // long as they stay the same.
+    const SkISize tileSize = fPaintingData.fTileSize;
+    if (!fVectorized || !useTileCache || !shader.fStitchTiles || tileSize.isEmpty() ||
+        tileSize.width() > kMaxTileCachePixels / tileSize.height()) {
+        return;
+    }
+    {
+        SkAutoMutexExclusive lock(shader.fTileCacheMutex);
+        const bool sameKey = shader.fTileCacheKeyed &&
+                             shader.fTileCacheMatrix == totalMatrix &&
+                             shader.fTileCacheAlpha == this->getPaintAlpha();
+        if (!sameKey) {
+            shader.fTileCacheMatrix = totalMatrix;
+            shader.fTileCacheAlpha  = this->getPaintAlpha();
+            shader.fTileCacheKeyed  = true;
+            return;
+        }
+    }
+
+    PerlinNoiseTileKey key(shader.fType, shader.fBaseFrequencyX, shader.fBaseFrequencyY,
+                           shader.fNumOctaves, shader.fSeed, shader.fTileSize, totalMatrix,
+                           this->getPaintAlpha());
+    SkCachedData* data = nullptr;
+    if (!CHECK_LOCAL(localCache, find, Find, key, PerlinNoiseTileRec::Visitor, &data)) {
+        const int width = tileSize.width(),
+                  count = width * tileSize.height();
+        // Round up so the last few pixels can be shaded straight into the data too.
+        const size_t size =
+                (count + kNoiseLanes - 1) / kNoiseLanes * kNoiseLanes * sizeof(SkPMColor);
+        data = localCache ? localCache->newCachedData(size) : SkResourceCache::NewCachedData(size);
+        SkPMColor* pixels = static_cast<SkPMColor*>(data->writable_data());
+        float pointX[kNoiseLanes], pointY[kNoiseLanes];
+        for (int i = 0; i < count; i += kNoiseLanes) {
+            for (int k = 0; k < kNoiseLanes; ++k) {
+                const int pixel = std::min(i + k, count - 1);
+                pointX[k] = SkIntToScalar(pixel % width + 1);
+                pointY[k] = SkIntToScalar(pixel / width + 1);
+            }
+            this->shadeLanes(pointX, pointY, pixels + i);
+        }
+        CHECK_LOCAL(localCache, add, Add, new PerlinNoiseTileRec(key, data));
+    }
+    fTileCache.reset(data);
+    fTileCacheSize = tileSize;
 }
 
 void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
+    if (!fVectorized) {
+        StitchData stitchData;
+        for (int i = 0; i < count; ++i) {
+            result[i] = shade(point, stitchData);
+            point.fX += SK_Scalar1;
+        }
+        return;
+    }
+
+    // Points the tile cache doesn't have are queued up and shaded kNoiseLanes at a time.
+    const SkPMColor* tile = fTileCache ? static_cast<const SkPMColor*>(fTileCache->data())
+                                       : nullptr;
+    float pointX[kNoiseLanes], pointY[kNoiseLanes];
+    int index[kNoiseLanes];
+    int queued = 0;
+    auto flush = [&]() {
+        for (int k = queued; k < kNoiseLanes; ++k) {
+            pointX[k] = pointX[0];
+            pointY[k] = pointY[0];
+        }
+        SkPMColor colors[kNoiseLanes];
+        this->shadeLanes(pointX, pointY, colors);
+        for (int k = 0; k < queued; ++k) {
+            result[index[k]] = colors[k];
+        }
+        queued = 0;
+    };
+
     for (int i = 0; i < count; ++i) {
-        result[i] = shade(point, stitchData);
+        const SkPoint p = this->noisePoint(point);
         point.fX += SK_Scalar1;
+        if (tile && p.fX >= 1 && p.fX <= fTileCacheSize.width() &&
+                    p.fY >= 1 && p.fY <= fTileCacheSize.height()) {
+            result[i] = tile[(SkScalarTruncToInt(p.fY) - 1) * fTileCacheSize.width() +
+                             (SkScalarTruncToInt(p.fX) - 1)];
+            continue;
+        }
+        pointX[queued] = p.fX;
+        pointY[queued] = p.fY;
+        index[queued] = i;
+        if (++queued == kNoiseLanes) {
+            flush();
+        }
+    }
+    if (queued) {
+        flush();
+    }
+}
+
+bool SkPerlinNoiseShaderPriv::ShadeForTesting(const SkShader& shader, const SkMatrix& ctm,
+                                              U8CPU alpha, const SkIRect& area, bool vectorized,
+                                              SkResourceCache* tileCache, SkBitmap* dst) {
+    if (strcmp(shader.getTypeName(), "SkPerlinNoiseShaderImpl") != 0 || ctm.hasPerspective() ||
+        !dst->tryAllocPixels(SkImageInfo::MakeN32Premul(area.width(), area.height()))) {
+        return false;
     }
+    SkPaint paint;
+    paint.setAlpha(alpha);
+    SkShaderBase::ContextRec rec(paint, ctm, nullptr, kN32_SkColorType, nullptr);
+    SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext context(
+            static_cast<const SkPerlinNoiseShaderImpl&>(shader), rec, vectorized,
+            /*useTileCache=*/tileCache != nullptr, tileCache);
+    for (int y = 0; y < area.height(); ++y) {
+        context.shadeSpan(area.fLeft, area.fTop + y, dst->getAddr32(0, y), area.width());
+    }
+    return true;
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPerlinNoiseShaderPriv_DEFINED
+#define SkPerlinNoiseShaderPriv_DEFINED
+
+#include "include/core/SkColor.h"
+#include "include/core/SkRect.h"
+
+class SkBitmap;
+class SkMatrix;
+class SkResourceCache;
+class SkShader;
+
+class SkPerlinNoiseShaderPriv {
+public:
+    // See SkGraphics::SetPerlinNoiseTileCacheEnabled().
+    static bool SetTileCacheEnabled(bool enabled);
+
+    // Shades area of shader, which must come from SkPerlinNoiseShader, into dst as one raster draw
+    // with ctm and paint alpha would. If vectorized is false every pixel is shaded on its own;
+    // otherwise several at a time, and stitch tiles are kept in tileCache when it isn't null.
+    static bool ShadeForTesting(const SkShader& shader, const SkMatrix& ctm, U8CPU alpha,
+                                const SkIRect& area, bool vectorized, SkResourceCache* tileCache,
+                                SkBitmap* dst);
+};
+
+#endif
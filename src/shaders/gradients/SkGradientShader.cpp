@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include "include/core/SkData.h"
 #include "include/core/SkMallocPixelRef.h"
 #include "include/private/SkFloatBits.h"
 #include "include/private/SkHalf.h"
@@ -275,6 +276,51 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+// The number of entries covering [0,1] in the kUseColorLookupTable_Flag table.  With 1024, even a
+// 100 stop gradient gets about ten entries between stops, so interpolating between neighbouring
+// entries only differs from the exact gradient right around the stops.
+static constexpr int kColorLUTSize = 1024;
+
+// Samples the gradient described by ctx, as the given stage would, at kColorLUTSize evenly spaced
+// t in [0,1], plus the entries for t < 0 and t >= 1 that SkRasterPipeline_GradientLUTCtx expects.
+static sk_sp<SkData> make_color_lut(const SkRasterPipeline_GradientCtx& ctx,
+                                    SkRasterPipeline::StockStage stage, bool premul) {
+    sk_sp<SkData> data = SkData::MakeUninitialized((kColorLUTSize + 3) * sizeof(uint32_t));
+    uint32_t* lut = static_cast<uint32_t*>(data->writable_data());
+
+    auto eval = [&](float t) {
+        size_t idx = 0;
+        if (stage == SkRasterPipeline::evenly_spaced_gradient) {
+            // The evenly spaced stage always follows clamp_x_1, mirror_x_1 or repeat_x_1.
+            t = SkTPin(t, 0.0f, 1.0f);
+            idx = static_cast<size_t>(t * (ctx.stopCount - 1));
+        } else {
+            for (size_t i = 1; i < ctx.stopCount; i++) {
+                idx += t >= ctx.ts[i];
+            }
+        }
+
+        float c[4];
+        for (int i = 0; i < 4; i++) {
+            c[i] = t * ctx.fs[i][idx] + ctx.bs[i][idx];
+        }
+        const float a = SkTPin(c[3], 0.0f, 1.0f);
+        uint32_t rgba = static_cast<uint32_t>(a * 255 + 0.5f) << 24;
+        for (int i = 0; i < 3; i++) {
+            rgba |= static_cast<uint32_t>(SkTPin(c[i], 0.0f, premul ? a : 1.0f) * 255 + 0.5f)
+                    << (8 * i);
+        }
+        return rgba;
+    };
+
+    lut[0] = eval(-1);
+    for (int i = 0; i < kColorLUTSize; i++) {
+        lut[i + 1] = eval(i / (kColorLUTSize - 1.0f));
+    }
+    lut[kColorLUTSize + 1] = lut[kColorLUTSize + 2] = eval(2);
+    return data;
+}
+
 bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
@@ -339,6 +385,7 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
     } else {
         auto* ctx = alloc->make<SkRasterPipeline_GradientCtx>();
         ctx->interpolatedInPremul = premulGrad;
+        SkRasterPipeline::StockStage stage;
 
         // Note: In order to handle clamps in search, the search assumes a stop conceptully placed
         // at -inf. Therefore, the max number of stops is fColorCount+1.
@@ -363,7 +410,7 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
             add_const_color(ctx, stopCount - 1, c_l);
 
             ctx->stopCount = stopCount;
-            p->append(SkRasterPipeline::evenly_spaced_gradient, ctx);
+            stage = SkRasterPipeline::evenly_spaced_gradient;
         } else {
             // Handle arbitrary stops.
 
@@ -403,7 +450,30 @@ bool SkGradientShaderBase::onAppendStages(const SkStageRec& rec) const {
             add_const_color(ctx, stopCount++, c_l);
 
             ctx->stopCount = stopCount;
-            p->append(SkRasterPipeline::gradient, ctx);
+            stage = SkRasterPipeline::gradient;
+        }
+
+        if (fGradFlags & SkGradientShader::kUseColorLookupTable_Flag) {
+            sk_sp<SkData> lut;
+            {
+                SkAutoMutexExclusive lock(fColorLUTMutex);
+                if (!fColorLUT || !SkColorSpace::Equals(fColorLUTColorSpace.get(), rec.fDstCS)) {
+                    fColorLUT = make_color_lut(*ctx, stage, premulGrad);
+                    fColorLUTColorSpace = sk_ref_sp(rec.fDstCS);
+                }
+                lut = fColorLUT;
+            }
+
+            auto lutCtx = alloc->make<SkRasterPipeline_GradientLUTCtx>();
+            lutCtx->colors = static_cast<const uint32_t*>(lut->data());
+            lutCtx->scale  = kColorLUTSize - 1;
+            lutCtx->limit  = kColorLUTSize + 1;
+            // Another thread may replace fColorLUT while we draw, so hold our own ref.
+            alloc->make<sk_sp<SkData>>(std::move(lut));
+
+            p->append(SkRasterPipeline::gradient_lut, lutCtx);
+        } else {
+            p->append(stage, ctx);
         }
     }
 
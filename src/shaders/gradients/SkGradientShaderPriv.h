@@ -10,7 +10,9 @@
 
 #include "include/effects/SkGradientShader.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkMatrix.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkArenaAlloc.h"
@@ -140,6 +142,11 @@ private:
 
     bool                                        fColorsAreOpaque;
 
+    // The table for kUseColorLookupTable_Flag, for the last destination color space we drew into.
+    mutable SkMutex                             fColorLUTMutex;
+    mutable sk_sp<SkData>                       fColorLUT;
+    mutable sk_sp<SkColorSpace>                 fColorLUTColorSpace;
+
     using INHERITED = SkShaderBase;
 };
 
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2021 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTraceMemoryDump.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitterStats.h"
+#include "src/core/SkCoreBlitters.h"
+#include "src/core/SkRasterPipeline.h"
+#include "tests/Test.h"
+
+#include <map>
+#include <string>
+
+namespace {
+
+class StatsDump final : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char*,
+                          uint64_t value) override {
+        fNumbers[std::string(dumpName) + ":" + valueName] = value;
+    }
+    void dumpStringValue(const char* dumpName, const char* valueName,
+                         const char* value) override {
+        fStrings[std::string(dumpName) + ":" + valueName] = value;
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    uint64_t number(const char* dumpName, const char* valueName) const {
+        auto it = fNumbers.find(std::string(dumpName) + ":" + valueName);
+        return it == fNumbers.end() ? 0 : it->second;
+    }
+
+    std::map<std::string, uint64_t>    fNumbers;
+    std::map<std::string, std::string> fStrings;
+};
+
+}  // namespace
+
+DEF_TEST(BlitterStats, r) {
+    // Other tests may be drawing at the same time, so we can only check lower bounds.
+    const bool wasEnabled = SkGraphics::SetBlitterStatisticsEnabled(true);
+    SkGraphics::ResetBlitterStatistics();
+
+    SkPaint opaque;
+    opaque.setColor(SK_ColorBLUE);
+
+    // Which blitter SkBlitter::Choose() picks for a draw depends on global settings,
+    // so count a blitter of a kind we pick ourselves.
+    SkBitmap n32;
+    n32.allocN32Pixels(16, 16);
+    {
+        SkSTArenaAlloc<256> alloc;
+        SkBlitter* blitter = SkBlitterStats::Chose(
+                SkBlitterStats::Kind::kARGB32Opaque,
+                alloc.make<SkARGB32_Opaque_Blitter>(n32.pixmap(), opaque), &alloc);
+        blitter->blitRect(0,0, 8,4);
+    }  // Pixels are counted once the blitter is done.
+
+    // Color managed F16 draws go through SkRasterPipeline, in highp.
+    auto f16 = SkSurface::MakeRaster(SkImageInfo::Make(16, 16, kRGBA_F16_SkColorType,
+                                                       kPremul_SkAlphaType,
+                                                       SkColorSpace::MakeSRGB()));
+    f16->getCanvas()->drawRect({0,0,4,4}, opaque);
+
+    // unpremul has no lowp implementation.
+    uint32_t px = 0x80404040;
+    SkRasterPipeline_MemoryCtx ctx = {&px, 0};
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_8888, &ctx);
+    p.append(SkRasterPipeline::unpremul);
+    p.append(SkRasterPipeline::store_8888, &ctx);
+    p.run(0,0,1,1);
+
+    StatsDump dump;
+    SkGraphics::DumpMemoryStatistics(&dump);
+
+    REPORTER_ASSERT(r, dump.number("skia/blitter_stats/argb32_opaque", "choices") >= 1);
+    REPORTER_ASSERT(r, dump.number("skia/blitter_stats/argb32_opaque", "pixels") >= 8*4);
+    REPORTER_ASSERT(r, dump.number("skia/blitter_stats/raster_pipeline", "choices") +
+                       dump.number("skia/blitter_stats/vm", "choices") >= 1);
+    REPORTER_ASSERT(r, dump.number("skia/raster_pipeline_stats", "highp") >= 1);
+
+    bool sawUnpremul = false;
+    for (const auto& [name, stages] : dump.fStrings) {
+        if (stages == "load_8888 unpremul store_8888") {
+            sawUnpremul = true;
+            std::string precision = name.substr(0, name.rfind(':')) + ":precision";
+            REPORTER_ASSERT(r, dump.fStrings[precision] == "highp");
+        }
+    }
+    REPORTER_ASSERT(r, sawUnpremul);
+
+    SkGraphics::SetBlitterStatisticsEnabled(wasEnabled);
+}
@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -31,10 +32,14 @@
 #include "include/private/SkFloatBits.h"
 #include "include/private/SkTPin.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
+#include "src/core/SkMaskCache.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
+#include "src/core/SkResourceCache.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
@@ -494,6 +499,68 @@ DEF_TEST(BlurredRRectNinePatchComputation, reporter) {
     }
 }
 
+// Blurred rects of different sizes and positions, but with the same subpixel phase, should share
+// one cached nine-patch mask, and draw just as the full blur would.
+DEF_TEST(BlurRectNinePatchSharedAcrossSizes, reporter) {
+    const SkScalar sigma = 4;
+    const SkRect small = {10.25f, 10.5f,  80.25f,  60.5f},
+                 large = {63.25f, 97.5f, 153.25f, 187.5f};
+
+    // The nine-patch caches the blur of a small rect, with just one stretchable row and column in
+    // its middle, moved to within a pixel of the origin.  See filterRectsToNine() in SkBlurMF.cpp.
+    auto small_rect = [&](const SkRect& r) {
+        SkMask blurred;
+        SkIPoint margin;
+        SkAssertResult(SkBlurMask::BlurRect(sigma, &blurred, r, kNormal_SkBlurStyle, &margin,
+                                            SkMask::kJustComputeBounds_CreateMode));
+        const SkIRect ir = r.roundOut();
+        const SkScalar dx = ir.width()  - (blurred.fBounds.width()  - ir.width()  + 3),
+                       dy = ir.height() - (blurred.fBounds.height() - ir.height() + 3);
+        return SkRect::MakeLTRB(r.fLeft, r.fTop, r.fRight - dx, r.fBottom - dy)
+                .makeOffset(-SkScalarFloorToScalar(r.fLeft), -SkScalarFloorToScalar(r.fTop));
+    };
+    const SkRect key = small_rect(small);
+    REPORTER_ASSERT(reporter, key == small_rect(large));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma));
+
+    auto draw = [&](const SkRect& r) {
+        SkBitmap bm;
+        bm.allocN32Pixels(200, 200);
+        SkCanvas canvas(bm);
+        canvas.clear(SK_ColorTRANSPARENT);
+        canvas.drawRect(r, paint);
+        return bm;
+    };
+
+    // Drawing the small rect caches the shared mask...
+    draw(small);
+    SkMask cachedMask;
+    sk_sp<SkCachedData> cached(SkMaskCache::FindAndRef(sigma, kNormal_SkBlurStyle, &key, 1,
+                                                       &cachedMask));
+    REPORTER_ASSERT(reporter, cached);
+
+    // ... and the large rect drawn from it should match its own full blur.
+    SkBitmap bm = draw(large);
+    SkMask expected;
+    SkIPoint margin;
+    const bool blurred = SkBlurMask::BlurRect(sigma, &expected, large, kNormal_SkBlurStyle,
+                                              &margin,
+                                              SkMask::kComputeBoundsAndRenderImage_CreateMode);
+    REPORTER_ASSERT(reporter, blurred);
+    SkAutoMaskFreeImage expectedStorage(expected.fImage);
+    int worst = 0;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            const int want = expected.fBounds.contains(x, y) ? *expected.getAddr8(x, y) : 0;
+            worst = std::max(worst, std::abs(want - (int)SkColorGetA(bm.getColor(x, y))));
+        }
+    }
+    REPORTER_ASSERT(reporter, worst == 0, "worst difference %d", worst);
+}
+
 // https://crbugs.com/787712
 DEF_TEST(EmbossPerlinCrash, reporter) {
     SkPaint p;
@@ -539,6 +606,44 @@ DEF_TEST(BlurZeroSigma, reporter) {
     }
 }
 
+// SkOpts::mask_blur_rows must produce exactly what the one-row-at-a-time scan does, including
+// when the row count is not a multiple of the lane count, and when the mask is narrower than
+// the blur.
+DEF_TEST(BlurMaskRowsMatchScan, reporter) {
+    const SkIRect bounds[] = {
+        {0, 0, 3, 2}, {0, 0, 37, 53}, {5, 7, 205, 124}, {0, 0, 16, 16},
+    };
+    const SkScalar sigmas[] = { 2.5f, 10, 40 };
+
+    for (const SkIRect& b : bounds) {
+        SkMask src;
+        src.fBounds   = b;
+        src.fFormat   = SkMask::kA8_Format;
+        src.fRowBytes = b.width() + 3;
+        src.fImage    = SkMask::AllocImage(src.computeImageSize());
+        SkAutoMaskFreeImage srcStorage(src.fImage);
+        for (size_t i = 0; i < src.computeImageSize(); i++) {
+            src.fImage[i] = (i * 37 + (i >> 5)) % 3 ? (i * 101) & 0xff : 0;
+        }
+
+        for (SkScalar sigma : sigmas) {
+            SkMaskBlurFilter filter(sigma, sigma);
+            SkMask masks[2];
+            for (bool useBlurRows : {false, true}) {
+                filter.blurForTesting(src, &masks[useBlurRows], useBlurRows);
+                REPORTER_ASSERT(reporter, masks[useBlurRows].fImage);
+            }
+            SkAutoMaskFreeImage scanStorage(masks[0].fImage),
+                                rowsStorage(masks[1].fImage);
+
+            REPORTER_ASSERT(reporter, masks[0].fBounds == masks[1].fBounds);
+            REPORTER_ASSERT(reporter, masks[0].computeImageSize() ==
+                                      masks[1].computeImageSize());
+            REPORTER_ASSERT(reporter, 0 == memcmp(masks[0].fImage, masks[1].fImage,
+                                                  masks[0].computeImageSize()));
+        }
+    }
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 
@@ -38,6 +38,8 @@
 #include "include/utils/SkNWayCanvas.h"
 #include "include/utils/SkPaintFilterCanvas.h"
 #include "src/core/SkBigPicture.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkSpecialImage.h"
@@ -797,3 +799,99 @@ DEF_TEST(canvas_savelayer_destructor, reporter) {
     do_test(2, 0);
     check_pixels(SK_ColorRED);
 }
+
+namespace {
+
+// Passes its input through, counting how many times it was asked to filter.
+class CountingImageFilter : public SkImageFilter_Base {
+public:
+    static sk_sp<SkImageFilter> Make(sk_sp<SkImageFilter> input, int* count) {
+        return sk_sp<SkImageFilter>(new CountingImageFilter(std::move(input), count));
+    }
+
+protected:
+    sk_sp<SkSpecialImage> onFilterImage(const Context& ctx, SkIPoint* offset) const override {
+        ++*fCount;
+        return this->filterInput(0, ctx, offset);
+    }
+
+private:
+    SK_FLATTENABLE_HOOKS(CountingImageFilter)
+
+    CountingImageFilter(sk_sp<SkImageFilter> input, int* count)
+            : INHERITED(&input, 1, nullptr)
+            , fCount(count) {}
+
+    int* fCount;
+
+    using INHERITED = SkImageFilter_Base;
+};
+
+sk_sp<SkFlattenable> CountingImageFilter::CreateProc(SkReadBuffer& buffer) {
+    SkDEBUGFAIL("Should never get here");
+    return nullptr;
+}
+
+}  // anonymous namespace
+
+DEF_TEST(Canvas_CacheBackdrop, r) {
+    int filterCount = 0;
+    sk_sp<SkImageFilter> backdrop = CountingImageFilter::Make(
+            SkImageFilters::Blur(4, 4, nullptr), &filterCount);
+
+    // A frame is a background, a blurred backdrop behind a translucent panel, and the panel's
+    // content, which moves from frame to frame. The corner lies outside what the backdrop reads.
+    auto drawFrame = [&](SkCanvas* canvas, SkColor background, SkColor corner, int frame,
+                         bool cache) {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(background);
+        canvas->drawCircle(40, 40, 25, paint);
+        paint.setColor(corner);
+        canvas->drawRect(SkRect::MakeXYWH(0, 90, 10, 10), paint);
+
+        const SkRect panel = SkRect::MakeXYWH(20, 20, 60, 50);
+        canvas->save();
+        canvas->clipRect(panel);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(
+                &panel, nullptr, backdrop.get(),
+                cache ? SkCanvas::kCacheBackdrop_SaveLayerFlag : 0));
+        paint.setColor(0x800000FF);
+        canvas->drawRect(SkRect::MakeXYWH(25 + frame, 30, 10, 10), paint);
+        canvas->restore();
+        canvas->restore();
+    };
+
+    // Nothing but the backdrop cache should carry filter results from one frame to the next, so
+    // each frame's filters run against a fresh image filter cache rather than the global one.
+    auto makeFilterCache = []() {
+        return sk_sp<SkImageFilterCache>(SkImageFilterCache::Create(1 << 20));
+    };
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    SkBitmap got;
+    got.allocPixels(info);
+    auto cachedDevice = sk_make_sp<SkBitmapDevice>(got);
+    SkCanvas cached(cachedDevice);
+    const SkColor backgrounds[] = {SK_ColorRED, SK_ColorRED, SK_ColorRED, SK_ColorGREEN};
+    const SkColor corners[]     = {SK_ColorWHITE, SK_ColorWHITE, SK_ColorBLACK, SK_ColorBLACK};
+    const int expectedCounts[]  = {1, 1, 1, 2};
+    for (int frame = 0; frame < (int)SK_ARRAY_COUNT(backgrounds); ++frame) {
+        cachedDevice->setImageFilterCacheForTesting(makeFilterCache());
+        drawFrame(&cached, backgrounds[frame], corners[frame], frame, true);
+        REPORTER_ASSERT(r, filterCount == expectedCounts[frame],
+                        "frame %d: %d", frame, filterCount);
+
+        const int before = filterCount;
+        SkBitmap want;
+        want.allocPixels(info);
+        auto expectedDevice = sk_make_sp<SkBitmapDevice>(want);
+        expectedDevice->setImageFilterCacheForTesting(makeFilterCache());
+        SkCanvas expected(expectedDevice);
+        drawFrame(&expected, backgrounds[frame], corners[frame], frame, false);
+        filterCount = before;
+
+        REPORTER_ASSERT(r, 0 == memcmp(want.getPixels(), got.getPixels(),
+                                       info.computeMinByteSize()), "frame %d", frame);
+    }
+}
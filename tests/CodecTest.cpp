@@ -1882,3 +1882,49 @@ DEF_TEST(Codec_noConversion, r) {
         REPORTER_ASSERT(r, bm.getColor(0, 0) == rec.color);
     }
 }
+
+// Gray rows are color transformed by table lookup; that must match running them through skcms.
+DEF_TEST(Codec_grayColorXform, r) {
+    auto data = GetResourceAsData("images/grayscale.png");
+    if (!data) {
+        return;
+    }
+    auto codec = SkCodec::MakeFromData(data);
+    REPORTER_ASSERT(r, codec && codec->getInfo().colorType() == kGray_8_SkColorType);
+
+    SkBitmap gray;
+    gray.allocPixels(codec->getInfo().makeColorSpace(nullptr));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(gray.pixmap()));
+
+    const skcms_ICCProfile* srcProfile = codec->getICCProfile() ? codec->getICCProfile()
+                                                                : skcms_sRGB_profile();
+    skcms_ICCProfile dstProfile;
+    SkColorSpace::MakeRGB(SkNamedTransferFn::kRec2020, SkNamedGamut::kDisplayP3)
+            ->toProfile(&dstProfile);
+    const struct {
+        SkColorType       ct;
+        skcms_PixelFormat format;
+    } dsts[] = {
+        {kRGBA_8888_SkColorType, skcms_PixelFormat_RGBA_8888},
+        {kRGB_565_SkColorType,   skcms_PixelFormat_BGR_565},
+        {kRGBA_F16_SkColorType,  skcms_PixelFormat_RGBA_hhhh},
+    };
+    for (auto [ct, dstFormat] : dsts) {
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo().makeColorType(ct)
+                                        .makeColorSpace(SkColorSpace::Make(dstProfile)));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.pixmap()));
+
+        SkBitmap expected;
+        expected.allocPixels(bm.info());
+        for (int y = 0; y < gray.height(); y++) {
+            REPORTER_ASSERT(r, skcms_Transform(gray.getAddr8(0, y), skcms_PixelFormat_G_8,
+                                               skcms_AlphaFormat_Unpremul, srcProfile,
+                                               expected.getAddr(0, y), dstFormat,
+                                               skcms_AlphaFormat_Unpremul, &dstProfile,
+                                               gray.width()));
+            REPORTER_ASSERT(r, !memcmp(bm.getAddr(0, y), expected.getAddr(0, y),
+                                       bm.info().minRowBytes()), "color type %d, row %d", ct, y);
+        }
+    }
+}
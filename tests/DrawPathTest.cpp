@@ -8,11 +8,14 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathEffect.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
@@ -22,6 +25,17 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkCoreBlitters.h"
+#include "src/core/SkDraw.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkMaskCache.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkScan.h"
 #include "tests/Test.h"
 
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
@@ -371,3 +385,288 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+// SkRasterPipelineBlitter::blitAntiH() may draw a scanline's runs one at a time, or gathered into
+// spans of coverage.  Either way we should get exactly the same pixels.
+DEF_TEST(DrawPath_CoalescedAntiH, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(200, 100);
+
+    SkPath path;
+    for (int i = 0; i < 12; i++) {
+        path.moveTo(5 + 15*i, 5);
+        path.cubicTo(40 + 13*i, 90, 3*i, 20, 195 - 7*i, 95);
+    }
+
+    auto draw = [&](bool coalesce, const SkPaint& paint, const SkPath& fill) {
+        SkBitmap bm;
+        bm.allocPixels(info);
+        bm.eraseColor(0xff336699);
+
+        SkSTArenaAlloc<2048> alloc;
+        SkSimpleMatrixProvider matrixProvider(SkMatrix::I());
+        SkBlitter* blitter = SkCreateRasterPipelineBlitterForTesting(bm.pixmap(), paint,
+                                                                     matrixProvider, &alloc,
+                                                                     coalesce);
+        SkScan::AntiFillPath(fill, SkRasterClip(info.bounds()), blitter);
+        return bm;
+    };
+
+    for (SkColor color : {SK_ColorRED, 0x80208040}) {
+        for (float width : {0.5f, 3.0f, 40.0f}) {
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(width);
+            paint.setColor(color);
+
+            SkPath fill;
+            paint.getFillPath(path, &fill);
+            paint.setStyle(SkPaint::kFill_Style);
+
+            SkBitmap runs      = draw(false, paint, fill),
+                     coalesced = draw( true, paint, fill);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(runs.getPixels(), coalesced.getPixels(),
+                                        runs.computeByteSize()),
+                            "color %08x, width %g", color, width);
+        }
+    }
+}
+
+// Writes the coverage it's given straight into an A8 bitmap.
+class CoverageBlitter final : public SkBlitter {
+public:
+    explicit CoverageBlitter(const SkBitmap& bm) : fPixmap(bm.pixmap()) {}
+
+    void blitH(int x, int y, int width) override {
+        memset(fPixmap.writable_addr8(x, y), 0xff, width);
+    }
+    void blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) override {
+        for (int n; (n = *runs) > 0; runs += n, aa += n, x += n) {
+            memset(fPixmap.writable_addr8(x, y), *aa, n);
+        }
+    }
+
+private:
+    SkPixmap fPixmap;
+};
+
+// Coverage accumulation should agree with very finely supersampled coverage, including where the
+// path runs off the edges of the mask.  It can overestimate coverage where edges cross, so we
+// use nested contours that don't.
+DEF_TEST(DrawPath_CoverageAccumulation, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeA8(120, 100);
+
+    // A star reaching past every edge of the mask, with a circle and a cubic inside it.
+    SkPath path;
+    for (int i = 0; i < 18; i++) {
+        const float r = i % 2 ? 45 : 75,
+                    t = i * SK_ScalarPI/9 + 0.1f;
+        const SkPoint p = {55 + r*cosf(t), 50 + r*sinf(t)};
+        i ? path.lineTo(p) : path.moveTo(p);
+    }
+    path.close();
+    path.addCircle(35.3f, 45.7f, 15.1f);
+    path.moveTo(70.2f, 40.4f);
+    path.cubicTo(95, 30.5f, 95.5f, 70, 70.6f, 60.8f);
+    path.close();
+
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        path.setFillType(fillType);
+
+        SkBitmap accumulated;
+        accumulated.allocPixels(info);
+        accumulated.eraseColor(SK_ColorTRANSPARENT);
+        CoverageBlitter blitter(accumulated);
+        SkScan::AccumulateFillPath(path, &blitter, path.getBounds().roundOut(), info.bounds());
+
+        // Sample each pixel 32x32 times, without anti-aliasing.
+        constexpr int kScale = 32;
+        SkBitmap samples;
+        samples.allocPixels(SkImageInfo::MakeA8(info.width() * kScale, info.height() * kScale));
+        samples.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(samples);
+            canvas.scale(kScale, kScale);
+            canvas.drawPath(path, SkPaint());
+        }
+
+        int worst = 0;
+        for (int y = 0; y < info.height(); y++) {
+            for (int x = 0; x < info.width(); x++) {
+                int covered = 0;
+                for (int sy = 0; sy < kScale; sy++) {
+                    for (int sx = 0; sx < kScale; sx++) {
+                        covered += *samples.getAddr8(x*kScale + sx, y*kScale + sy) ? 1 : 0;
+                    }
+                }
+                const int expected = (covered * 255 + kScale*kScale/2) / (kScale*kScale);
+                worst = std::max(worst, std::abs(expected - *accumulated.getAddr8(x,y)));
+            }
+        }
+        REPORTER_ASSERT(reporter, worst <= 4, "fill type %d, worst difference %d",
+                        (int)fillType, worst);
+    }
+}
+
+// Filling a huge path in parallel should draw exactly what filling it serially does.
+DEF_TEST(DrawPath_ParallelFill, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeA8(300, 200);
+
+    SkPath path;
+    const int kPoints = 1 << 15;
+    for (int i = 0; i < kPoints; i++) {
+        float t = i * (2 * SK_ScalarPI / kPoints),
+              r = 120 + 40 * sinf(53 * t) + 10 * sinf(997 * t);
+        path.lineTo(150 + r * cosf(t), 100 + r * sinf(t));
+    }
+    path.close();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    auto draw = [&](int threads) {
+        SkBitmap bm;
+        bm.allocPixels(info);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        CoverageBlitter blitter(bm);
+        SkScan::AccumulateFillPath(path, &blitter, path.getBounds().roundOut(), info.bounds(),
+                                   threads > 1 ? executor.get() : nullptr, threads);
+        return bm;
+    };
+
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        path.setFillType(fillType);
+        SkBitmap serial = draw(1);
+        for (int threads : {2, 3, 4}) {
+            SkBitmap parallel = draw(threads);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                        serial.computeByteSize()),
+                            "fill type %d, %d threads", (int)fillType, threads);
+        }
+    }
+}
+
+// Installing a parallel fill executor must not change the pixels of any fill, even of huge paths
+// that cross themselves, where accumulating coverage would differ from AAA or SAA.
+DEF_TEST(DrawPath_ParallelFillExecutor, reporter) {
+    // Two loops of a wobbly circle, crossing each other.
+    SkPath path;
+    const int kPoints = (1 << 14) + 123;
+    for (int i = 0; i < kPoints; i++) {
+        float t = i * (4 * SK_ScalarPI / kPoints),
+              r = 70 + 25 * sinf(1.5f * t) + 3 * sinf(301 * t);
+        path.lineTo(150 + r * cosf(t), 100 + r * sinf(t));
+    }
+    path.close();
+
+    auto draw = [&] {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeA8(300, 200));
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkCanvas(bm).drawPath(path, paint);
+        return bm;
+    };
+
+    // Static, as other threads may still be using it just after we uninstall it.
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd}) {
+        path.setFillType(fillType);
+        SkBitmap serial = draw();
+
+        SkExecutor* prev = SkGraphics::SetParallelPathFillExecutor(executor.get(), 4);
+        SkBitmap parallel = draw();
+        SkGraphics::SetParallelPathFillExecutor(prev, 1);
+
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                    serial.computeByteSize()),
+                        "fill type %d", (int)fillType);
+    }
+}
+
+// Drawing a path through its cached coverage mask should look like drawing it directly, as long
+// as its translation is already on a quarter pixel, and later draws should blit the cached mask.
+// (The path stays inside the device; clipped paths can rasterize slightly differently.)
+DEF_TEST(DrawPath_CachedCoverageMask, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(80, 5, 10, 80, 70, 60);
+    path.quadTo(20, 85, 10, 10);
+
+    auto white_bitmap = [&] {
+        SkBitmap bm;
+        bm.allocPixels(info);
+        bm.eraseColor(SK_ColorWHITE);
+        return bm;
+    };
+
+    auto max_diff = [](const SkBitmap& a, const SkBitmap& b) {
+        int worst = 0;
+        for (int y = 0; y < a.height(); y++) {
+            for (int x = 0; x < a.width(); x++) {
+                SkColor ca = a.getColor(x, y),
+                        cb = b.getColor(x, y);
+                for (int shift : {0, 8, 16, 24}) {
+                    worst = std::max(worst, std::abs((int)((ca >> shift) & 0xff) -
+                                                     (int)((cb >> shift) & 0xff)));
+                }
+            }
+        }
+        return worst;
+    };
+
+    for (SkPaint::Style style : {SkPaint::kFill_Style, SkPaint::kStroke_Style}) {
+        for (SkPoint d : {SkPoint{0, 0}, SkPoint{5.25f, 3.5f}, SkPoint{-2.75f, 8}}) {
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(0xff204080);
+            paint.setStyle(style);
+            paint.setStrokeWidth(3);
+            const SkMatrix ctm = SkMatrix::Translate(d.fX, d.fY);
+
+            SkBitmap direct = white_bitmap();
+            {
+                SkCanvas canvas(direct);
+                canvas.concat(ctm);
+                canvas.drawPath(path, paint);
+            }
+
+            SkResourceCache cache(1 << 20);
+            auto draw_cached = [&](const SkBitmap& bm) {
+                SkRasterClip clip(info.bounds());
+                SkSimpleMatrixProvider matrixProvider(ctm);
+                SkDraw draw;
+                draw.fDst            = bm.pixmap();
+                draw.fRC             = &clip;
+                draw.fMatrixProvider = &matrixProvider;
+                return draw.drawCachedPathMask(path, paint, ctm, &cache);
+            };
+
+            SkBitmap first = white_bitmap();
+            REPORTER_ASSERT(reporter, draw_cached(first));
+            REPORTER_ASSERT(reporter, max_diff(direct, first) <= 2,
+                            "style %d, translate (%g,%g): %d", (int)style, d.fX, d.fY,
+                            max_diff(direct, first));
+
+            // The mask is keyed on just the subpixel part of the translation.
+            SkMask mask;
+            const SkMatrix subpixel = SkMatrix::Translate(d.fX - floorf(d.fX),
+                                                          d.fY - floorf(d.fY));
+            sk_sp<SkCachedData> data(SkMaskCache::FindAndRef(path, subpixel, paint, &mask,
+                                                             &cache));
+            REPORTER_ASSERT(reporter, data);
+            if (!data) {
+                continue;
+            }
+
+            // Clear the cached mask.  Drawing again should blit it, drawing nothing.
+            sk_bzero(mask.fImage, mask.computeImageSize());
+            SkBitmap second = white_bitmap();
+            REPORTER_ASSERT(reporter, draw_cached(second));
+            REPORTER_ASSERT(reporter, 0 == max_diff(second, white_bitmap()));
+        }
+    }
+}
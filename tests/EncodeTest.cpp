@@ -13,8 +13,10 @@
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkImageGenerator.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
@@ -218,6 +220,44 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+// Encoding decoded YUV planes directly should round trip about as well as
+// encoding the equivalent RGB pixels.
+DEF_TEST(Encode_JpegYUVA, r) {
+    sk_sp<SkData> encoded = GetResourceAsData("images/mandrill_512_q075.jpg");
+    if (!encoded) {
+        return;
+    }
+    std::unique_ptr<SkImageGenerator> generator = SkImageGenerator::MakeFromEncoded(encoded);
+    SkYUVAPixmapInfo::SupportedDataTypes supportedDataTypes;
+    supportedDataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+    SkYUVAPixmapInfo yuvaPixmapInfo;
+    if (!generator || !generator->queryYUVAInfo(supportedDataTypes, &yuvaPixmapInfo)) {
+        return;
+    }
+    SkYUVAPixmaps yuvaPixmaps = SkYUVAPixmaps::Allocate(yuvaPixmapInfo);
+    REPORTER_ASSERT(r, generator->getYUVAPlanes(yuvaPixmaps));
+
+    SkDynamicMemoryWStream dst;
+    SkJpegEncoder::Options options;
+    options.fQuality = 90;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&dst, yuvaPixmaps, nullptr, options));
+
+    SkBitmap original, roundTrip;
+    REPORTER_ASSERT(r, SkImage::MakeFromEncoded(encoded)->asLegacyBitmap(&original));
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(dst.detachAsData());
+    REPORTER_ASSERT(r, image && image->asLegacyBitmap(&roundTrip));
+    REPORTER_ASSERT(r, almost_equals(original, roundTrip, 60));
+
+    // YUVA pixmaps that are not JPEG-compatible are rejected.
+    SkYUVAInfo rgbInfo(yuvaPixmapInfo.yuvaInfo().dimensions(),
+                       SkYUVAInfo::PlaneConfig::kY_U_V,
+                       SkYUVAInfo::Subsampling::k444,
+                       kRec709_Limited_SkYUVColorSpace);
+    SkYUVAPixmaps limited = SkYUVAPixmaps::Allocate(
+            SkYUVAPixmapInfo(rgbInfo, SkYUVAPixmapInfo::DataType::kUnorm8, nullptr));
+    REPORTER_ASSERT(r, !SkJpegEncoder::Encode(&dst, limited, nullptr, options));
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
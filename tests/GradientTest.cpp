@@ -570,6 +570,56 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// kUseColorLookupTable_Flag trades a little precision for speed; it should stay close to the
+// gradient it approximates in every tile mode, with and without explicit positions.
+static void test_color_lut(skiatest::Reporter* reporter) {
+    constexpr int kStops = 12;
+    SkColor colors[kStops];
+    SkScalar pos[kStops];
+    for (int i = 0; i < kStops; i++) {
+        const SkColor choices[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE, SK_ColorWHITE,
+                                    0x40000000 };
+        colors[i] = choices[i % SK_ARRAY_COUNT(choices)];
+        // Uneven, but with no stops so close together that the table can't follow them.
+        pos[i] = i == 0 || i == kStops - 1 ? i / (kStops - 1.0f)
+                                           : (i + (i % 2 ? 0.3f : -0.3f)) / (kStops - 1);
+    }
+    const SkPoint pts[] = { {20, 0}, {220, 0} };
+
+    auto draw = [&](const SkScalar* pos, SkTileMode mode, uint32_t flags) {
+        SkBitmap bm;
+        bm.allocN32Pixels(256, 1);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, pos, kStops, mode, flags,
+                                                     nullptr));
+        SkCanvas(bm).drawPaint(paint);
+        return bm;
+    };
+
+    for (const SkScalar* p : {(const SkScalar*)nullptr, (const SkScalar*)pos}) {
+        for (SkTileMode mode : {SkTileMode::kClamp, SkTileMode::kRepeat, SkTileMode::kMirror}) {
+            for (uint32_t flags : {0, +SkGradientShader::kInterpolateColorsInPremul_Flag}) {
+                SkBitmap exact = draw(p, mode, flags),
+                         lut   = draw(p, mode, flags |
+                                               SkGradientShader::kUseColorLookupTable_Flag);
+                int worst = 0;
+                for (int x = 0; x < exact.width(); x++) {
+                    SkPMColor a = *exact.getAddr32(x, 0),
+                              b = *lut.getAddr32(x, 0);
+                    for (int shift : {0, 8, 16, 24}) {
+                        worst = std::max(worst, std::abs((int)((a >> shift) & 0xff) -
+                                                         (int)((b >> shift) & 0xff)));
+                    }
+                }
+                REPORTER_ASSERT(reporter, worst <= 3,
+                                "pos %d, tile mode %d, flags %u: worst difference %d",
+                                p != nullptr, (int)mode, flags, worst);
+            }
+        }
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -584,4 +634,5 @@ DEF_TEST(Gradient, reporter) {
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
     test_unsorted_degenerate(reporter);
+    test_color_lut(reporter);
 }
@@ -18,12 +18,14 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/effects/SkTableColorFilter.h"
+#include "include/utils/SkRandom.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/effects/imagefilters/SkImageFiltersPriv.h"
 #include "src/gpu/GrCaps.h"
 #include "src/gpu/GrRecordingContextPriv.h"
 #include "tests/Test.h"
@@ -32,6 +34,25 @@
 
 static const int kBitmapSize = 4;
 
+// Returns the largest difference between any channel of corresponding premultiplied N32 pixels
+// in a and b.
+static int max_channel_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkASSERT(a.dimensions() == b.dimensions());
+    SkASSERT(a.colorType() == kN32_SkColorType && b.colorType() == kN32_SkColorType);
+    int worst = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            SkPMColor pa = *a.getAddr32(x, y),
+                      pb = *b.getAddr32(x, y);
+            for (int shift : {0, 8, 16, 24}) {
+                worst = std::max(worst, std::abs((int)((pa >> shift) & 0xff) -
+                                                 (int)((pb >> shift) & 0xff)));
+            }
+        }
+    }
+    return worst;
+}
+
 namespace {
 
 class MatrixTestImageFilter : public SkImageFilter_Base {
@@ -680,6 +701,92 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(MorphologyFilterRadiusWithMirrorCTM_Gpu, repo
     test_morphology_radius_with_mirror_ctm(reporter, ctxInfo.directContext());
 }
 
+DEF_TEST(MorphologyFilterMatchesNaive, reporter) {
+    // Compare the raster dilate and erode against the per-pixel extreme over each rectangle,
+    // including radii wider than the image.  Pixels outside the image are transparent, and the
+    // rectangles are clipped to the result.
+    static const int kWidth = 37, kHeight = 23;
+
+    SkRandom rand;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, kHeight);
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            U8CPU a = rand.nextULessThan(256);
+            *bitmap.getAddr32(x, y) = SkPackARGB32(a, rand.nextULessThan(a + 1),
+                                                      rand.nextULessThan(a + 1),
+                                                      rand.nextULessThan(a + 1));
+        }
+    }
+    sk_sp<SkSpecialImage> imgSrc(
+            SkSpecialImage::MakeFromImage(nullptr, SkIRect::MakeWH(kWidth, kHeight),
+                                          bitmap.asImage(), SkSurfaceProps()));
+
+    auto pixel = [&](int x, int y) -> SkPMColor {
+        if (x < 0 || y < 0 || x >= kWidth || y >= kHeight) {
+            return 0;
+        }
+        return *bitmap.getAddr32(x, y);
+    };
+
+    const SkISize kRadii[] = {{1, 0}, {0, 3}, {4, 2}, {40, 7}, {9, 30}, {150, 2}, {5, 256}};
+    for (bool dilate : {true, false}) {
+        for (SkISize radius : kRadii) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radius.width(), radius.height(), nullptr)
+                           : SkImageFilters::Erode (radius.width(), radius.height(), nullptr);
+            SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeXYWH(-50, -50, 150, 150),
+                                            nullptr, kN32_SkColorType, nullptr, imgSrc.get());
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result(as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset));
+            REPORTER_ASSERT(reporter, result);
+            SkBitmap resultBM;
+            if (!result || !special_image_to_bitmap(nullptr, result.get(), &resultBM)) {
+                ERRORF(reporter, "no result for radius %d,%d", radius.width(), radius.height());
+                continue;
+            }
+
+            const SkIRect r = SkIRect::MakeXYWH(offset.fX, offset.fY,
+                                                resultBM.width(), resultBM.height());
+            int mismatches = 0;
+            for (int y = r.top(); y < r.bottom(); y++) {
+                for (int x = r.left(); x < r.right(); x++) {
+                    uint8_t want[4];
+                    for (int c = 0; c < 4; c++) {
+                        want[c] = dilate ? 0x00 : 0xff;
+                    }
+                    for (int v = std::max(r.top(), y - radius.height());
+                         v <= std::min(r.bottom() - 1, y + radius.height()); v++) {
+                        for (int u = std::max(r.left(), x - radius.width());
+                             u <= std::min(r.right() - 1, x + radius.width()); u++) {
+                            SkPMColor px = pixel(u, v);
+                            for (int c = 0; c < 4; c++) {
+                                uint8_t b = (px >> (8 * c)) & 0xff;
+                                want[c] = dilate ? std::max(want[c], b) : std::min(want[c], b);
+                            }
+                        }
+                    }
+                    SkPMColor got = *resultBM.getAddr32(x - r.left(), y - r.top());
+                    if (got != (want[0] | want[1] <<  8 |
+                                want[2] << 16 | (SkPMColor)want[3] << 24)) {
+                        mismatches++;
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "%s radius %d,%d: %d mismatches",
+                            dilate ? "dilate" : "erode", radius.width(), radius.height(),
+                            mismatches);
+        }
+    }
+
+    // Radii past the limit of 256 produce no result.
+    sk_sp<SkImageFilter> filter = SkImageFilters::Dilate(257, 1, nullptr);
+    SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr,
+                                    kN32_SkColorType, nullptr, imgSrc.get());
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, !as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset));
+}
+
 static void test_zero_blur_sigma(skiatest::Reporter* reporter, GrDirectContext* dContext) {
     // Check that SkBlurImageFilter with a zero sigma and a non-zero srcOffset works correctly.
     SkIRect cropRect = SkIRect::MakeXYWH(5, 0, 5, 10);
@@ -1150,6 +1257,101 @@ DEF_TEST(ImageFilterMatrixConvolutionBorder, reporter) {
     canvas.restore();
 }
 
+// Clamp and decal interiors skip the per-tap bounds checks, and apply rank one kernels as two 1D
+// passes; they should match the general path exactly, and to within rounding when separated.
+DEF_TEST(ImageFilterMatrixConvolutionFastInterior, reporter) {
+    // A transparent margin, as the filter pads its input with, puts borders around the interior.
+    SkRandom rand;
+    SkBitmap src;
+    src.allocN32Pixels(80, 60);
+    src.eraseColor(SK_ColorTRANSPARENT);
+    for (int y = 5; y < src.height() - 5; y++) {
+        for (int x = 5; x < src.width() - 5; x++) {
+            U8CPU a = rand.nextULessThan(256);
+            *src.getAddr32(x, y) = SkPackARGB32(a, rand.nextULessThan(a + 1),
+                                                   rand.nextULessThan(a + 1),
+                                                   rand.nextULessThan(a + 1));
+        }
+    }
+
+    const SkScalar column[5] = {1, 2, 4, 2, 1},
+                   row[5]    = {-1, 0.5f, 2, 0.5f, -1};
+    SkScalar separable[25], general[25];
+    for (int i = 0; i < 25; i++) {
+        separable[i] = general[i] = column[i / 5] * row[i % 5];
+    }
+    general[7] += 3;
+
+    for (const SkScalar* kernel : {general, separable}) {
+        for (SkTileMode tileMode : {SkTileMode::kClamp, SkTileMode::kDecal}) {
+            for (bool convolveAlpha : {true, false}) {
+                sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                        SkISize::Make(5, 5), kernel, 0.05f, 10, SkIPoint::Make(2, 1), tileMode,
+                        convolveAlpha, nullptr);
+
+                SkBitmap slow, fast;
+                REPORTER_ASSERT(reporter, SkImageFiltersPriv::MatrixConvolutionForTesting(
+                        *filter, src, /*fastInterior=*/false, &slow));
+                REPORTER_ASSERT(reporter, SkImageFiltersPriv::MatrixConvolutionForTesting(
+                        *filter, src, /*fastInterior=*/true, &fast));
+                const int worst = max_channel_diff(slow, fast);
+                REPORTER_ASSERT(reporter, worst <= (kernel == separable ? 1 : 0),
+                                "%s kernel, tile mode %d, convolveAlpha %d: worst difference %d",
+                                kernel == separable ? "separable" : "general", (int)tileMode,
+                                convolveAlpha, worst);
+            }
+        }
+    }
+}
+
+// The raster lighting filters compute a row of normals and then light several pixels at once; that
+// should match lighting each pixel on its own exactly, for every light and both reflection models.
+DEF_TEST(ImageFilterLightingBatched, reporter) {
+    SkRandom rand;
+    SkBitmap src;
+    src.allocN32Pixels(37, 29);
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            U8CPU a = rand.nextULessThan(256);
+            *src.getAddr32(x, y) = SkPackARGB32(a, a, a, a);
+        }
+    }
+
+    const SkPoint3 location  = SkPoint3::Make(-5, 10, 20),
+                   target    = SkPoint3::Make(30, 20, 0),
+                   direction = SkPoint3::Make(0.6f, -0.3f, 0.74f);
+    const SkColor color = SkColorSetRGB(0xFF, 0xC0, 0x40);
+    sk_sp<SkImageFilter> filters[] = {
+        SkImageFilters::DistantLitDiffuse(direction, color, 3, 0.8f, nullptr),
+        SkImageFilters::PointLitDiffuse(location, color, -2, 1.2f, nullptr),
+        SkImageFilters::SpotLitDiffuse(location, target, 1.5f, 25, color, 4, 1, nullptr),
+        SkImageFilters::DistantLitSpecular(direction, color, 3, 0.8f, 16, nullptr),
+        SkImageFilters::PointLitSpecular(location, color, -2, 1.5f, 3.5f, nullptr),
+        SkImageFilters::SpotLitSpecular(location, target, 1.5f, 25, color, 4, 1, 20, nullptr),
+        SkImageFilters::SpotLitDiffuse(location, target, 2, 40, color, 2, 1, nullptr),
+    };
+    // Bounds inside the input read past their edges, and bounds beyond it read transparent black.
+    const SkIRect allBounds[] = {
+        src.bounds(),
+        SkIRect::MakeXYWH(4, 6, 30, 19),
+        src.bounds().makeOutset(3, 2),
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(filters); i++) {
+        for (const SkIRect& bounds : allBounds) {
+            SkBitmap perPixel, batched;
+            REPORTER_ASSERT(reporter, SkImageFiltersPriv::LightingForTesting(
+                    *filters[i], src, bounds, /*batched=*/false, &perPixel));
+            REPORTER_ASSERT(reporter, SkImageFiltersPriv::LightingForTesting(
+                    *filters[i], src, bounds, /*batched=*/true, &batched));
+            const int worst = max_channel_diff(perPixel, batched);
+            REPORTER_ASSERT(reporter, worst == 0,
+                            "filter %zu, bounds %d,%d,%d,%d: worst difference %d", i,
+                            bounds.fLeft, bounds.fTop, bounds.fRight, bounds.fBottom, worst);
+        }
+    }
+}
+
 static void test_big_kernel(skiatest::Reporter* reporter, GrRecordingContext* rContext) {
     // Check that a kernel that is too big for the GPU still works
     SkScalar identityKernel[49] = {
@@ -1673,6 +1875,33 @@ DEF_TEST(ImageFilterBlurLargeImage, reporter) {
     test_large_blur_input(reporter, surface->getCanvas());
 }
 
+// Large blurs are computed at reduced resolution on the CPU; they should stay close to the
+// full resolution result.  (Past sigma 135 the full resolution blur switches to a tent filter,
+// which is itself a few percent off a Gaussian, so we compare below that.)
+DEF_TEST(ImageFilterDownsampledBlur, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(200, 160);
+    src.eraseColor(0xff3070c0);
+
+    for (SkVector sigma : {SkVector{100, 100}, SkVector{130, 0}, SkVector{0, 120}}) {
+        // The destination is outset by 3 sigma, as SkImageFilters::Blur() does.
+        const int borderX = SkScalarCeilToInt(3 * sigma.fX),
+                  borderY = SkScalarCeilToInt(3 * sigma.fY);
+        const SkIRect srcBounds = SkIRect::MakeXYWH(borderX, borderY, src.width(), src.height()),
+                      dstBounds = SkIRect::MakeWH(src.width()  + 2 * borderX,
+                                                  src.height() + 2 * borderY);
+        SkBitmap full, down;
+        REPORTER_ASSERT(reporter, SkImageFiltersPriv::BlurForTesting(sigma, src, srcBounds,
+                                                                     dstBounds, false, &full));
+        REPORTER_ASSERT(reporter, SkImageFiltersPriv::BlurForTesting(sigma, src, srcBounds,
+                                                                     dstBounds, true, &down));
+        const int worst = max_channel_diff(full, down);
+        // Nonzero, or we didn't downsample at all.
+        REPORTER_ASSERT(reporter, 0 < worst && worst <= 6, "sigma (%g,%g), worst difference %d",
+                        sigma.fX, sigma.fY, worst);
+    }
+}
+
 static void test_make_with_filter(skiatest::Reporter* reporter, GrRecordingContext* rContext) {
     sk_sp<SkSurface> surface(create_surface(rContext, 192, 128));
     surface->getCanvas()->clear(SK_ColorRED);
@@ -70,3 +70,29 @@ DEF_TEST(LRUCacheRandom, r) {
     }
     REPORTER_ASSERT(r, 0 == instances);
 }
+
+DEF_TEST(LRUCacheSetMaxCount, r) {
+    int instances = 0;
+    {
+        SkLRUCache<int, std::unique_ptr<Value>> test(10);
+        for (int i = 0; i < 10; i++) {
+            test.insert(i, std::make_unique<Value>(i, &instances));
+        }
+        REPORTER_ASSERT(r, 10 == instances);
+
+        // Shrinking evicts the least recently used entries.
+        test.find(0);
+        test.setMaxCount(4);
+        REPORTER_ASSERT(r, 4 == test.maxCount());
+        REPORTER_ASSERT(r, 4 == instances);
+        REPORTER_ASSERT(r, test.find(0));
+        REPORTER_ASSERT(r, test.find(9));
+        REPORTER_ASSERT(r, !test.find(1));
+
+        // Growing keeps everything.
+        test.setMaxCount(8);
+        test.insert(1, std::make_unique<Value>(1, &instances));
+        REPORTER_ASSERT(r, 5 == instances);
+    }
+    REPORTER_ASSERT(r, 0 == instances);
+}
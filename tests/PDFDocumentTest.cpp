@@ -12,6 +12,7 @@
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "src/core/SkOSFile.h"
+#include "src/pdf/SkKeyedImage.h"
 #include "src/utils/SkOSPath.h"
 #include "tools/Resources.h"
 
@@ -256,3 +257,104 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+static int count_image_xobjects(const SkData& pdf) {
+    static constexpr char kImage[] = "/Subtype /Image";
+    int count = 0;
+    const char* ptr = (const char*)pdf.data();
+    const char* stop = ptr + pdf.size();
+    for (; ptr + sizeof(kImage) - 1 <= stop; ++ptr) {
+        if (0 == memcmp(ptr, kImage, sizeof(kImage) - 1)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static sk_sp<SkImage> make_dedup_test_image() {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorWHITE);
+    bm.erase(SK_ColorBLUE, SkIRect::MakeLTRB(16, 16, 48, 48));
+    return bm.asImage();
+}
+
+// Distinct SkImages with identical pixels should be emitted as a single XObject.
+DEF_TEST(SkPDF_image_content_dedup, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_content_dedup, r);
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream);
+    for (int page = 0; page < 2; ++page) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawImage(make_dedup_test_image(), 0, 0);
+        canvas->drawImage(make_dedup_test_image(), 100, 100);
+        doc->endPage();
+    }
+    doc->close();
+    REPORTER_ASSERT(r, count_image_xobjects(*stream.detachAsData()) == 1);
+}
+
+// Content keys are only hashes, so images sharing one must also compare equal before sharing
+// an XObject.
+DEF_TEST(SkPDF_image_contents_equal, r) {
+    sk_sp<SkImage> a = make_dedup_test_image(),
+                   b = make_dedup_test_image();
+    SkImageContentKey key = SkImageContentKeyFromImage(a.get());
+    REPORTER_ASSERT(r, key && key == SkImageContentKeyFromImage(b.get()));
+    REPORTER_ASSERT(r, SkImageContentsEqual(a.get(), b.get(), key));
+
+    // Pretend that an image with different pixels collided with a.
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorWHITE);
+    bm.erase(SK_ColorRED, SkIRect::MakeLTRB(16, 16, 48, 48));
+    sk_sp<SkImage> c = bm.asImage();
+    REPORTER_ASSERT(r, SkImageContentKeyFromImage(c.get()) != key);
+    REPORTER_ASSERT(r, !SkImageContentsEqual(a.get(), c.get(), key));
+    REPORTER_ASSERT(r, !SkImageContentsEqual(a.get(), b.get(), SkImageContentKey()));
+}
+
+namespace {
+struct TestImageCache : public SkPDF::ImageCache {
+    sk_sp<SkData> load(const SkData& key) override {
+        ++fLoads;
+        for (const auto& entry : fEntries) {
+            if (entry.first->equals(&key)) {
+                ++fHits;
+                return entry.second;
+            }
+        }
+        return nullptr;
+    }
+    void store(const SkData& key, const SkData& data) override {
+        fEntries.emplace_back(SkData::MakeWithCopy(key.data(), key.size()),
+                              SkData::MakeWithCopy(data.data(), data.size()));
+    }
+    std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+    int fLoads = 0;
+    int fHits = 0;
+};
+}  // namespace
+
+// A shared SkPDF::ImageCache should let a second document skip re-encoding,
+// and produce identical output.
+DEF_TEST(SkPDF_image_cache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_cache, r);
+    TestImageCache cache;
+    SkPDF::Metadata metadata;
+    metadata.fImageCache = &cache;
+    metadata.fCreation = {0, 1999, 12, 5, 31, 23, 59, 59};
+    metadata.fModified = metadata.fCreation;
+    sk_sp<SkData> pdfs[2];
+    for (sk_sp<SkData>& pdf : pdfs) {
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream, metadata);
+        doc->beginPage(612, 792)->drawImage(make_dedup_test_image(), 0, 0);
+        doc->close();
+        pdf = stream.detachAsData();
+    }
+    REPORTER_ASSERT(r, cache.fEntries.size() == 1);
+    REPORTER_ASSERT(r, cache.fLoads == 2);
+    REPORTER_ASSERT(r, cache.fHits == 1);
+    REPORTER_ASSERT(r, pdfs[0]->equals(pdfs[1].get()));
+}
@@ -74,9 +74,40 @@ DEF_TEST(SkPDF_JpegEmbedTest, r) {
     REPORTER_ASSERT(r, is_subset_of(mandrillData.get(), pdfData.get()));
     #endif
 
-    // This JPEG uses a nonstandard colorspace - it can not be
-    // embedded into the PDF directly.
-    REPORTER_ASSERT(r, !is_subset_of(cmykData.get(), pdfData.get()));
+    // This Adobe CMYK JPEG is embedded as DeviceCMYK with an inverting Decode array.
+    #ifndef SK_PDF_BASE85_BINARY
+    REPORTER_ASSERT(r, is_subset_of(cmykData.get(), pdfData.get()));
+    #endif
+    static const char kCMYK[] = "/ColorSpace /DeviceCMYK";
+    REPORTER_ASSERT(r, is_subset_of(SkData::MakeWithoutCopy(kCMYK, strlen(kCMYK)).get(),
+                                    pdfData.get()));
+}
+
+/**
+ *  Test that JPEGs with an EXIF orientation are embedded without re-encoding,
+ *  wrapped in a Form XObject that applies the orientation.
+ */
+DEF_TEST(SkPDF_JpegEmbedOrientedTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_JpegEmbedOrientedTest, r);
+    const char test[] = "SkPDF_JpegEmbedOrientedTest";
+    sk_sp<SkData> orientedData(load_resource(r, test, "images/exif-orientation-2-ur.jpg"));
+    if (!orientedData) {
+        return;
+    }
+    SkDynamicMemoryWStream pdf;
+    auto document = SkPDF::MakeDocument(&pdf);
+    SkCanvas* canvas = document->beginPage(642, 1028);
+    canvas->drawImage(SkImage::MakeFromEncoded(orientedData), 0, 0);
+    document->endPage();
+    document->close();
+    sk_sp<SkData> pdfData = pdf.detachAsData();
+
+    #ifndef SK_PDF_BASE85_BINARY
+    REPORTER_ASSERT(r, is_subset_of(orientedData.get(), pdfData.get()));
+    #endif
+    static const char kForm[] = "/Subtype /Form";
+    REPORTER_ASSERT(r, is_subset_of(SkData::MakeWithoutCopy(kForm, strlen(kForm)).get(),
+                                    pdfData.get()));
 }
 
 #ifdef SK_SUPPORT_PDF
@@ -11,7 +11,9 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -21,6 +23,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
@@ -28,10 +31,14 @@
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkMiniRecorder.h"
+#include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 
 class SkRRect;
@@ -954,3 +961,316 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+// Image procs that store raw pixels, and count how often images are decoded.
+static sk_sp<SkData> serialize_raw_image(SkImage* image, void*) {
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocN32Pixels(image->width(), image->height()) ||
+        !image->readPixels(bitmap.pixmap(), 0, 0)) {
+        return nullptr;
+    }
+    SkDynamicMemoryWStream stream;
+    stream.write32(image->width());
+    stream.write32(image->height());
+    stream.write(bitmap.getPixels(), bitmap.computeByteSize());
+    return stream.detachAsData();
+}
+
+static sk_sp<SkImage> deserialize_raw_image(const void* data, size_t size, void* decodes) {
+    static_cast<std::atomic<int>*>(decodes)->fetch_add(1);
+    int32_t wh[2];
+    if (size < sizeof(wh)) {
+        return nullptr;
+    }
+    memcpy(wh, data, sizeof(wh));
+    SkImageInfo info = SkImageInfo::MakeN32Premul(wh[0], wh[1]);
+    if (size != sizeof(wh) + info.computeMinByteSize()) {
+        return nullptr;
+    }
+    const char* pixels = static_cast<const char*>(data) + sizeof(wh);
+    return SkImage::MakeRasterCopy(SkPixmap(info, pixels, info.minRowBytes()));
+}
+
+static SkBitmap draw_100x100(const SkPicture* picture) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.drawPicture(picture);
+    return bitmap;
+}
+
+DEF_TEST(Picture_MakeFromDataWithoutCopy, r) {
+    // A nested picture with enough ops that SkCanvas won't unroll it, drawn twice.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 50));
+    for (int i = 0; i < 5; i++) {
+        SkPaint paint;
+        paint.setColor(SkColorSetRGB(50 * i, 0, 255 - 50 * i));
+        canvas->drawCircle(10 + 20 * i, 25, 8, paint);
+    }
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    SkBitmap bm;
+    make_bm(&bm, 8, 8, SK_ColorGREEN, true);
+    SkPath path;
+    path.moveTo(10, 10).lineTo(90, 20).lineTo(40, 90).close();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+
+    canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    canvas->drawPath(path, paint);
+    canvas->save();
+        canvas->clipPath(path, true);
+        canvas->drawColor(SK_ColorYELLOW);
+    canvas->restore();
+    canvas->drawImage(bm.asImage(), 80, 80);
+    canvas->drawPicture(nested);
+    canvas->translate(0, 50);
+    canvas->drawPicture(nested);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkSerialProcs sprocs;
+    sprocs.fImageProc = serialize_raw_image;
+    sk_sp<SkData> data = picture->serialize(&sprocs);
+
+    std::atomic<int> decodes{0};
+    SkDeserialProcs dprocs;
+    dprocs.fImageProc = deserialize_raw_image;
+    dprocs.fImageCtx  = &decodes;
+
+    // MakeFromData() decodes every image up front...
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(data.get(), &dprocs);
+    REPORTER_ASSERT(r, copied && decodes == 1);
+
+    // ... while a picture played back in place waits until it's drawn, and then decodes it once.
+    decodes = 0;
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromDataWithoutCopy(data, &dprocs);
+    REPORTER_ASSERT(r, mapped && !SkPicturePriv::AsSkBigPicture(mapped));
+    REPORTER_ASSERT(r, decodes == 0);
+    REPORTER_ASSERT(r, mapped->cullRect() == picture->cullRect());
+
+    // What it holds grows as the path and the image are decoded.
+    const size_t bytesBeforeDraw = mapped->approximateBytesUsed();
+
+    SkBitmap expected = draw_100x100(picture.get());
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, draw_100x100(copied.get())));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, draw_100x100(mapped.get())));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, draw_100x100(mapped.get())));
+    REPORTER_ASSERT(r, decodes == 1);
+    REPORTER_ASSERT(r, mapped->approximateBytesUsed() >=
+                       bytesBeforeDraw + bm.computeByteSize() + path.approximateBytesUsed(),
+                    "%zu -> %zu", bytesBeforeDraw, mapped->approximateBytesUsed());
+
+    // Data that isn't 4-byte aligned can't be read in place, so it's copied instead.
+    sk_sp<SkData> padded = SkData::MakeUninitialized(data->size() + 1);
+    memcpy(static_cast<char*>(padded->writable_data()) + 1, data->data(), data->size());
+    sk_sp<SkPicture> unaligned = SkPicture::MakeFromDataWithoutCopy(
+            SkData::MakeSubset(padded.get(), 1, data->size()), &dprocs);
+    REPORTER_ASSERT(r, unaligned);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, draw_100x100(unaligned.get())));
+
+    // Truncated data fails to load rather than failing later, when drawn.
+    REPORTER_ASSERT(r, !SkPicture::MakeFromDataWithoutCopy(
+            SkData::MakeSubset(data.get(), 0, data->size() / 2), &dprocs));
+
+    // A path that only fails to decode once drawn stops playback there, at the first op, rather
+    // than drawing the rest of the picture without it.
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+    uint32_t* words = static_cast<uint32_t*>(corrupt->writable_data());
+    const size_t wordCount = corrupt->size() / sizeof(uint32_t);
+    size_t pathWord = 0;
+    for (size_t i = 0; i + 1 < wordCount; i++) {
+        if (words[i] == SK_PICT_INDEXED_PATH_BUFFER_TAG) {
+            // The tag is followed by the count, count+1 offsets, and then the first path.
+            pathWord = i + 2 + words[i + 1] + 1;
+            break;
+        }
+    }
+    REPORTER_ASSERT(r, pathWord > 0 && pathWord < wordCount);
+    if (pathWord > 0 && pathWord < wordCount) {
+        words[pathWord] = ~0u;    // An unknown path version.
+        sk_sp<SkPicture> broken = SkPicture::MakeFromDataWithoutCopy(corrupt, &dprocs);
+        REPORTER_ASSERT(r, broken);
+        if (broken) {
+            SkBitmap white;
+            white.allocN32Pixels(100, 100);
+            white.eraseColor(SK_ColorWHITE);
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(white, draw_100x100(broken.get())));
+        }
+    }
+}
+
+// A 10x10 grid of 10x10 images, the bottom half of them drawn under a translate and a clip, so
+// that drawing part of the picture needs some of its save, clip and matrix ops too.
+static sk_sp<SkPicture> record_image_grid(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100), factory);
+    for (int y = 0; y < 10; y++) {
+        canvas->save();
+        if (y >= 5) {
+            canvas->translate(0, 10 * y);
+            canvas->clipRect(SkRect::MakeWH(95, 10));
+        }
+        for (int x = 0; x < 10; x++) {
+            SkBitmap bm;
+            bm.allocN32Pixels(10, 10);
+            bm.eraseColor(SkColorSetRGB(25 * x, 25 * y, 128));
+            canvas->drawImage(bm.asImage(), 10 * x, y >= 5 ? 0 : 10 * y);
+        }
+        canvas->restore();
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw_100x100_clipped(const SkPicture* picture, const SkRect& clip) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(clip);
+    canvas.drawPicture(picture);
+    return bitmap;
+}
+
+DEF_TEST(Picture_OpIndex, r) {
+    SkSerialProcs sprocs;
+    sprocs.fImageProc = serialize_raw_image;
+    sprocs.fWritePictureOpIndex = true;
+
+    std::atomic<int> decodes{0};
+    SkDeserialProcs dprocs;
+    dprocs.fImageProc = deserialize_raw_image;
+    dprocs.fImageCtx  = &decodes;
+
+    const SkRect kCells[] = {
+        SkRect::MakeXYWH(20, 20, 10, 10),   // one of the top half's cells
+        SkRect::MakeXYWH(25, 65, 10, 10),   // four of the bottom half's cells
+        SkRect::MakeXYWH(95, 90, 5, 10),    // outside the bottom half's clip
+    };
+
+    // Without a BBH there's no op index, so every image is decoded to draw any part of it, except
+    // those in the bottom half, which are skipped over once their clip turns out to be empty.
+    sk_sp<SkPicture> plain = record_image_grid(nullptr);
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromDataWithoutCopy(plain->serialize(&sprocs),
+                                                                  &dprocs);
+    REPORTER_ASSERT(r, mapped);
+    draw_100x100_clipped(mapped.get(), kCells[0]);
+    REPORTER_ASSERT(r, decodes == 50, "%d", decodes.load());
+
+    // A BBH alone doesn't write an op index; SkSerialProcs has to ask for one.
+    SkRTreeFactory factory;
+    sk_sp<SkPicture> picture = record_image_grid(&factory);
+    SkSerialProcs noIndex = sprocs;
+    noIndex.fWritePictureOpIndex = false;
+    sk_sp<SkData> unindexed = picture->serialize(&noIndex);
+    REPORTER_ASSERT(r, unindexed->size() == plain->serialize(&noIndex)->size());
+    decodes = 0;
+    mapped = SkPicture::MakeFromDataWithoutCopy(unindexed, &dprocs);
+    REPORTER_ASSERT(r, mapped);
+    draw_100x100_clipped(mapped.get(), kCells[0]);
+    REPORTER_ASSERT(r, decodes == 50, "%d", decodes.load());
+
+    // With one, only the ops that touch the clip are read, so few of the images are decoded.
+    sk_sp<SkData> data = picture->serialize(&sprocs);
+    REPORTER_ASSERT(r, data->size() > unindexed->size());
+    for (const SkRect& cell : kCells) {
+        decodes = 0;
+        mapped = SkPicture::MakeFromDataWithoutCopy(data, &dprocs);
+        REPORTER_ASSERT(r, mapped);
+        SkBitmap expected = draw_100x100_clipped(picture.get(), cell);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected,
+                                                   draw_100x100_clipped(mapped.get(), cell)));
+        REPORTER_ASSERT(r, decodes <= 9, "%d", decodes.load());
+    }
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw_100x100(picture.get()),
+                                               draw_100x100(mapped.get())));
+
+    // Deserializing a picture with an op index gives it a BBH again, so it keeps the index when
+    // it's serialized again.
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(data.get(), &dprocs);
+    REPORTER_ASSERT(r, copied && SkPicturePriv::AsSkBigPicture(copied)->bbh());
+    decodes = 0;
+    mapped = SkPicture::MakeFromDataWithoutCopy(copied->serialize(&sprocs), &dprocs);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw_100x100_clipped(picture.get(), kCells[0]),
+                                               draw_100x100_clipped(mapped.get(), kCells[0])));
+    REPORTER_ASSERT(r, decodes <= 9, "%d", decodes.load());
+
+    // An index whose ops run past the end of the op data fails to load.
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+    char* bytes = static_cast<char*>(corrupt->writable_data());
+    const uint32_t kTag = SK_PICT_OP_INDEX_TAG;
+    char* tag = std::search(bytes, bytes + corrupt->size(),
+                            reinterpret_cast<const char*>(&kTag),
+                            reinterpret_cast<const char*>(&kTag) + sizeof(kTag));
+    REPORTER_ASSERT(r, tag != bytes + corrupt->size());
+    uint32_t count;
+    memcpy(&count, tag + 4, sizeof(count));
+    const uint32_t kPastTheEnd = 0x7ffffff0;
+    memcpy(tag + 8 + count * sizeof(uint32_t), &kPastTheEnd, sizeof(kPastTheEnd));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromDataWithoutCopy(corrupt, &dprocs));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromData(corrupt.get(), &dprocs));
+}
+
+DEF_TEST(Picture_MakeFromDataInParallel, r) {
+    // Paths, paints and images enough for every thread to decode some, some in a sub-picture.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 50));
+    for (int i = 0; i < 10; i++) {
+        SkPaint paint;
+        paint.setColor(SkColorSetRGB(25 * i, 0, 255 - 25 * i));
+        canvas->drawCircle(5 + 10 * i, 25, 4, paint);
+    }
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkRandom rand;
+    for (int i = 0; i < 100; i++) {
+        SkBitmap bm;
+        bm.allocN32Pixels(5, 5);
+        bm.eraseColor(rand.nextU() | 0xff000000);
+        canvas->drawImage(bm.asImage(), 10 * (i % 10), 10 * (i / 10));
+
+        SkPath path;
+        path.moveTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        path.quadTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                    rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setColor(rand.nextU() | 0xff000000);
+        canvas->drawPath(path, paint);
+    }
+    canvas->drawPicture(nested);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkSerialProcs sprocs;
+    sprocs.fImageProc = serialize_raw_image;
+    sk_sp<SkData> data = picture->serialize(&sprocs);
+
+    std::atomic<int> decodes{0};
+    SkDeserialProcs dprocs;
+    dprocs.fImageProc = deserialize_raw_image;
+    dprocs.fImageCtx  = &decodes;
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkPicture> parallel = SkPicture::MakeFromData(data.get(), &dprocs, executor.get());
+    REPORTER_ASSERT(r, parallel && SkPicturePriv::AsSkBigPicture(parallel));
+    REPORTER_ASSERT(r, decodes == 100, "%d", decodes.load());
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw_100x100(picture.get()),
+                                               draw_100x100(parallel.get())));
+
+    // Images that fail to decode are left empty, just as they are when decoded serially.
+    dprocs.fImageProc = [](const void* data, size_t size, void* decodes) -> sk_sp<SkImage> {
+        const uint8_t* pixels = static_cast<const uint8_t*>(data) + 2 * sizeof(int32_t);
+        if (size > 2 * sizeof(int32_t) && (pixels[0] & 1)) {
+            return nullptr;
+        }
+        return deserialize_raw_image(data, size, decodes);
+    };
+    sk_sp<SkPicture> serial = SkPicture::MakeFromData(data.get(), &dprocs);
+    parallel = SkPicture::MakeFromData(data.get(), &dprocs, executor.get());
+    REPORTER_ASSERT(r, serial && parallel);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw_100x100(serial.get()),
+                                               draw_100x100(parallel.get())));
+}
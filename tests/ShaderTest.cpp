@@ -13,6 +13,8 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkPerlinNoiseShader.h"
+#include "src/core/SkResourceCache.h"
+#include "src/shaders/SkPerlinNoiseShaderPriv.h"
 #include "tests/Test.h"
 
 static void check_isaimage(skiatest::Reporter* reporter, SkShader* shader,
@@ -68,3 +70,44 @@ DEF_TEST(ComposeShaderSingle, reporter) {
     rr.setRectRadii({0, 0, 0, 0}, rd);
     canvas.drawRRect(rr, p);
 }
+
+// Shading several pixels at once, and copying from a cached stitch tile, must match shading one
+// pixel at a time exactly.
+DEF_TEST(PerlinNoiseShader_Vectorized, reporter) {
+    const SkISize tileSize = {37, 29};
+    const SkMatrix ctm = SkMatrix::Translate(3, 5);
+    const SkIRect area = SkIRect::MakeXYWH(3, 5, 77, 53);
+
+    for (const SkISize* stitch : {(const SkISize*)nullptr, &tileSize}) {
+        for (bool turbulence : {false, true}) {
+            for (int octaves : {0, 1, 4}) {
+                auto shader = turbulence
+                        ? SkPerlinNoiseShader::MakeTurbulence(0.07f, 0.11f, octaves, 3, stitch)
+                        : SkPerlinNoiseShader::MakeFractalNoise(0.07f, 0.11f, octaves, 3, stitch);
+                for (uint8_t alpha : {0xFF, 0x80}) {
+                    SkBitmap expected;
+                    REPORTER_ASSERT(reporter, SkPerlinNoiseShaderPriv::ShadeForTesting(
+                            *shader, ctm, alpha, area, /*vectorized=*/false, nullptr, &expected));
+
+                    SkResourceCache cache(1 << 20);
+                    for (int i = 0; i < 3; i++) {
+                        SkBitmap actual;
+                        REPORTER_ASSERT(reporter, SkPerlinNoiseShaderPriv::ShadeForTesting(
+                                *shader, ctm, alpha, area, /*vectorized=*/true, &cache, &actual));
+                        REPORTER_ASSERT(reporter, !memcmp(actual.getPixels(), expected.getPixels(),
+                                                          expected.computeByteSize()),
+                                        "stitch %d turbulence %d octaves %d alpha %d draw %d",
+                                        stitch != nullptr, turbulence, octaves, alpha, i);
+                        // The first draw only notes the matrix and alpha; the second shades the
+                        // stitch tile into the cache, and the third copies from it.
+                        const bool tileCached = stitch && i > 0;
+                        REPORTER_ASSERT(reporter,
+                                        (cache.getTotalBytesUsed() > 0) == tileCached,
+                                        "stitch %d draw %d: %zu bytes cached",
+                                        stitch != nullptr, i, cache.getTotalBytesUsed());
+                    }
+                }
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "include/private/SkHalf.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/gpu/GrSwizzle.h"
 #include "tests/Test.h"
@@ -467,6 +468,92 @@ DEF_TEST(SkRasterPipeline_u16, r) {
     }
 }
 
+DEF_TEST(SkRasterPipeline_tail_wide, r) {
+    // Round trip every width up to two full strides and a bit, in every pixel size we have
+    // specialized tail handling for, in both lowp and highp.  Each run must copy exactly the
+    // pixels it covers and leave the rest of the destination alone.
+    constexpr int kMaxWidth = 2*SkRasterPipeline_kMaxStride + 3;
+
+    struct Case {
+        const char*                  name;
+        SkRasterPipeline::StockStage load, middle, store;
+        size_t                       bpp;
+        void (*fill)(void* px, int i);
+    };
+    const SkRasterPipeline::StockStage kNone = SkRasterPipeline::StockStage(-1);
+    const Case cases[] = {
+        {"f32", SkRasterPipeline::load_f32, kNone, SkRasterPipeline::store_f32, 16,
+            [](void* px, int i) {
+                float rgba[] = { i+0.25f, i+0.5f, i+0.75f, i+1.0f };
+                memcpy(px, rgba, sizeof(rgba));
+            }},
+        {"rgf32", SkRasterPipeline::load_rgf32, kNone, SkRasterPipeline::store_rgf32, 8,
+            [](void* px, int i) {
+                float rg[] = { i+0.25f, -i-0.5f };
+                memcpy(px, rg, sizeof(rg));
+            }},
+        {"f16", SkRasterPipeline::load_f16, kNone, SkRasterPipeline::store_f16, 8,
+            [](void* px, int i) {
+                uint16_t rgba[] = { SkToU16(0x3c00 + i), SkToU16(0x3800 + i),
+                                    SkToU16(0xbc00 + i), SkToU16(0x4000 + i) };
+                memcpy(px, rgba, sizeof(rgba));
+            }},
+        {"16161616", SkRasterPipeline::load_16161616, kNone, SkRasterPipeline::store_16161616, 8,
+            [](void* px, int i) {
+                uint16_t rgba[] = { SkToU16(i*257), SkToU16(i*263), SkToU16(~i), SkToU16(i) };
+                memcpy(px, rgba, sizeof(rgba));
+            }},
+        {"rg1616", SkRasterPipeline::load_rg1616, kNone, SkRasterPipeline::store_rg1616, 4,
+            [](void* px, int i) {
+                uint16_t rg[] = { SkToU16(i*257), SkToU16(~i) };
+                memcpy(px, rg, sizeof(rg));
+            }},
+        {"8888", SkRasterPipeline::load_8888, kNone, SkRasterPipeline::store_8888, 4,
+            [](void* px, int i) {
+                uint32_t rgba = 0x01020304u * (uint32_t)(i+1);
+                memcpy(px, &rgba, sizeof(rgba));
+            }},
+        // unpremul has no lowp implementation, so this runs 8888 in highp.
+        {"8888 highp", SkRasterPipeline::load_8888, SkRasterPipeline::unpremul,
+            SkRasterPipeline::store_8888, 4,
+            [](void* px, int i) {
+                uint32_t rgba = 0xff000000 | (0x00030507u * (uint32_t)(i+1) & 0x00ffffff);
+                memcpy(px, &rgba, sizeof(rgba));
+            }},
+        {"a8", SkRasterPipeline::load_a8, kNone, SkRasterPipeline::store_a8, 1,
+            [](void* px, int i) { *(uint8_t*)px = SkToU8(7*i + 1); }},
+    };
+
+    for (const Case& c : cases) {
+        alignas(16) uint8_t src[16*kMaxWidth],
+                            dst[16*kMaxWidth];
+        for (int i = 0; i < kMaxWidth; i++) {
+            c.fill(src + i*c.bpp, i);
+        }
+        SkRasterPipeline_MemoryCtx srcCtx = { src, 0 },
+                                   dstCtx = { dst, 0 };
+
+        for (int w = 1; w <= kMaxWidth; w++) {
+            memset(dst, 0xab, sizeof(dst));
+            SkRasterPipeline_<256> p;
+            p.append(c.load, &srcCtx);
+            if (c.middle != kNone) {
+                p.append(c.middle);
+            }
+            p.append(c.store, &dstCtx);
+            p.run(0,0, w,1);
+
+            REPORTER_ASSERT(r, !memcmp(src, dst, w*c.bpp), "%s, width %d", c.name, w);
+            for (size_t i = w*c.bpp; i < sizeof(dst); i++) {
+                if (dst[i] != 0xab) {
+                    ERRORF(r, "%s, width %d wrote past its end at byte %zu", c.name, w, i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
 DEF_TEST(SkRasterPipeline_lowp, r) {
     uint32_t rgba[64];
     for (int i = 0; i < 64; i++) {
@@ -568,3 +655,102 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_fused, r) {
+    // Pipelines matching a fused pipeline should draw exactly the same as when run stage by stage.
+    constexpr int W = 2*SkRasterPipeline_kMaxStride + 5,
+                  H = 3;
+    const SkImageInfo info = SkImageInfo::Make(W,H, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+
+    uint8_t coverage[W*H];
+    uint32_t image[W*H];
+    for (int i = 0; i < W*H; i++) {
+        coverage[i] = (uint8_t)(i * 37);
+        image[i]    = 0xff000000 | (i * 2654435761u & 0x00ffffff);
+    }
+    SkRasterPipeline_MemoryCtx coverageCtx = { coverage, W };
+
+    SkRasterPipeline_GatherCtx gather;
+    gather.pixels = image;
+    gather.stride = W;
+    gather.width  = W;
+    gather.height = H;
+
+    SkRasterPipeline_EvenlySpaced2StopGradientCtx gradient = {
+        { 0.5f, -0.25f, 0.125f, 0.0f },
+        { 0.25f, 0.75f, 0.5f,   1.0f },
+        false,
+    };
+
+    const float scaleTranslate[] = { 0.75f, 0.5f, 1.25f, 0.5f },
+                affine[]         = { 0.01f, 0.002f, -0.1f, 0.0f, 0.0f, 0.0f };
+
+    const bool haveLowp = SkOpts::stages_lowp[SkRasterPipeline::uniform_color] != nullptr;
+
+    enum class Kind { kSrcoverColor, kSrcoverColorA8, kLinearGradient, kBilerp };
+    for (Kind kind : {Kind::kSrcoverColor, Kind::kSrcoverColorA8,
+                      Kind::kLinearGradient, Kind::kBilerp}) {
+        for (bool bgra : {false, true}) {
+            uint32_t dst[2][W*H];
+            for (int fused = 0; fused < 2; fused++) {
+                for (int i = 0; i < W*H; i++) {
+                    dst[fused][i] = 0x80402010 + i;
+                }
+                SkRasterPipeline_MemoryCtx dstCtx = { dst[fused], W };
+
+                SkSTArenaAlloc<256> alloc;
+                SkRasterPipeline p(&alloc);
+                switch (kind) {
+                    case Kind::kSrcoverColor:
+                    case Kind::kSrcoverColorA8:
+                        p.append_constant_color(&alloc, SkColor4f{0.25f, 0.5f, 0.125f, 0.5f});
+                        p.append_gamut_clamp_if_normalized(info);
+                        if (kind == Kind::kSrcoverColor) {
+                            if (bgra) {
+                                p.append(SkRasterPipeline::swap_rb);
+                            }
+                            p.append(SkRasterPipeline::srcover_rgba_8888, &dstCtx);
+                            break;
+                        }
+                        p.append(SkRasterPipeline::scale_u8, &coverageCtx);
+                        p.append_load_dst(bgra ? kBGRA_8888_SkColorType
+                                               : kRGBA_8888_SkColorType, &dstCtx);
+                        p.append(SkRasterPipeline::srcover);
+                        break;
+
+                    case Kind::kLinearGradient:
+                        p.append(SkRasterPipeline::seed_shader);
+                        p.append(SkRasterPipeline::matrix_2x3, affine);
+                        p.append(SkRasterPipeline::clamp_x_1);
+                        p.append(SkRasterPipeline::evenly_spaced_2_stop_gradient, &gradient);
+                        p.append_gamut_clamp_if_normalized(info);
+                        break;
+
+                    case Kind::kBilerp:
+                        p.append(SkRasterPipeline::seed_shader);
+                        p.append(SkRasterPipeline::matrix_scale_translate, scaleTranslate);
+                        p.append(SkRasterPipeline::bilerp_clamp_8888, &gather);
+                        if (bgra) {
+                            p.append(SkRasterPipeline::swap_rb);
+                        }
+                        p.append_gamut_clamp_if_normalized(info);
+                        break;
+                }
+                if (kind != Kind::kSrcoverColor) {
+                    p.append_store(bgra ? kBGRA_8888_SkColorType
+                                        : kRGBA_8888_SkColorType, &dstCtx);
+                }
+
+                // Only the bilerp pipelines are highp, and lowp ones exist only if lowp stages do.
+                const bool expectFused = kind == Kind::kBilerp || haveLowp;
+                REPORTER_ASSERT(r, p.isFusedForTesting() == expectFused,
+                                "kind %d, bgra %d", (int)kind, bgra);
+                p.setAllowFusedForTesting(fused);
+                REPORTER_ASSERT(r, p.isFusedForTesting() == (fused && expectFused));
+                p.run(0,0,W,H);
+            }
+            REPORTER_ASSERT(r, 0 == memcmp(dst[0], dst[1], sizeof(dst[0])),
+                            "kind %d, bgra %d", (int)kind, bgra);
+        }
+    }
+}
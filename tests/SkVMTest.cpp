@@ -5,11 +5,21 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkSurface.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkMatrixProvider.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMBlitter.h"
 #include "tests/Test.h"
 
 template <typename Fn>
@@ -1546,6 +1556,147 @@ DEF_TEST(SkVM_Assembler, r) {
         0xc4,0xe2,0x1d,0x92,0x04,0xd0,
     });
 
+    // AVX-512 instructions are EVEX encoded, with 8-bit displacements scaled by the operand size.
+    test_asm(r, [&](A& a) {
+        a.vpandd (A::zmm0, A::zmm1, A::zmm2);
+        a.vpandnd(A::zmm8, A::zmm9, A::zmm15);
+        a.vpord  (A::zmm3, A::zmm12, A::Mem{A::rsp, 64});
+        a.vpxord (A::zmm3, A::zmm12, A::Mem{A::rsi,100});
+        a.vpternlogd(A::zmm1, A::zmm2, A::zmm11, 0xca);
+
+        a.vpaddd (A::zmm1,  A::zmm2, A::Mem{A::r9, 8192, A::r10, A::FOUR});
+        a.vpsubd (A::zmm1,  A::zmm2, A::zmm3);
+        a.vpmulld(A::zmm14, A::zmm2, A::zmm3);
+
+        a.vaddps(A::zmm1, A::zmm2,  A::zmm3);
+        a.vsubps(A::zmm1, A::zmm10, A::zmm3);
+        a.vmulps(A::zmm1, A::zmm2,  A::Mem{A::rsp,128});
+        a.vdivps(A::zmm1, A::zmm2,  A::zmm3);
+        a.vminps(A::zmm1, A::zmm2,  A::zmm3);
+        a.vmaxps(A::zmm1, A::zmm2,  A::zmm3);
+        a.vsqrtps(A::zmm1, A::zmm13);
+
+        a.vfmadd132ps (A::zmm1, A::zmm2, A::zmm3);
+        a.vfmsub213ps (A::zmm1, A::zmm2, A::zmm3);
+        a.vfnmadd231ps(A::zmm1, A::zmm2, A::zmm3);
+
+        a.vpslld(A::zmm1, A::zmm12,  3);
+        a.vpsrld(A::zmm9, A::zmm2,   3);
+        a.vpsrad(A::zmm1, A::zmm2,  31);
+    },{
+        0x62,0xf1,0x75,0x48,0xdb,0xc2,
+        0x62,0x51,0x35,0x48,0xdf,0xc7,
+        0x62,0xf1,0x1d,0x48,0xeb,0x5c,0x24,0x01,
+        0x62,0xf1,0x1d,0x48,0xef,0x9e,0x64,0x00,0x00,0x00,
+        0x62,0xd3,0x6d,0x48,0x25,0xcb,0xca,
+
+        0x62,0x91,0x6d,0x48,0xfe,0x8c,0x91,0x00,0x20,0x00,0x00,
+        0x62,0xf1,0x6d,0x48,0xfa,0xcb,
+        0x62,0x72,0x6d,0x48,0x40,0xf3,
+
+        0x62,0xf1,0x6c,0x48,0x58,0xcb,
+        0x62,0xf1,0x2c,0x48,0x5c,0xcb,
+        0x62,0xf1,0x6c,0x48,0x59,0x4c,0x24,0x02,
+        0x62,0xf1,0x6c,0x48,0x5e,0xcb,
+        0x62,0xf1,0x6c,0x48,0x5d,0xcb,
+        0x62,0xf1,0x6c,0x48,0x5f,0xcb,
+        0x62,0xd1,0x7c,0x48,0x51,0xcd,
+
+        0x62,0xf2,0x6d,0x48,0x98,0xcb,
+        0x62,0xf2,0x6d,0x48,0xaa,0xcb,
+        0x62,0xf2,0x6d,0x48,0xbc,0xcb,
+
+        0x62,0xd1,0x75,0x48,0x72,0xf4,0x03,
+        0x62,0xf1,0x35,0x48,0x72,0xd2,0x03,
+        0x62,0xf1,0x75,0x48,0x72,0xe2,0x1f,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.vpcmpeqd (A::k1, A::zmm2, A::zmm3);
+        a.vpcmpgtd (A::k1, A::zmm2, A::zmm11);
+        a.vcmpltps (A::k1, A::zmm2, A::zmm3);
+        a.vcmpneqps(A::k2, A::zmm2, A::Mem{A::rsp,64});
+
+        a.vpmovm2d(A::zmm1,  A::k1);
+        a.vpmovm2d(A::zmm12, A::k3);
+        a.kxnorw  (A::k1, A::k1, A::k1);
+        a.kortestw(A::k1, A::k1);
+    },{
+        0x62,0xf1,0x6d,0x48,0x76,0xcb,
+        0x62,0xd1,0x6d,0x48,0x66,0xcb,
+        0x62,0xf1,0x6c,0x48,0xc2,0xcb,0x01,
+        0x62,0xf1,0x6c,0x48,0xc2,0x54,0x24,0x01,0x04,
+
+        0x62,0xf2,0x7e,0x48,0x38,0xc9,
+        0x62,0x72,0x7e,0x48,0x38,0xe3,
+        0xc5,0xf4,0x46,0xc9,
+        0xc5,0xf8,0x98,0xc9,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.vmovups(A::zmm1, A::Mem{A::rsp});
+        a.vmovups(A::zmm9, A::Mem{A::rsp,192});
+        a.vmovups(A::Mem{A::rdi,  64}, A::zmm9);
+        a.vmovups(A::Mem{A::rsp,8256}, A::zmm2);
+
+        a.vrndscaleps(A::zmm1, A::zmm2, A::FLOOR);
+        a.vcvtdq2ps  (A::zmm1, A::zmm2);
+        a.vcvttps2dq (A::zmm1, A::zmm2);
+        a.vcvtps2dq  (A::zmm1, A::zmm2);
+        a.vcvtps2ph  (A::ymm1, A::zmm2, A::CURRENT);
+        a.vcvtph2ps  (A::zmm1, A::ymm2);
+
+        a.vbroadcastss(A::zmm1, A::Mem{A::rsi,8});
+        a.vbroadcastss(A::zmm1, A::xmm1);
+        a.vpmovzxwd(A::zmm1, A::Mem{A::rsi});
+        a.vpmovzxwd(A::zmm1, A::ymm9);
+        a.vpmovzxbd(A::zmm1, A::Mem{A::rsi,32});
+        a.vpmovdw  (A::Mem{A::rsi}, A::zmm1);
+        a.vpmovdw  (A::ymm1, A::zmm1);
+        a.vpmovdb  (A::Mem{A::r8}, A::zmm10);
+
+        a.vpermi2d(A::zmm1, A::zmm2, A::Mem{A::rsi,64});
+        a.vextracti32x4(A::xmm1, A::zmm2, 3);
+        a.vinserti128  (A::ymm1, A::ymm2, A::xmm3, 1);
+    },{
+        0x62,0xf1,0x7c,0x48,0x10,0x0c,0x24,
+        0x62,0x71,0x7c,0x48,0x10,0x4c,0x24,0x03,
+        0x62,0x71,0x7c,0x48,0x11,0x4f,0x01,
+        0x62,0xf1,0x7c,0x48,0x11,0x94,0x24,0x40,0x20,0x00,0x00,
+
+        0x62,0xf3,0x7d,0x48,0x08,0xca,0x01,
+        0x62,0xf1,0x7c,0x48,0x5b,0xca,
+        0x62,0xf1,0x7e,0x48,0x5b,0xca,
+        0x62,0xf1,0x7d,0x48,0x5b,0xca,
+        0x62,0xf3,0x7d,0x48,0x1d,0xd1,0x04,
+        0x62,0xf2,0x7d,0x48,0x13,0xca,
+
+        0x62,0xf2,0x7d,0x48,0x18,0x4e,0x02,
+        0x62,0xf2,0x7d,0x48,0x18,0xc9,
+        0x62,0xf2,0x7d,0x48,0x33,0x0e,
+        0x62,0xd2,0x7d,0x48,0x33,0xc9,
+        0x62,0xf2,0x7d,0x48,0x31,0x4e,0x02,
+        0x62,0xf2,0x7e,0x48,0x33,0x0e,
+        0x62,0xf2,0x7e,0x48,0x33,0xc9,
+        0x62,0x52,0x7e,0x48,0x31,0x10,
+
+        0x62,0xf2,0x6d,0x48,0x76,0x4e,0x01,
+        0x62,0xf3,0x7d,0x48,0x39,0xd1,0x03,
+        0xc4,0xe3,0x6d,0x38,0xcb,0x01,
+    });
+
+    test_asm(r, [&](A& a) {
+        a.vpgatherdd(A::zmm1, A::FOUR, A::zmm2 , A::rax,  0, A::k1);
+        a.vpgatherdd(A::zmm1, A::FOUR, A::zmm4 , A::rsi, 12, A::k1);
+        a.vpgatherdd(A::zmm9, A::ONE , A::zmm12, A::r11,  0, A::k2);
+        a.vpscatterdd(A::FOUR, A::zmm3, A::rdx, 4, A::k1, A::zmm5);
+    },{
+        0x62,0xf2,0x7d,0x49,0x90,0x0c,0x90,
+        0x62,0xf2,0x7d,0x49,0x90,0x4c,0xa6,0x03,
+        0x62,0x12,0x7d,0x4a,0x90,0x0c,0x23,
+        0x62,0xf2,0x7d,0x49,0xa0,0x6c,0x9a,0x01,
+    });
+
     test_asm(r, [&](A& a) {
         a.mov(A::rax, A::Mem{A::rdi,   0});
         a.mov(A::rax, A::Mem{A::rdi,   1});
@@ -2599,3 +2750,211 @@ DEF_TEST(SkVM_fast_mul, r) {
         }
     });
 }
+
+DEF_TEST(SkVM_serialize, r) {
+    skvm::Builder b;
+    {
+        skvm::Ptr buf = b.varying<int>();
+        skvm::F32 x = b.loadF(buf);
+        b.storeF(buf, select(x > 2.0f, sqrt(x), x*x + 1.0f));
+    }
+    skvm::Program original = b.done();
+    sk_sp<SkData> data = original.serialize();
+    REPORTER_ASSERT(r, data);
+
+    auto check = [&](const skvm::Program& program) {
+        float buf[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18};
+        program.eval(SK_ARRAY_COUNT(buf), buf);
+        for (int i = 0; i < (int)SK_ARRAY_COUNT(buf); i++) {
+            REPORTER_ASSERT(r, buf[i] == (i > 2 ? sqrtf(i) : i*i + 1.0f));
+        }
+    };
+    check(original);
+
+    for (bool allow_jit : {false, true}) {
+        skvm::Program program;
+        REPORTER_ASSERT(r, skvm::Program::Deserialize(data->data(), data->size(), &program,
+                                                      "serialized", allow_jit));
+        REPORTER_ASSERT(r, program.hasJIT() == (allow_jit && original.hasJIT()));
+        REPORTER_ASSERT(r, program.nargs() == original.nargs());
+        check(program);
+
+        // Programs loaded from serialized data serialize the same way again.
+        sk_sp<SkData> again = program.serialize();
+        if (allow_jit) {
+            REPORTER_ASSERT(r, again->equals(data.get()));
+        }
+    }
+
+    // Truncated or corrupted data is rejected.
+    skvm::Program program;
+    for (size_t size : {(size_t)0, (size_t)4, (size_t)16, data->size() - 1}) {
+        REPORTER_ASSERT(r, !skvm::Program::Deserialize(data->data(), size, &program), "%zu", size);
+    }
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+    ((uint8_t*)corrupt->writable_data())[data->size() / 2] ^= 0x40;
+    REPORTER_ASSERT(r, !skvm::Program::Deserialize(corrupt->data(), corrupt->size(), &program));
+    REPORTER_ASSERT(r, program.empty());
+}
+
+DEF_TEST(SkVM_jit_lane_widths, r) {
+    // Where supported the x86 JIT runs 16 lanes at a time using AVX-512, otherwise 8 with AVX2.
+    // Both must agree with the interpreter, in the body loop and in the one-at-a-time tail.
+    skvm::Builder b;
+    {
+        skvm::UPtr uniforms = b.uniform();
+        skvm::Ptr buf32  = b.varying<int>(),
+                  buf16  = b.varying<uint16_t>(),
+                  buf8   = b.varying<uint8_t>(),
+                  buf64  = b.varying<uint64_t>(),
+                  buf128 = b.varying(16);
+
+        skvm::I32 x = b.load32(buf32),
+                  h = b.load16(buf16),
+                  c = b.load8 (buf8);
+        skvm::F32 f = b.to_F32(x) * 0.25f + b.to_F32(h);
+
+        skvm::I32 g = b.gather32(uniforms,0, x & 7)
+                    + b.gather16(uniforms,0, x & 15)
+                    + b.gather8 (uniforms,0, c & 31);
+        skvm::F32 s = select(f > 3.5f, sqrt(f), b.to_F32(g) / (f + 1.0f));
+        s = from_fp16(to_fp16(s)) + floor(s) - ceil(f * 0.3f);
+
+        b.store32(buf32, select(x == h, trunc(s), round(s) << 3) ^ shr(g, 1));
+        b.store16(buf16, (x > c) & sra(g, 2));
+        b.store8 (buf8 , min(s, f) > max(s, 2.0f));
+        b.store64(buf64, b.load64(buf64, 1), b.load64(buf64, 0) - x);
+        b.store128(buf128, b.load128(buf128, 3), b.load128(buf128, 2) * x,
+                           b.load128(buf128, 1), b.load128(buf128, 0) | g);
+    }
+
+    constexpr int N = 37;
+    struct Buffers {
+        int      b32[N];
+        uint16_t b16[N];
+        uint8_t  b8[N];
+        uint64_t b64[N];
+        uint32_t b128[4*N];
+    };
+    const int img[32] = {12,34,56,78, 90,98,76,54, 32,10,98,76, 54,32,10,12,
+                         11,22,33,44, 55,66,77,88, 99,88,77,66, 55,44,33,22};
+    struct Uniforms {
+        const int* img;
+    } uniforms{img};
+
+    auto run = [&](const skvm::Program& program, int n) {
+        Buffers buf;
+        memset(&buf, 0, sizeof(buf));
+        for (int i = 0; i < N; i++) {
+            buf.b32[i] = i*7 - 9;
+            buf.b16[i] = (uint16_t)(i*3);
+            buf.b8 [i] = (uint8_t)(i*5 + 1);
+            buf.b64[i] = (uint64_t)i << 32 | (uint64_t)(i*i);
+            for (int j = 0; j < 4; j++) {
+                buf.b128[4*i+j] = i*4+j;
+            }
+        }
+        program.eval(n, &uniforms, buf.b32, buf.b16, buf.b8, buf.b64, buf.b128);
+        return buf;
+    };
+
+    const skvm::Program interpreter = b.done(/*debug_name=*/nullptr, /*allow_jit=*/false);
+
+    for (bool avx512 : {false, true}) {
+        const skvm::Program program = b.done(/*debug_name=*/nullptr, /*allow_jit=*/true, avx512);
+
+        for (int n : {1, 7, 8, 15, 16, 17, 32, N}) {
+            Buffers want = run(interpreter, n),
+                    got  = run(program, n);
+            REPORTER_ASSERT(r, 0 == memcmp(&want, &got, sizeof(Buffers)), "avx512=%d n=%d",
+                            avx512, n);
+        }
+    }
+}
+
+// Draws an 8x8 rect through an SkVMBlitter that keeps its programs in cache.
+static SkBitmap draw_with_program_cache(SkBlendMode mode, SkVMBlitter::ProgramCache* cache) {
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setColor(0x80ff0000);
+    paint.setBlendMode(mode);
+
+    SkSTArenaAlloc<2048> alloc;
+    SkSimpleMatrixProvider matrices{SkMatrix::I()};
+    if (SkVMBlitter* blitter = SkVMBlitter::Make(bm.pixmap(), paint, matrices, &alloc,
+                                                 /*clipShader=*/nullptr, cache)) {
+        blitter->blitRect(1,1, 8,8);
+    }
+    return bm;
+}
+
+DEF_TEST(SkVM_blitter_program_cache, r) {
+    // A cache of our own, so nothing else drawing concurrently can change what we see.
+    SkVMBlitter::ProgramCache cache(2);
+    REPORTER_ASSERT(r, cache.countLimit() == 2);
+    REPORTER_ASSERT(r, cache.countUsed() == 0);
+
+    draw_with_program_cache(SkBlendMode::kSrcOver, &cache);
+    REPORTER_ASSERT(r, cache.countUsed() == 1);
+    draw_with_program_cache(SkBlendMode::kSrcOver, &cache);
+    REPORTER_ASSERT(r, cache.countUsed() == 1);
+    draw_with_program_cache(SkBlendMode::kMultiply, &cache);
+    REPORTER_ASSERT(r, cache.countUsed() == 2);
+    draw_with_program_cache(SkBlendMode::kScreen, &cache);
+    REPORTER_ASSERT(r, cache.countUsed() == 2);
+
+    REPORTER_ASSERT(r, cache.setCountLimit(1) == 2);
+    REPORTER_ASSERT(r, cache.countUsed() == 1);
+
+    cache.purge();
+    REPORTER_ASSERT(r, cache.countUsed() == 0);
+    draw_with_program_cache(SkBlendMode::kSrcOver, &cache);
+    REPORTER_ASSERT(r, cache.countUsed() == 1);
+}
+
+DEF_TEST(SkVM_blitter_persistent_cache, r) {
+    struct MemoryCache final : public SkGraphics::VMProgramPersistentCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            SkAutoMutexExclusive lock(fMutex);
+            for (const auto& [k, data] : fEntries) {
+                if (k->equals(&key)) {
+                    fLoads++;
+                    return data;
+                }
+            }
+            return nullptr;
+        }
+        void store(const SkData& key, const SkData& data, const SkString&) override {
+            SkAutoMutexExclusive lock(fMutex);
+            fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                                SkData::MakeWithCopy(data.data(), data.size())});
+        }
+
+        int entries() { SkAutoMutexExclusive lock(fMutex); return (int)fEntries.size(); }
+        int loads()   { SkAutoMutexExclusive lock(fMutex); return fLoads; }
+
+        SkMutex fMutex;
+        std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+        int fLoads = 0;
+    };
+    MemoryCache persistent;
+
+    // Each local cache starts empty, so the second draw can only find its program in persistent.
+    SkVMBlitter::ProgramCache compiling, loading;
+    compiling.setPersistentCache(&persistent);
+    loading  .setPersistentCache(&persistent);
+
+    SkBitmap compiled = draw_with_program_cache(SkBlendMode::kColorBurn, &compiling);
+    REPORTER_ASSERT(r, persistent.entries() == 1);
+    REPORTER_ASSERT(r, persistent.loads()   == 0);
+
+    SkBitmap loaded = draw_with_program_cache(SkBlendMode::kColorBurn, &loading);
+    REPORTER_ASSERT(r, persistent.entries() == 1);
+    REPORTER_ASSERT(r, persistent.loads()   == 1);
+    REPORTER_ASSERT(r, loading.countUsed()  == 1);
+    REPORTER_ASSERT(r, 0 == memcmp(compiled.getPixels(), loaded.getPixels(),
+                                   compiled.computeByteSize()));
+}
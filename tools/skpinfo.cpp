@@ -18,6 +18,7 @@ static DEFINE_bool2(version, v, true, "version");
 static DEFINE_bool2(cullRect, c, true, "cullRect");
 static DEFINE_bool2(flags, f, true, "flags");
 static DEFINE_bool2(tags, t, true, "tags");
+static DEFINE_bool2(mappable, m, true, "whether tags can be played back in place");
 static DEFINE_bool2(quiet, q, false, "quiet");
 
 // This tool can print simple information about an SKP but its main use
@@ -31,6 +32,14 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+// SkPicture::MakeFromDataWithoutCopy() leaves a tag's data in place if it is 4-byte aligned
+// (relative to the start of the file), and copies it otherwise.
+static void report_mappable(size_t offset) {
+    if (FLAGS_mappable && !FLAGS_quiet) {
+        SkDebugf("    offset %zu: %s\n", offset, SkIsAlign4(offset) ? "in place" : "copied");
+    }
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::SetUsage("Prints information about an skp file");
     CommandLineFlags::Parse(argc, argv);
@@ -105,6 +114,29 @@ int main(int argc, char** argv) {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_READER_TAG %d\n", chunkSize);
             }
+            report_mappable(curPos);
+            break;
+        case SK_PICT_OP_INDEX_TAG: {
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_OP_INDEX_TAG %d\n", chunkSize);
+            }
+            report_mappable(curPos);
+
+            // The size is the number of ops, each with an offset (plus one more) and bounds.
+            const size_t indexSize = (size_t(chunkSize) + 1) * sizeof(uint32_t) +
+                                     size_t(chunkSize) * sizeof(SkRect);
+            if (curPos + indexSize > totStreamSize) {
+                if (!FLAGS_quiet) {
+                    SkDebugf("truncated file\n");
+                }
+                return kTruncatedFile;
+            }
+            chunkSize = SkToU32(indexSize);
+        } break;
+        case SK_PICT_PAD_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_PAD_TAG %d\n", chunkSize);
+            }
             break;
         case SK_PICT_FACTORY_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
@@ -142,6 +174,7 @@ int main(int argc, char** argv) {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_BUFFER_SIZE_TAG %d\n", chunkSize);
             }
+            report_mappable(curPos);
             break;
         default:
             if (!FLAGS_quiet) {